@@ -0,0 +1,187 @@
+/**
+ * Benchmarks the algorithms of algorithm.hpp on sjtu::vector<long long>
+ * against the standard library ones they stand in for.
+ *
+ * usage: algorithm_bench [--format csv|json] [--max-size N] [--repeat R]
+ *
+ * Every operation is timed R times on random elements for sizes over
+ * powers of ten from 1000 to N (default 10^7), in parallel on the
+ * default thread pool. sort is compared with copying into a std::vector,
+ * std::sort and copying back, which is what sorting an sjtu::vector took
+ * before; the others with the std algorithm on the same buffer. Each row
+ * reports the minimum and median wall time and the speedup of the
+ * minimum.
+ */
+#include "vector.hpp"
+#include "algorithm.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+namespace {
+
+struct Options {
+	bool json = false;
+	size_t max_size = 10000000;
+	int repeat = 5;
+};
+
+struct Result {
+	const char *operation;
+	size_t n;
+	int repeats;
+	double std_min_ns;
+	double min_ns;
+	double median_ns;
+};
+
+std::vector<Result> results;
+
+// Keeps the optimizer from discarding benchmarked work
+volatile long long sink = 0;
+
+// Times body R times, each after an untimed setup
+template<typename Setup, typename Body>
+std::vector<double> Time(int repeat, Setup setup, Body body)
+{
+	std::vector<double> times;
+	for (int r = 0; r < repeat; ++r) {
+		setup();
+		auto start = std::chrono::steady_clock::now();
+		body();
+		auto end = std::chrono::steady_clock::now();
+		times.push_back(std::chrono::duration<double, std::nano>(end - start).count());
+	}
+	std::sort(times.begin(), times.end());
+	return times;
+}
+
+template<typename Setup, typename Std, typename Body>
+void Run(const Options &opt, const char *operation, size_t n, Setup setup, Std baseline, Body body)
+{
+	double std_min = Time(opt.repeat, setup, baseline).front();
+	std::vector<double> times = Time(opt.repeat, setup, body);
+	results.push_back(Result{operation, n, opt.repeat, std_min, times.front(), times[times.size() / 2]});
+}
+
+void BenchSize(const Options &opt, size_t n)
+{
+	std::mt19937_64 gen(n);
+	sjtu::vector<long long> input;
+	for (size_t i = 0; i < n; ++i) {
+		input.push_back(static_cast<long long>(gen()));
+	}
+	sjtu::vector<long long> v;
+	sjtu::vector<long long> scratch;
+	auto reset = [&] {
+		sjtu::parallel_assign(sjtu::par, v, input);
+	};
+	auto keep = [] {};
+
+	Run(opt, "sort", n, reset, [&] {
+		std::vector<long long> copy(v.begin(), v.end());
+		std::sort(copy.begin(), copy.end());
+		std::copy(copy.begin(), copy.end(), v.begin());
+	}, [&] {
+		sjtu::sort(sjtu::par, v);
+	});
+	Run(opt, "radix_sort", n, reset, [&] {
+		std::sort(v.data(), v.data() + v.size());
+	}, [&] {
+		sjtu::radix_sort(sjtu::par, v, scratch);
+	});
+	Run(opt, "stable_sort", n, reset, [&] {
+		std::stable_sort(v.data(), v.data() + v.size());
+	}, [&] {
+		sjtu::stable_sort(sjtu::par, v, scratch);
+	});
+
+	reset();
+	const long long *data = v.data();
+	long long last = v.back();
+	Run(opt, "find", n, keep, [&] {
+		sink = sink + (std::find(data, data + n, last) - data);
+	}, [&] {
+		sink = sink + (sjtu::find(sjtu::par, v, last) - v.begin());
+	});
+	Run(opt, "count", n, keep, [&] {
+		sink = sink + std::count(data, data + n, last);
+	}, [&] {
+		sink = sink + sjtu::count(sjtu::par, v, last);
+	});
+	Run(opt, "min_max", n, keep, [&] {
+		auto range = std::minmax_element(data, data + n);
+		sink = sink + *range.first + *range.second;
+	}, [&] {
+		sjtu::pair<long long, long long> range = sjtu::min_max(sjtu::par, v);
+		sink = sink + range.first + range.second;
+	});
+}
+
+void PrintCsv()
+{
+	std::printf("operation,n,repeats,std_min_ns,min_ns,median_ns,speedup\n");
+	for (const Result &r : results) {
+		std::printf("%s,%zu,%d,%.0f,%.0f,%.0f,%.2f\n", r.operation, r.n, r.repeats, r.std_min_ns, r.min_ns,
+			r.median_ns, r.std_min_ns / r.min_ns);
+	}
+}
+
+void PrintJson()
+{
+	std::printf("[\n");
+	for (size_t i = 0; i < results.size(); ++i) {
+		const Result &r = results[i];
+		std::printf("  {\"operation\": \"%s\", \"n\": %zu, \"repeats\": %d, \"std_min_ns\": %.0f, \"min_ns\": %.0f, "
+			"\"median_ns\": %.0f, \"speedup\": %.2f}%s\n",
+			r.operation, r.n, r.repeats, r.std_min_ns, r.min_ns, r.median_ns, r.std_min_ns / r.min_ns,
+			i + 1 < results.size() ? "," : "");
+	}
+	std::printf("]\n");
+}
+
+bool Parse(int argc, char **argv, Options &opt)
+{
+	for (int i = 1; i < argc; ++i) {
+		const char *arg = argv[i];
+		const char *value = i + 1 < argc ? argv[i + 1] : nullptr;
+		if (std::strcmp(arg, "--format") == 0 && value != nullptr) {
+			opt.json = std::strcmp(value, "json") == 0;
+			++i;
+		} else if (std::strcmp(arg, "--max-size") == 0 && value != nullptr) {
+			opt.max_size = std::strtoull(value, nullptr, 10);
+			++i;
+		} else if (std::strcmp(arg, "--repeat") == 0 && value != nullptr) {
+			opt.repeat = std::max(1, std::atoi(value));
+			++i;
+		} else {
+			std::fprintf(stderr, "usage: %s [--format csv|json] [--max-size N] [--repeat R]\n", argv[0]);
+			return false;
+		}
+	}
+	return true;
+}
+
+}  // namespace
+
+int main(int argc, char **argv)
+{
+	Options opt;
+	if (!Parse(argc, argv, opt)) {
+		return 1;
+	}
+	for (size_t n = 1000; n <= opt.max_size; n *= 10) {
+		BenchSize(opt, n);
+	}
+	if (opt.json) {
+		PrintJson();
+	} else {
+		PrintCsv();
+	}
+	return 0;
+}
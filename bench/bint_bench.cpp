@@ -0,0 +1,182 @@
+/**
+ * Benchmarks Util::Bint multiplication against the schoolbook loop it
+ * replaced.
+ *
+ * usage: bint_bench [--format csv|json] [--max-digits N] [--repeat R]
+ *
+ * Products of two random numbers of equal length are timed R times for
+ * digit counts over powers of four from 16 to N (default 2^20). The old
+ * loop, which carries with % and / on every step, is only run up to
+ * 2^16 digits, where it already takes seconds. Each row reports the
+ * minimum and median wall time and the speedup of the minimum.
+ */
+#include "class-bint.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct Options {
+	bool json = false;
+	size_t max_digits = size_t(1) << 20;
+	int repeat = 5;
+};
+
+struct Result {
+	size_t digits;
+	int repeats;
+	double legacy_min_ns;  // 0 when the old loop was skipped
+	double min_ns;
+	double median_ns;
+};
+
+std::vector<Result> results;
+
+const size_t legacy_limit = size_t(1) << 16;
+
+// Keeps the optimizer from discarding benchmarked work
+volatile int sink = 0;
+
+std::string RandomDigits(std::mt19937 &gen, size_t digits)
+{
+	std::string s(1, static_cast<char>('1' + gen() % 9));
+	for (size_t i = 1; i < digits; ++i) {
+		s += static_cast<char>('0' + gen() % 10);
+	}
+	return s;
+}
+
+// The multiplication loop Bint used before, on base-10000 limbs
+std::vector<int> LegacyMultiply(const std::vector<int> &a, const std::vector<int> &b)
+{
+	std::vector<int> r(a.size() + b.size() + 2, 0);
+	for (size_t i = 0; i < a.size(); ++i) {
+		for (size_t j = 0; j < b.size(); ++j) {
+			long long tmp = r[i + j] + static_cast<long long>(a[i]) * b[j];
+			if (tmp >= 10000) {
+				r[i + j] = tmp % 10000;
+				r[i + j + 1] += static_cast<int>(tmp / 10000);
+			} else {
+				r[i + j] = tmp;
+			}
+		}
+	}
+	return r;
+}
+
+std::vector<int> Limbs(const std::string &s)
+{
+	std::vector<int> limbs;
+	for (size_t end = s.size(); end > 0; end = end >= 4 ? end - 4 : 0) {
+		size_t begin = end >= 4 ? end - 4 : 0;
+		limbs.push_back(std::atoi(s.substr(begin, end - begin).c_str()));
+	}
+	return limbs;
+}
+
+template<typename Body>
+std::vector<double> Time(int repeat, Body body)
+{
+	std::vector<double> times;
+	for (int r = 0; r < repeat; ++r) {
+		auto start = std::chrono::steady_clock::now();
+		body();
+		auto end = std::chrono::steady_clock::now();
+		times.push_back(std::chrono::duration<double, std::nano>(end - start).count());
+	}
+	std::sort(times.begin(), times.end());
+	return times;
+}
+
+void BenchDigits(const Options &opt, size_t digits)
+{
+	std::mt19937 gen(static_cast<unsigned>(digits));
+	std::string x = RandomDigits(gen, digits);
+	std::string y = RandomDigits(gen, digits);
+	Util::Bint a(x);
+	Util::Bint b(y);
+
+	std::vector<double> times = Time(opt.repeat, [&] {
+		Util::Bint c = a * b;
+		sink = sink + (c < a ? 1 : 2);
+	});
+	double legacy = 0;
+	if (digits <= legacy_limit) {
+		std::vector<int> la = Limbs(x);
+		std::vector<int> lb = Limbs(y);
+		legacy = Time(opt.repeat, [&] {
+			sink = sink + LegacyMultiply(la, lb)[0];
+		}).front();
+	}
+	results.push_back(Result{digits, opt.repeat, legacy, times.front(), times[times.size() / 2]});
+}
+
+void PrintCsv()
+{
+	std::printf("digits,repeats,legacy_min_ns,min_ns,median_ns,speedup\n");
+	for (const Result &r : results) {
+		std::printf("%zu,%d,%.0f,%.0f,%.0f,%.2f\n", r.digits, r.repeats, r.legacy_min_ns, r.min_ns,
+			r.median_ns, r.legacy_min_ns / r.min_ns);
+	}
+}
+
+void PrintJson()
+{
+	std::printf("[\n");
+	for (size_t i = 0; i < results.size(); ++i) {
+		const Result &r = results[i];
+		std::printf("  {\"digits\": %zu, \"repeats\": %d, \"legacy_min_ns\": %.0f, \"min_ns\": %.0f, "
+			"\"median_ns\": %.0f, \"speedup\": %.2f}%s\n",
+			r.digits, r.repeats, r.legacy_min_ns, r.min_ns, r.median_ns, r.legacy_min_ns / r.min_ns,
+			i + 1 < results.size() ? "," : "");
+	}
+	std::printf("]\n");
+}
+
+bool Parse(int argc, char **argv, Options &opt)
+{
+	for (int i = 1; i < argc; ++i) {
+		const char *arg = argv[i];
+		const char *value = i + 1 < argc ? argv[i + 1] : nullptr;
+		if (std::strcmp(arg, "--format") == 0 && value != nullptr) {
+			opt.json = std::strcmp(value, "json") == 0;
+			++i;
+		} else if (std::strcmp(arg, "--max-digits") == 0 && value != nullptr) {
+			opt.max_digits = std::strtoull(value, nullptr, 10);
+			++i;
+		} else if (std::strcmp(arg, "--repeat") == 0 && value != nullptr) {
+			opt.repeat = std::max(1, std::atoi(value));
+			++i;
+		} else {
+			std::fprintf(stderr, "usage: %s [--format csv|json] [--max-digits N] [--repeat R]\n", argv[0]);
+			return false;
+		}
+	}
+	return true;
+}
+
+}  // namespace
+
+int main(int argc, char **argv)
+{
+	Options opt;
+	if (!Parse(argc, argv, opt)) {
+		return 1;
+	}
+	for (size_t digits = 16; digits <= opt.max_digits; digits *= 4) {
+		BenchDigits(opt, digits);
+	}
+	if (opt.json) {
+		PrintJson();
+	} else {
+		PrintCsv();
+	}
+	return 0;
+}
@@ -0,0 +1,304 @@
+/**
+ * Micro-benchmarks comparing sjtu::vector with std::vector.
+ *
+ * usage: vector_bench [--format csv|json] [--max-size N] [--repeat R] [--filter TEXT]
+ *
+ * Every (container, element type, operation, size) case is timed R times
+ * and reported with its minimum and median wall time, plus the minimum
+ * divided by the number of elements touched. Sizes run over powers of
+ * four from 1 to 2^24, capped per element type so heavy types stay
+ * within memory. --filter keeps only cases whose name contains TEXT.
+ * Redirect the output (e.g. to bench_output.txt) and diff it between
+ * releases to spot regressions.
+ */
+#include "vector.hpp"
+#include "class-matrix.hpp"
+#include "class-bint.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct Options {
+	bool json = false;
+	size_t max_size = size_t(1) << 24;
+	int repeat = 5;
+	std::string filter;
+};
+
+struct Result {
+	std::string container;
+	std::string type;
+	std::string operation;
+	size_t size;
+	size_t elements;
+	int repeats;
+	double min_ns;
+	double median_ns;
+};
+
+std::vector<Result> results;
+
+// Keeps the optimizer from discarding benchmarked work
+volatile size_t sink = 0;
+
+template<typename T>
+struct Traits;
+
+template<>
+struct Traits<int> {
+	static const char *name() {
+		return "int";
+	}
+	static size_t max_size() {
+		return size_t(1) << 24;
+	}
+	static int make(size_t i) {
+		return static_cast<int>(i);
+	}
+	static size_t touch(const int &x) {
+		return static_cast<size_t>(x);
+	}
+};
+
+template<>
+struct Traits<std::vector<int>> {
+	static const char *name() {
+		return "std::vector<int>";
+	}
+	static size_t max_size() {
+		return size_t(1) << 20;
+	}
+	static std::vector<int> make(size_t i) {
+		return std::vector<int>(4, static_cast<int>(i));
+	}
+	static size_t touch(const std::vector<int> &x) {
+		return x.size() + static_cast<size_t>(x[0]);
+	}
+};
+
+template<>
+struct Traits<Diamond::Matrix<double>> {
+	static const char *name() {
+		return "Diamond::Matrix<double>";
+	}
+	static size_t max_size() {
+		return size_t(1) << 18;
+	}
+	static Diamond::Matrix<double> make(size_t i) {
+		return Diamond::Matrix<double>(4, 4, static_cast<double>(i));
+	}
+	static size_t touch(const Diamond::Matrix<double> &x) {
+		return x.RowSize() + static_cast<size_t>(x[0][0]);
+	}
+};
+
+template<>
+struct Traits<Util::Bint> {
+	static const char *name() {
+		return "Util::Bint";
+	}
+	static size_t max_size() {
+		return size_t(1) << 12;
+	}
+	static Util::Bint make(size_t i) {
+		return Util::Bint(static_cast<long long>(i) * 1000003LL);
+	}
+	static size_t touch(const Util::Bint &x) {
+		return x < Util::Bint(0) ? 1 : 2;
+	}
+};
+
+template<typename Vec>
+struct ContainerName;
+
+template<typename T>
+struct ContainerName<sjtu::vector<T>> {
+	static const char *name() {
+		return "sjtu::vector";
+	}
+};
+
+template<typename T>
+struct ContainerName<std::vector<T>> {
+	static const char *name() {
+		return "std::vector";
+	}
+};
+
+template<typename Vec>
+Vec Filled(size_t n)
+{
+	using T = typename Vec::value_type;
+	Vec v;
+	for (size_t i = 0; i < n; ++i) {
+		v.push_back(Traits<T>::make(i));
+	}
+	return v;
+}
+
+// Runs setup (untimed) and body (timed) repeat times and records the result
+template<typename Vec, typename Setup, typename Body>
+void Run(const Options &opt, const char *operation, size_t n, size_t elements, Setup setup, Body body)
+{
+	using T = typename Vec::value_type;
+	std::string name = std::string(ContainerName<Vec>::name()) + " " + Traits<T>::name() + " " + operation;
+	if (!opt.filter.empty() && name.find(opt.filter) == std::string::npos) {
+		return;
+	}
+	std::vector<double> times;
+	for (int r = 0; r < opt.repeat; ++r) {
+		auto state = setup();
+		auto start = std::chrono::steady_clock::now();
+		body(state);
+		auto end = std::chrono::steady_clock::now();
+		times.push_back(std::chrono::duration<double, std::nano>(end - start).count());
+	}
+	std::sort(times.begin(), times.end());
+	results.push_back(Result{ContainerName<Vec>::name(), Traits<T>::name(), operation, n, elements,
+		opt.repeat, times.front(), times[times.size() / 2]});
+}
+
+template<typename Vec>
+void BenchSize(const Options &opt, size_t n)
+{
+	using T = typename Vec::value_type;
+	// Middle/front inserts and erases shift the whole vector, so only a
+	// bounded number of them is timed per case
+	const size_t k = std::min<size_t>(n, 64);
+	std::vector<T> values;
+	for (size_t i = 0; i < n; ++i) {
+		values.push_back(Traits<T>::make(i));
+	}
+	const Vec base = Filled<Vec>(n);
+
+	Run<Vec>(opt, "push_back", n, n, [] { return Vec(); }, [&](Vec &v) {
+		for (size_t i = 0; i < n; ++i) {
+			v.push_back(values[i]);
+		}
+		sink = sink + v.size();
+	});
+	Run<Vec>(opt, "push_back_reserved", n, n, [] { return Vec(); }, [&](Vec &v) {
+		v.reserve(n);
+		for (size_t i = 0; i < n; ++i) {
+			v.push_back(values[i]);
+		}
+		sink = sink + v.size();
+	});
+	Run<Vec>(opt, "insert_front", n, k, [&] { return Vec(base); }, [&](Vec &v) {
+		for (size_t i = 0; i < k; ++i) {
+			v.insert(v.begin(), values[i]);
+		}
+		sink = sink + v.size();
+	});
+	Run<Vec>(opt, "insert_middle", n, k, [&] { return Vec(base); }, [&](Vec &v) {
+		for (size_t i = 0; i < k; ++i) {
+			v.insert(v.begin() + v.size() / 2, values[i]);
+		}
+		sink = sink + v.size();
+	});
+	Run<Vec>(opt, "erase_front", n, k, [&] { return Vec(base); }, [&](Vec &v) {
+		for (size_t i = 0; i < k; ++i) {
+			v.erase(v.begin());
+		}
+		sink = sink + v.size();
+	});
+	Run<Vec>(opt, "copy", n, n, [] { return 0; }, [&](int &) {
+		Vec copy(base);
+		sink = sink + copy.size();
+	});
+	Run<Vec>(opt, "assign", n, n, [&] { return Vec(base); }, [&](Vec &v) {
+		v = base;
+		sink = sink + v.size();
+	});
+	Run<Vec>(opt, "iterate", n, n, [] { return 0; }, [&](int &) {
+		size_t sum = 0;
+		for (typename Vec::const_iterator it = base.begin(); it != base.end(); ++it) {
+			sum += Traits<T>::touch(*it);
+		}
+		sink = sink + sum;
+	});
+}
+
+template<typename T>
+void BenchType(const Options &opt)
+{
+	size_t limit = std::min(opt.max_size, Traits<T>::max_size());
+	for (size_t n = 1; n <= limit; n *= 4) {
+		BenchSize<sjtu::vector<T>>(opt, n);
+		BenchSize<std::vector<T>>(opt, n);
+	}
+}
+
+void PrintCsv()
+{
+	std::printf("container,type,operation,size,elements,repeats,min_ns,median_ns,ns_per_element\n");
+	for (const Result &r : results) {
+		std::printf("%s,%s,%s,%zu,%zu,%d,%.0f,%.0f,%.3f\n", r.container.c_str(), r.type.c_str(),
+			r.operation.c_str(), r.size, r.elements, r.repeats, r.min_ns, r.median_ns, r.min_ns / r.elements);
+	}
+}
+
+void PrintJson()
+{
+	std::printf("[\n");
+	for (size_t i = 0; i < results.size(); ++i) {
+		const Result &r = results[i];
+		std::printf("  {\"container\": \"%s\", \"type\": \"%s\", \"operation\": \"%s\", \"size\": %zu, "
+			"\"elements\": %zu, \"repeats\": %d, \"min_ns\": %.0f, \"median_ns\": %.0f, \"ns_per_element\": %.3f}%s\n",
+			r.container.c_str(), r.type.c_str(), r.operation.c_str(), r.size, r.elements, r.repeats,
+			r.min_ns, r.median_ns, r.min_ns / r.elements, i + 1 < results.size() ? "," : "");
+	}
+	std::printf("]\n");
+}
+
+bool Parse(int argc, char **argv, Options &opt)
+{
+	for (int i = 1; i < argc; ++i) {
+		const char *arg = argv[i];
+		const char *value = i + 1 < argc ? argv[i + 1] : nullptr;
+		if (std::strcmp(arg, "--format") == 0 && value != nullptr) {
+			opt.json = std::strcmp(value, "json") == 0;
+			++i;
+		} else if (std::strcmp(arg, "--max-size") == 0 && value != nullptr) {
+			opt.max_size = std::strtoull(value, nullptr, 10);
+			++i;
+		} else if (std::strcmp(arg, "--repeat") == 0 && value != nullptr) {
+			opt.repeat = std::max(1, std::atoi(value));
+			++i;
+		} else if (std::strcmp(arg, "--filter") == 0 && value != nullptr) {
+			opt.filter = value;
+			++i;
+		} else {
+			std::fprintf(stderr, "usage: %s [--format csv|json] [--max-size N] [--repeat R] [--filter TEXT]\n", argv[0]);
+			return false;
+		}
+	}
+	return true;
+}
+
+}  // namespace
+
+int main(int argc, char **argv)
+{
+	Options opt;
+	if (!Parse(argc, argv, opt)) {
+		return 1;
+	}
+	BenchType<int>(opt);
+	BenchType<std::vector<int>>(opt);
+	BenchType<Diamond::Matrix<double>>(opt);
+	BenchType<Util::Bint>(opt);
+	if (opt.json) {
+		PrintJson();
+	} else {
+		PrintCsv();
+	}
+	return 0;
+}
@@ -0,0 +1,178 @@
+/**
+ * Replaces the global operator new and delete to measure a workload.
+ *
+ * Linked into a test program next to its code.cpp, it counts every
+ * allocation and tracks the heap bytes live at once. At exit it prints
+ *
+ *     footprint: allocations N peak_bytes P max_rss_kb R
+ *
+ * to stderr, and exits with status 1 if N exceeds SJTU_MAX_ALLOCATIONS
+ * or P exceeds SJTU_MAX_PEAK_BYTES, when those are set in the
+ * environment. Workloads that replace operator new themselves cannot
+ * use it.
+ */
+#include <atomic>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+#include <sys/resource.h>
+
+namespace {
+
+std::atomic<unsigned long long> allocations{0};
+std::atomic<long long> live_bytes{0};
+std::atomic<long long> peak_bytes{0};
+
+// Each block is preceded by a header holding its size; the header is a
+// whole alignment unit so that the block keeps its alignment
+const std::size_t default_header = alignof(std::max_align_t);
+
+void Record(std::size_t size)
+{
+	allocations.fetch_add(1, std::memory_order_relaxed);
+	long long now = live_bytes.fetch_add(static_cast<long long>(size), std::memory_order_relaxed) + size;
+	long long peak = peak_bytes.load(std::memory_order_relaxed);
+	while (now > peak && !peak_bytes.compare_exchange_weak(peak, now, std::memory_order_relaxed)) {
+	}
+}
+
+void *Allocate(std::size_t size, std::size_t align)
+{
+	std::size_t header = align > default_header ? align : default_header;
+	void *base;
+	if (align > default_header) {
+		std::size_t total = (header + size + align - 1) / align * align;
+		base = std::aligned_alloc(align, total);
+	} else {
+		base = std::malloc(header + size);
+	}
+	if (base == nullptr) {
+		return nullptr;
+	}
+	char *p = static_cast<char *>(base) + header;
+	*reinterpret_cast<std::size_t *>(p - sizeof(std::size_t)) = size;
+	Record(size);
+	return p;
+}
+
+void Free(void *p, std::size_t align)
+{
+	if (p == nullptr) {
+		return;
+	}
+	std::size_t header = align > default_header ? align : default_header;
+	char *block = static_cast<char *>(p);
+	std::size_t size = *reinterpret_cast<std::size_t *>(block - sizeof(std::size_t));
+	live_bytes.fetch_sub(static_cast<long long>(size), std::memory_order_relaxed);
+	std::free(block - header);
+}
+
+void *AllocateOrThrow(std::size_t size, std::size_t align)
+{
+	for (;;) {
+		void *p = Allocate(size == 0 ? 1 : size, align);
+		if (p != nullptr) {
+			return p;
+		}
+		std::new_handler handler = std::get_new_handler();
+		if (handler == nullptr) {
+			throw std::bad_alloc();
+		}
+		handler();
+	}
+}
+
+unsigned long long Limit(const char *name)
+{
+	const char *value = std::getenv(name);
+	return value == nullptr ? 0 : std::strtoull(value, nullptr, 10);
+}
+
+// Reports from the destructor of a static, once main() has returned
+struct Reporter {
+	~Reporter()
+	{
+		struct rusage usage;
+		getrusage(RUSAGE_SELF, &usage);
+		unsigned long long count = allocations.load();
+		unsigned long long peak = static_cast<unsigned long long>(peak_bytes.load());
+		std::fprintf(stderr, "footprint: allocations %llu peak_bytes %llu max_rss_kb %ld\n", count, peak,
+			usage.ru_maxrss);
+		unsigned long long max_count = Limit("SJTU_MAX_ALLOCATIONS");
+		unsigned long long max_peak = Limit("SJTU_MAX_PEAK_BYTES");
+		bool over = false;
+		if (max_count != 0 && count > max_count) {
+			std::fprintf(stderr, "footprint: %llu allocations, over the budget of %llu\n", count, max_count);
+			over = true;
+		}
+		if (max_peak != 0 && peak > max_peak) {
+			std::fprintf(stderr, "footprint: peak of %llu bytes, over the budget of %llu\n", peak, max_peak);
+			over = true;
+		}
+		if (over) {
+			std::_Exit(1);
+		}
+	}
+} reporter;
+
+}  // namespace
+
+void *operator new(std::size_t size)
+{
+	return AllocateOrThrow(size, default_header);
+}
+
+void *operator new(std::size_t size, std::align_val_t align)
+{
+	return AllocateOrThrow(size, static_cast<std::size_t>(align));
+}
+
+void *operator new(std::size_t size, const std::nothrow_t &) noexcept
+{
+	try {
+		return AllocateOrThrow(size, default_header);
+	} catch (...) {
+		return nullptr;
+	}
+}
+
+void *operator new(std::size_t size, std::align_val_t align, const std::nothrow_t &) noexcept
+{
+	try {
+		return AllocateOrThrow(size, static_cast<std::size_t>(align));
+	} catch (...) {
+		return nullptr;
+	}
+}
+
+void operator delete(void *p) noexcept
+{
+	Free(p, default_header);
+}
+
+void operator delete(void *p, std::size_t) noexcept
+{
+	Free(p, default_header);
+}
+
+void operator delete(void *p, std::align_val_t align) noexcept
+{
+	Free(p, static_cast<std::size_t>(align));
+}
+
+void operator delete(void *p, std::size_t, std::align_val_t align) noexcept
+{
+	Free(p, static_cast<std::size_t>(align));
+}
+
+void operator delete(void *p, const std::nothrow_t &) noexcept
+{
+	Free(p, default_header);
+}
+
+void operator delete(void *p, std::align_val_t align, const std::nothrow_t &) noexcept
+{
+	Free(p, static_cast<std::size_t>(align));
+}
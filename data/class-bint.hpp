@@ -1,13 +1,28 @@
+#include <charconv>
 #include <cstdlib>
 #include <cstring>
 #include <iostream>
 #include <stdexcept>
 #include <string>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
+#include "vector.hpp"
+
 namespace Util {
 
-const size_t MIN_CAPACITY = 2048;
+// Limbs held inside the object itself; longer values go to the heap
+const size_t INLINE_CAPACITY = 4;
+
+// operator* picks its algorithm by the shorter operand's limb count:
+// schoolbook below KARATSUBA_THRESHOLD, NTT from NTT_THRESHOLD on, and
+// Karatsuba in between or when the product is too long for the NTT
+const size_t KARATSUBA_THRESHOLD = 48;
+const size_t NTT_THRESHOLD = 1536;
+const size_t NTT_MAX_LENGTH = size_t(1) << 23;
 
 class Bint {
     class NewSpaceFailed : public std::runtime_error {
@@ -18,19 +33,60 @@ class Bint {
        public:
         BadCast();
     };
+    // Limbs in base 10000, least significant first. Those past length,
+    // up to capacity, are kept zero.
+    union Storage {
+        int *heap;
+        int local[INLINE_CAPACITY];
+    };
     bool isMinus = false;
     size_t length;
-    int *data = nullptr;
-    size_t capacity = MIN_CAPACITY;
-    void _DoubleSpace();
+    size_t capacity = INLINE_CAPACITY;
+    Storage store;
+    int *_Limbs() {
+        return capacity > INLINE_CAPACITY ? store.heap : store.local;
+    }
+    const int *_Limbs() const {
+        return capacity > INLINE_CAPACITY ? store.heap : store.local;
+    }
+    // Limb i, or 0 past the most significant one
+    int _Limb(const size_t &i) const {
+        return i < length ? _Limbs()[i] : 0;
+    }
+    void _Reserve(const size_t &len);
+    void _Release();
     void _SafeNewSpace(int *&p, const size_t &len);
+    void _Assign(long long x);
+    void _Parse(std::string_view x);
     explicit Bint(const size_t &capa);
+    // Drop leading zero limbs; zero is never minus
+    void _Trim();
+    void _AddAbs(const Bint &b);
+    void _SubAbs(const Bint &b);
+    void _SubFromAbs(const Bint &b);
+    void _AddSigned(const Bint &b, bool bMinus);
+    // Three-way comparisons, of magnitudes and of values, without copies
+    static int _CompareAbs(const Bint &lhs, const Bint &rhs);
+    static int _Compare(const Bint &lhs, const Bint &rhs);
+
+    // Each multiplier writes the n + m limbs of a * b, carried, to r
+    static void _Multiply(const int *a, size_t n, const int *b, size_t m, int *r);
+    static void _MulSchool(const int *a, size_t n, const int *b, size_t m, int *r);
+    static void _MulKaratsuba(const int *a, size_t n, const int *b, size_t m, int *r);
+    static void _MulNtt(const int *a, size_t n, const int *b, size_t m, int *r);
+    static void _KaratsubaPoly(const unsigned long long *a, const unsigned long long *b, size_t n, unsigned long long *r);
+    template <unsigned int Mod>
+    static void _Ntt(std::vector<unsigned int> &a, bool invert);
+    template <unsigned int Mod>
+    static std::vector<unsigned int> _Convolve(const int *a, size_t n, const int *b, size_t m, size_t size);
 
    public:
     Bint();
     Bint(int x);
     Bint(long long x);
-    Bint(std::string x);
+    Bint(std::string_view x);
+    Bint(const std::string &x);
+    Bint(const char *x);
     Bint(const Bint &b);
     Bint(Bint &&b) noexcept;
 
@@ -49,11 +105,34 @@ class Bint {
     friend bool operator<=(const Bint &lhs, const Bint &rhs);
     friend bool operator>=(const Bint &lhs, const Bint &rhs);
 
+    // In place, reusing the buffer; these only allocate when it grows
+    Bint &operator+=(const Bint &rhs);
+    Bint &operator-=(const Bint &rhs);
+    Bint &operator*=(const Bint &rhs);
+    Bint &operator*=(long long rhs);
+
+    // The rvalue overloads work in the storage of the operand they take
     friend Bint operator+(const Bint &lhs, const Bint &rhs);
+    friend Bint operator+(Bint &&lhs, const Bint &rhs);
+    friend Bint operator+(const Bint &lhs, Bint &&rhs);
+    friend Bint operator+(Bint &&lhs, Bint &&rhs);
     friend Bint operator-(const Bint &b);
     friend Bint operator-(Bint &&b);
     friend Bint operator-(const Bint &lhs, const Bint &rhs);
+    friend Bint operator-(Bint &&lhs, const Bint &rhs);
+    friend Bint operator-(const Bint &lhs, Bint &&rhs);
+    friend Bint operator-(Bint &&lhs, Bint &&rhs);
     friend Bint operator*(const Bint &lhs, const Bint &rhs);
+    friend Bint operator*(Bint &&lhs, const Bint &rhs);
+    friend Bint operator*(const Bint &lhs, Bint &&rhs);
+    friend Bint operator*(Bint &&lhs, Bint &&rhs);
+
+    // Characters printed by operator<<, the sign included
+    size_t TextLength() const;
+    // Writes the decimal text to [first, last) without a terminator, as
+    // std::to_chars does; value_too_large if TextLength() does not fit
+    std::to_chars_result ToChars(char *first, char *last) const;
+    std::string ToString() const;
 
     friend std::istream &operator>>(std::istream &is, Bint &b);
     friend std::ostream &operator<<(std::ostream &os, const Bint &b);
@@ -63,7 +142,6 @@ class Bint {
 }  // namespace Util
 
 #include <algorithm>
-#include <iomanip>
 
 namespace Util {
 
@@ -75,192 +153,263 @@ Bint::BadCast::BadCast()
 }
 
 void Bint::_SafeNewSpace(int *&p, const size_t &len) {
-    if (p != nullptr) {
-        delete[] p;
-        p = nullptr;
-    }
     p = new int[len];
     if (p == nullptr) {
         throw NewSpaceFailed();
     }
-    memset(p, 0, len * sizeof(unsigned int));
+    memset(p, 0, len * sizeof(int));
 }
 
-void Bint::_DoubleSpace() {
+// Grow to hold at least len limbs, at least doubling so that repeated
+// growth stays linear; only the length limbs in use are copied
+void Bint::_Reserve(const size_t &len) {
+    if (len <= capacity) {
+        return;
+    }
+    size_t newCapacity = std::max(capacity << 1, len);
     int *newMem = nullptr;
-    _SafeNewSpace(newMem, capacity << 1);
-    memcpy(newMem, data, capacity * sizeof(int));
-    delete[] data;
-    data = newMem;
-    capacity <<= 1;
+    _SafeNewSpace(newMem, newCapacity);
+    memcpy(newMem, _Limbs(), length * sizeof(int));
+    _Release();
+    store.heap = newMem;
+    capacity = newCapacity;
 }
 
-Bint::Bint() : length(1) {
-    _SafeNewSpace(data, capacity);
+// Free a heap buffer and fall back to zeroed inline storage
+void Bint::_Release() {
+    if (capacity > INLINE_CAPACITY) {
+        delete[] store.heap;
+    }
+    capacity = INLINE_CAPACITY;
+    memset(store.local, 0, sizeof(store.local));
 }
 
-Bint::Bint(int x) : length(0) {
-    _SafeNewSpace(data, capacity);
-    if (x < 0) {
-        isMinus = true;
-        x = -x;
-    }
-    while (x) {
-        data[length++] = x % 10000;
-        x /= 10000;
+void Bint::_Assign(long long x) {
+    memset(_Limbs(), 0, length * sizeof(int));
+    isMinus = x < 0;
+    unsigned long long u = isMinus ? 0ULL - static_cast<unsigned long long>(x)
+                                   : static_cast<unsigned long long>(x);
+    // Count the limbs first: anything below 10^16 stays inline
+    size_t limbs = 1;
+    for (unsigned long long rest = u / 10000; rest; rest /= 10000) {
+        ++limbs;
+    }
+    _Reserve(limbs);
+    int *d = _Limbs();
+    length = 0;
+    while (u) {
+        d[length++] = static_cast<int>(u % 10000);
+        u /= 10000;
     }
     if (!length) {
         length = 1;
     }
 }
 
-Bint::Bint(long long x) : length(0) {
-    _SafeNewSpace(data, capacity);
-    if (x < 0) {
-        isMinus = true;
-        x = -x;
-    }
-    while (x) {
-        data[length++] = static_cast<unsigned int>(x % 10000);
-        x /= 10000;
-    }
-    if (!length) {
-        length = 1;
-    }
+Bint::Bint() : length(1) {
+    memset(store.local, 0, sizeof(store.local));
 }
 
-Bint::Bint(const size_t &capa) : length(1) {
-    while (capacity < capa) {
-        capacity <<= 1;
-    }
-    _SafeNewSpace(data, capacity);
+Bint::Bint(int x) : Bint() {
+    _Assign(x);
 }
 
-Bint::Bint(std::string x) {
-    while (x[0] == '-') {
-        isMinus = !isMinus;
-        x.erase(0, 1);
+Bint::Bint(long long x) : Bint() {
+    _Assign(x);
+}
+
+Bint::Bint(const size_t &capa) : Bint() {
+    _Reserve(capa);
+}
+
+// Any number of leading '-' each flip the sign, the rest must be digits;
+// they are all checked first, so a bad string leaves *this unchanged
+void Bint::_Parse(std::string_view x) {
+    bool minus = false;
+    size_t start = 0;
+    while (start < x.size() && x[start] == '-') {
+        minus = !minus;
+        ++start;
+    }
+    for (size_t i = start; i < x.size(); ++i) {
+        if (x[i] > '9' || x[i] < '0') {
+            throw BadCast();
+        }
     }
-    while ((capacity << 2) <= x.length()) {
-        capacity <<= 1;
+    while (start < x.size() && x[start] == '0') {
+        ++start;
     }
 
-    _SafeNewSpace(data, capacity);
+    size_t digits = x.size() - start;
+    size_t limbs = digits > 0 ? (digits + 3) >> 2 : 1;
+    memset(_Limbs(), 0, length * sizeof(int));
+    length = 1;
+    _Reserve(limbs);
+    int *d = _Limbs();
 
-    size_t mid = x.length() >> 1;
-    for (size_t i = 0; i < mid; ++i) {
-        std::swap(x[i], x[x.length() - 1 - i]);
+    // Whole limbs from the least significant end, four digits a step
+    const char *p = x.data() + x.size();
+    for (size_t i = 0; i < (digits >> 2); ++i) {
+        p -= 4;
+        d[i] = (p[0] - '0') * 1000 + (p[1] - '0') * 100 + (p[2] - '0') * 10 + (p[3] - '0');
     }
-
-    const static unsigned int pow10[4] = {1, 10, 100, 1000};
-    for (size_t i = 0; i < capacity; ++i) {
-        if ((i << 2) >= x.length()) {
-            length = i;
-            break;
-        }
-        for (size_t j = 0; j < 4; ++j) {
-            if ((i << 2) + j >= x.length()) {
-                break;
-            }
-            if (x[(i << 2) + j] > '9' || x[(i << 2) + j] < '0') {
-                throw BadCast();
-            }
-            data[i] = data[i] + (x[(i << 2) + j] - '0') * pow10[j];
-        }
+    int top = 0;
+    for (const char *q = x.data() + start; q < p; ++q) {
+        top = top * 10 + (*q - '0');
     }
+    if (digits & 3) {
+        d[limbs - 1] = top;
+    }
+    length = limbs;
+    isMinus = minus;
+    _Trim();
+}
+
+Bint::Bint(std::string_view x) : Bint() {
+    _Parse(x);
 }
 
-Bint::Bint(const Bint &b)
-    : isMinus(b.isMinus), length(b.length), capacity(b.capacity) {
-    _SafeNewSpace(data, capacity);
-    memcpy(data, b.data, sizeof(unsigned int) * capacity);
+Bint::Bint(const std::string &x) : Bint(std::string_view(x)) {
 }
 
+Bint::Bint(const char *x) : Bint(std::string_view(x)) {
+}
+
+Bint::Bint(const Bint &b) : Bint(b.length) {
+    isMinus = b.isMinus;
+    length = b.length;
+    memcpy(_Limbs(), b._Limbs(), sizeof(int) * length);
+}
+
+// Leaves b zero, in its inline storage
 Bint::Bint(Bint &&b) noexcept
-    : isMinus(b.isMinus), length(b.length), capacity(b.capacity) {
-    data = b.data;
-    b.data = nullptr;
+    : isMinus(b.isMinus), length(b.length), capacity(b.capacity), store(b.store) {
+    b.capacity = INLINE_CAPACITY;
+    memset(b.store.local, 0, sizeof(b.store.local));
+    b.length = 1;
+    b.isMinus = false;
 }
 
 Bint &Bint::operator=(int x) {
-    memset(data, 0, sizeof(unsigned int) * capacity);
-    length = 0;
-    if (x < 0) {
-        isMinus = true;
-        x = -x;
-    }
-    while (x) {
-        data[length++] = x % 10000;
-        x /= 10000;
-    }
-    if (!length) {
-        length = 1;
-    }
+    _Assign(x);
     return *this;
 }
 
 Bint &Bint::operator=(long long x) {
-    memset(data, 0, sizeof(unsigned int) * capacity);
-    length = 0;
-    if (x < 0) {
-        isMinus = true;
-        x = -x;
-    }
-    while (x) {
-        data[length++] = static_cast<unsigned int>(x % 10000);
-        x /= 10000;
-    }
-    if (!length) {
-        length = 1;
-    }
+    _Assign(x);
     return *this;
 }
 
+// Reuses the buffer when rhs fits; the copy is proportional to the lengths
 Bint &Bint::operator=(const Bint &rhs) {
     if (this == &rhs) {
         return *this;
     }
-    if (rhs.capacity > capacity) {
-        capacity = rhs.capacity;
-        _SafeNewSpace(data, capacity);
+    if (rhs.length > capacity) {
+        int *newMem = nullptr;
+        _SafeNewSpace(newMem, rhs.length);
+        _Release();
+        store.heap = newMem;
+        capacity = rhs.length;
+    } else if (length > rhs.length) {
+        memset(_Limbs() + rhs.length, 0, sizeof(int) * (length - rhs.length));
     }
-    memcpy(data, rhs.data, sizeof(unsigned int) * rhs.capacity);
+    memcpy(_Limbs(), rhs._Limbs(), sizeof(int) * rhs.length);
     length = rhs.length;
     isMinus = rhs.isMinus;
     return *this;
 }
 
+// Takes rhs's buffer and leaves rhs zero in the old one, so that it can
+// be reused or freed
 Bint &Bint::operator=(Bint &&rhs) noexcept {
     if (this == &rhs) {
         return *this;
     }
-    capacity = rhs.capacity;
-    length = rhs.length;
+    std::swap(capacity, rhs.capacity);
+    std::swap(store, rhs.store);
+    std::swap(length, rhs.length);
     isMinus = rhs.isMinus;
-    data = rhs.data;
-    rhs.data = nullptr;
+    memset(rhs._Limbs(), 0, rhs.length * sizeof(int));
+    rhs.length = 1;
+    rhs.isMinus = false;
     return *this;
 }
 
+// Parses into b's own buffer, so reading many values reuses both it and
+// the text buffer
 std::istream &operator>>(std::istream &is, Bint &b) {
-    std::string s;
-    is >> s;
-    b = Bint(s);
+    static thread_local std::string s;
+    if (is >> s) {
+        b._Parse(s);
+    }
     return is;
 }
 
+size_t Bint::TextLength() const {
+    int top = _Limbs()[length - 1];
+    size_t topDigits = top >= 1000 ? 4 : top >= 100 ? 3 : top >= 10 ? 2 : 1;
+    return (isMinus ? 1 : 0) + topDigits + 4 * (length - 1);
+}
+
+std::to_chars_result Bint::ToChars(char *first, char *last) const {
+    size_t n = TextLength();
+    if (static_cast<size_t>(last - first) < n) {
+        return {last, std::errc::value_too_large};
+    }
+    static const char pairs[] =
+        "0001020304050607080910111213141516171819"
+        "2021222324252627282930313233343536373839"
+        "4041424344454647484950515253545556575859"
+        "6061626364656667686970717273747576777879"
+        "8081828384858687888990919293949596979899";
+    const int *d = _Limbs();
+    char *p = first;
+    if (isMinus) {
+        *p++ = '-';
+    }
+    p = std::to_chars(p, last, d[length - 1]).ptr;
+    // The other limbs are exactly four digits, two per table lookup
+    for (size_t i = length - 1; i-- > 0;) {
+        int hi = d[i] / 100;
+        int lo = d[i] % 100;
+        memcpy(p, pairs + 2 * hi, 2);
+        memcpy(p + 2, pairs + 2 * lo, 2);
+        p += 4;
+    }
+    return {p, std::errc()};
+}
+
+std::string Bint::ToString() const {
+    std::string s(TextLength(), '\0');
+    ToChars(&s[0], &s[0] + s.size());
+    return s;
+}
+
+// Honours the stream's width and fill like other formatted output
 std::ostream &operator<<(std::ostream &os, const Bint &b) {
-    if (b.data == nullptr) {
-        return os;
+    char local[64];
+    size_t n = b.TextLength();
+    if (n <= sizeof(local)) {
+        b.ToChars(local, local + n);
+        return os << std::string_view(local, n);
     }
-    if (b.isMinus && (b.length > 1 || b.data[0] != 0)) {
-        os << "-";
+    return os << b.ToString();
+}
+
+// Writes every element of v followed by separator in a single write to
+// os, laying out the text of all of them in one buffer first
+std::ostream &WriteAll(std::ostream &os, const sjtu::vector<Bint> &v, char separator = '\n') {
+    size_t total = 0;
+    for (size_t i = 0; i < v.size(); ++i) {
+        total += v[i].TextLength() + 1;
     }
-    os << b.data[b.length - 1];
-    for (long long i = b.length - 2LL; i >= 0; --i) {
-        os << std::setw(4) << std::setfill('0') << b.data[i];
+    std::string buffer(total, separator);
+    char *p = &buffer[0];
+    for (size_t i = 0; i < v.size(); ++i) {
+        p = v[i].ToChars(p, &buffer[0] + total).ptr + 1;
     }
-    return os;
+    return os.write(buffer.data(), buffer.size());
 }
 
 Bint abs(const Bint &b) {
@@ -271,218 +420,475 @@ Bint abs(const Bint &b) {
 
 Bint abs(Bint &&b) {
     b.isMinus = false;
-    return b;
+    return std::move(b);
 }
 
-bool operator==(const Bint &lhs, const Bint &rhs) {
-    if (lhs.isMinus != rhs.isMinus) {
-        return false;
-    }
+int Bint::_CompareAbs(const Bint &lhs, const Bint &rhs) {
     if (lhs.length != rhs.length) {
-        return false;
+        return lhs.length < rhs.length ? -1 : 1;
     }
-    for (size_t i = 0; i < lhs.length; ++i) {
-        if (lhs.data[i] != rhs.data[i]) {
-            return false;
+    const int *a = lhs._Limbs();
+    const int *b = rhs._Limbs();
+    for (size_t i = lhs.length; i-- > 0;) {
+        if (a[i] != b[i]) {
+            return a[i] < b[i] ? -1 : 1;
         }
     }
-    return true;
+    return 0;
 }
 
-bool operator!=(const Bint &lhs, const Bint &rhs) {
+// Zero is never minus, so the signs alone order values of differing sign
+int Bint::_Compare(const Bint &lhs, const Bint &rhs) {
     if (lhs.isMinus != rhs.isMinus) {
-        return true;
+        return lhs.isMinus ? -1 : 1;
     }
-    if (lhs.length != rhs.length) {
-        return true;
+    int c = _CompareAbs(lhs, rhs);
+    return lhs.isMinus ? -c : c;
+}
+
+bool operator==(const Bint &lhs, const Bint &rhs) {
+    return Bint::_Compare(lhs, rhs) == 0;
+}
+
+bool operator!=(const Bint &lhs, const Bint &rhs) {
+    return Bint::_Compare(lhs, rhs) != 0;
+}
+
+bool operator<(const Bint &lhs, const Bint &rhs) {
+    return Bint::_Compare(lhs, rhs) < 0;
+}
+
+bool operator>(const Bint &lhs, const Bint &rhs) {
+    return Bint::_Compare(lhs, rhs) > 0;
+}
+
+bool operator<=(const Bint &lhs, const Bint &rhs) {
+    return Bint::_Compare(lhs, rhs) <= 0;
+}
+
+bool operator>=(const Bint &lhs, const Bint &rhs) {
+    return Bint::_Compare(lhs, rhs) >= 0;
+}
+
+void Bint::_Trim() {
+    const int *d = _Limbs();
+    while (length > 1 && d[length - 1] == 0) {
+        --length;
     }
-    for (size_t i = 0; i < lhs.length; ++i) {
-        if (lhs.data[i] != rhs.data[i]) {
-            return true;
-        }
+    if (length == 1 && d[0] == 0) {
+        isMinus = false;
     }
-    return false;
 }
 
-bool operator<(const Bint &lhs, const Bint &rhs) {
-    if (lhs.isMinus != rhs.isMinus) {
-        return !lhs.isMinus;
+// |*this| += |b|; b may be *this, every limb is read before it is written
+void Bint::_AddAbs(const Bint &b) {
+    size_t n = std::max(length, b.length);
+    _Reserve(n + 1);
+    int *d = _Limbs();
+    const int *e = b._Limbs();
+    int carry = 0;
+    size_t i = 0;
+    for (; i < b.length; ++i) {
+        int sum = d[i] + e[i] + carry;
+        carry = sum >= 10000;
+        d[i] = carry ? sum - 10000 : sum;
+    }
+    for (; carry && i < n; ++i) {
+        int sum = d[i] + carry;
+        carry = sum >= 10000;
+        d[i] = carry ? sum - 10000 : sum;
+    }
+    if (carry) {
+        d[n] = 1;
+        length = n + 1;
+    } else {
+        length = n;
     }
-    if (lhs.isMinus) {
-        if (lhs.length != rhs.length) {
-            return lhs.length > rhs.length;
-        }
-        for (long long i = lhs.length - 1; i >= 0; --i) {
-            if (lhs.data[i] != rhs.data[i]) {
-                return lhs.data[i] > rhs.data[i];
-            }
-        }
-        return false;
+}
+
+// |*this| -= |b|, which needs |*this| >= |b|
+void Bint::_SubAbs(const Bint &b) {
+    int *d = _Limbs();
+    const int *e = b._Limbs();
+    int borrow = 0;
+    size_t i = 0;
+    for (; i < b.length; ++i) {
+        int diff = d[i] - e[i] - borrow;
+        borrow = diff < 0;
+        d[i] = borrow ? diff + 10000 : diff;
+    }
+    for (; borrow && i < length; ++i) {
+        int diff = d[i] - borrow;
+        borrow = diff < 0;
+        d[i] = borrow ? diff + 10000 : diff;
+    }
+    _Trim();
+}
+
+// |*this| = |b| - |*this|, which needs |*this| < |b|
+void Bint::_SubFromAbs(const Bint &b) {
+    _Reserve(b.length);
+    int *d = _Limbs();
+    const int *e = b._Limbs();
+    int borrow = 0;
+    for (size_t i = 0; i < b.length; ++i) {
+        int diff = e[i] - d[i] - borrow;
+        borrow = diff < 0;
+        d[i] = borrow ? diff + 10000 : diff;
+    }
+    length = b.length;
+    _Trim();
+}
+
+// *this += b, with b taken as minus when bMinus
+void Bint::_AddSigned(const Bint &b, bool bMinus) {
+    if (isMinus == bMinus) {
+        _AddAbs(b);
+    } else if (_CompareAbs(*this, b) >= 0) {
+        _SubAbs(b);
     } else {
-        if (lhs.length != rhs.length) {
-            return lhs.length < rhs.length;
-        }
-        for (long long i = lhs.length - 1; i >= 0; --i) {
-            if (lhs.data[i] != rhs.data[i]) {
-                return lhs.data[i] < rhs.data[i];
-            }
-        }
-        return false;
+        _SubFromAbs(b);
+        isMinus = bMinus;
     }
 }
 
-bool operator>(const Bint &lhs, const Bint &rhs) {
-    return rhs < lhs;
+Bint &Bint::operator+=(const Bint &rhs) {
+    _AddSigned(rhs, rhs.isMinus);
+    return *this;
 }
 
-bool operator<=(const Bint &lhs, const Bint &rhs) {
-    if (lhs.isMinus != rhs.isMinus) {
-        return !lhs.isMinus;
+Bint &Bint::operator-=(const Bint &rhs) {
+    if (this == &rhs) {
+        return *this = 0;
     }
-    if (lhs.isMinus) {
-        if (lhs.length != rhs.length) {
-            return lhs.length > rhs.length;
-        }
-        for (long long i = lhs.length - 1; i >= 0; --i) {
-            if (lhs.data[i] != rhs.data[i]) {
-                return lhs.data[i] > rhs.data[i];
-            }
-        }
-        return true;
-    } else {
-        if (lhs.length != rhs.length) {
-            return lhs.length < rhs.length;
-        }
-        for (long long i = lhs.length - 1; i >= 0; --i) {
-            if (lhs.data[i] != rhs.data[i]) {
-                return lhs.data[i] < rhs.data[i];
-            }
-        }
-        return true;
+    _AddSigned(rhs, !rhs.isMinus);
+    return *this;
+}
+
+// The product is built in a per-thread scratch buffer and copied back,
+// so neither side allocates once both buffers are large enough
+Bint &Bint::operator*=(const Bint &rhs) {
+    static thread_local std::vector<int> scratch;
+    size_t n = length + rhs.length;
+    if (scratch.size() < n) {
+        scratch.resize(n);
+    }
+    _Multiply(_Limbs(), length, rhs._Limbs(), rhs.length, scratch.data());
+    _Reserve(n);
+    memcpy(_Limbs(), scratch.data(), n * sizeof(int));
+    length = n;
+    isMinus = isMinus != rhs.isMinus;
+    _Trim();
+    return *this;
+}
+
+Bint &Bint::operator*=(long long rhs) {
+    // Past 2^31 a limb times rhs may not fit in 64 bits
+    if (rhs <= -(1LL << 31) || rhs >= (1LL << 31)) {
+        return *this *= Bint(rhs);
     }
+    if (rhs < 0) {
+        isMinus = !isMinus;
+        rhs = -rhs;
+    }
+    // rhs < 10^12 adds at most three limbs
+    _Reserve(length + 3);
+    int *d = _Limbs();
+    unsigned long long m = static_cast<unsigned long long>(rhs);
+    unsigned long long carry = 0;
+    for (size_t i = 0; i < length; ++i) {
+        unsigned long long cur = d[i] * m + carry;
+        d[i] = static_cast<int>(cur % 10000);
+        carry = cur / 10000;
+    }
+    while (carry) {
+        d[length++] = static_cast<int>(carry % 10000);
+        carry /= 10000;
+    }
+    _Trim();
+    return *this;
 }
 
-bool operator>=(const Bint &lhs, const Bint &rhs) {
-    if (lhs.isMinus != rhs.isMinus) {
-        return lhs.isMinus;
+// The sum is sized for the carry up front, so it allocates once at most
+Bint operator+(const Bint &lhs, const Bint &rhs) {
+    Bint result(std::max(lhs.length, rhs.length) + 1);
+    result = lhs;
+    result += rhs;
+    return result;
+}
+
+Bint operator+(Bint &&lhs, const Bint &rhs) {
+    lhs += rhs;
+    return std::move(lhs);
+}
+
+Bint operator+(const Bint &lhs, Bint &&rhs) {
+    rhs += lhs;
+    return std::move(rhs);
+}
+
+Bint operator+(Bint &&lhs, Bint &&rhs) {
+    lhs += rhs;
+    return std::move(lhs);
+}
+
+Bint operator-(const Bint &b) {
+    Bint result(b);
+    return -std::move(result);
+}
+
+Bint operator-(Bint &&b) {
+    if (b.length > 1 || b._Limbs()[0] != 0) {
+        b.isMinus = !b.isMinus;
     }
-    if (lhs.isMinus) {
-        if (lhs.length != rhs.length) {
-            return lhs.length < rhs.length;
+    return std::move(b);
+}
+
+Bint operator-(const Bint &lhs, const Bint &rhs) {
+    Bint result(std::max(lhs.length, rhs.length) + 1);
+    result = lhs;
+    result -= rhs;
+    return result;
+}
+
+Bint operator-(Bint &&lhs, const Bint &rhs) {
+    lhs -= rhs;
+    return std::move(lhs);
+}
+
+// lhs - rhs = -(rhs - lhs)
+Bint operator-(const Bint &lhs, Bint &&rhs) {
+    rhs -= lhs;
+    return -std::move(rhs);
+}
+
+Bint operator-(Bint &&lhs, Bint &&rhs) {
+    lhs -= rhs;
+    return std::move(lhs);
+}
+
+// Column by column, each column summed in 64 bits and carried once
+void Bint::_MulSchool(const int *a, size_t n, const int *b, size_t m, int *r) {
+    unsigned long long carry = 0;
+    for (size_t k = 0; k + 1 < n + m; ++k) {
+        unsigned long long sum = carry;
+        size_t lo = k >= m ? k - m + 1 : 0;
+        size_t hi = k < n ? k : n - 1;
+        for (size_t i = lo; i <= hi; ++i) {
+            sum += static_cast<unsigned long long>(a[i]) * b[k - i];
         }
-        for (long long i = lhs.length - 1; i >= 0; --i) {
-            if (lhs.data[i] != rhs.data[i]) {
-                return lhs.data[i] < rhs.data[i];
+        r[k] = static_cast<int>(sum % 10000);
+        carry = sum / 10000;
+    }
+    r[n + m - 1] = static_cast<int>(carry);
+}
+
+// r[0, 2n) = a * b as polynomials of n coefficients, nothing carried.
+// Intermediate sums may wrap around, but the arithmetic is then exact
+// modulo 2^64 and the final coefficients, at most n * 10^8, fit.
+void Bint::_KaratsubaPoly(const unsigned long long *a, const unsigned long long *b, size_t n, unsigned long long *r) {
+    if (n <= KARATSUBA_THRESHOLD) {
+        std::fill(r, r + 2 * n, 0ULL);
+        for (size_t i = 0; i < n; ++i) {
+            for (size_t j = 0; j < n; ++j) {
+                r[i + j] += a[i] * b[j];
             }
         }
-        return true;
-    } else {
-        if (lhs.length != rhs.length) {
-            return lhs.length > rhs.length;
+        return;
+    }
+    size_t h = n >> 1;
+    size_t t = n - h;
+    // Low halves into r[0, 2h), high halves into r[2h, 2n)
+    _KaratsubaPoly(a, b, h, r);
+    _KaratsubaPoly(a + h, b + h, t, r + 2 * h);
+
+    std::vector<unsigned long long> sums(2 * t);
+    std::vector<unsigned long long> mid(2 * t);
+    for (size_t i = 0; i < t; ++i) {
+        sums[i] = a[h + i] + (i < h ? a[i] : 0);
+        sums[t + i] = b[h + i] + (i < h ? b[i] : 0);
+    }
+    _KaratsubaPoly(sums.data(), sums.data() + t, t, mid.data());
+    for (size_t i = 0; i < 2 * h; ++i) {
+        mid[i] -= r[i];
+    }
+    for (size_t i = 0; i < 2 * t; ++i) {
+        mid[i] -= r[2 * h + i];
+    }
+    for (size_t i = 0; i < 2 * t; ++i) {
+        r[h + i] += mid[i];
+    }
+}
+
+// The longer operand is cut into pieces as long as the shorter one
+void Bint::_MulKaratsuba(const int *a, size_t n, const int *b, size_t m, int *r) {
+    if (n > m) {
+        std::swap(a, b);
+        std::swap(n, m);
+    }
+    std::vector<unsigned long long> x(a, a + n);
+    std::vector<unsigned long long> y(n);
+    std::vector<unsigned long long> piece(2 * n);
+    std::vector<unsigned long long> acc(n + m + n, 0ULL);
+    for (size_t off = 0; off < m; off += n) {
+        size_t len = std::min(n, m - off);
+        std::copy(b + off, b + off + len, y.begin());
+        std::fill(y.begin() + len, y.end(), 0ULL);
+        _KaratsubaPoly(x.data(), y.data(), n, piece.data());
+        for (size_t i = 0; i < 2 * n; ++i) {
+            acc[off + i] += piece[i];
         }
-        for (long long i = lhs.length - 1; i >= 0; --i) {
-            if (lhs.data[i] != rhs.data[i]) {
-                return lhs.data[i] > rhs.data[i];
-            }
+    }
+    unsigned long long carry = 0;
+    for (size_t k = 0; k < n + m; ++k) {
+        unsigned long long sum = acc[k] + carry;
+        r[k] = static_cast<int>(sum % 10000);
+        carry = sum / 10000;
+    }
+}
+
+static unsigned int _PowMod(unsigned long long base, unsigned long long e, unsigned int mod) {
+    unsigned long long result = 1;
+    base %= mod;
+    while (e) {
+        if (e & 1) {
+            result = result * base % mod;
         }
-        return true;
+        base = base * base % mod;
+        e >>= 1;
     }
+    return static_cast<unsigned int>(result);
 }
 
-Bint operator+(const Bint &lhs, const Bint &rhs) {
-    if (lhs.isMinus == rhs.isMinus) {
-        size_t maxLen = std::max(lhs.length, rhs.length);
-        size_t expectLen = maxLen + 1;
-        Bint result(expectLen);  // special constructor
-        for (size_t i = 0; i < maxLen; ++i) {
-            result.data[i] = lhs.data[i] + rhs.data[i];
+// In-place number-theoretic transform modulo a prime with primitive root
+// 3; a constant Mod lets the compiler replace the divisions
+template <unsigned int Mod>
+void Bint::_Ntt(std::vector<unsigned int> &a, bool invert) {
+    const unsigned int mod = Mod;
+    size_t n = a.size();
+    for (size_t i = 1, j = 0; i < n; ++i) {
+        size_t bit = n >> 1;
+        for (; j & bit; bit >>= 1) {
+            j ^= bit;
+        }
+        j ^= bit;
+        if (i < j) {
+            std::swap(a[i], a[j]);
+        }
+    }
+    std::vector<unsigned int> roots(n >> 1);
+    for (size_t len = 2; len <= n; len <<= 1) {
+        size_t half = len >> 1;
+        unsigned int w = _PowMod(3, (mod - 1) / len, mod);
+        if (invert) {
+            w = _PowMod(w, mod - 2, mod);
+        }
+        roots[0] = 1;
+        for (size_t k = 1; k < half; ++k) {
+            roots[k] = static_cast<unsigned int>(static_cast<unsigned long long>(roots[k - 1]) * w % mod);
         }
-        for (size_t i = 0; i < maxLen; ++i) {
-            if (result.data[i] > 10000) {
-                result.data[i] -= 10000;
-                ++result.data[i + 1];
+        for (size_t i = 0; i < n; i += len) {
+            for (size_t k = 0; k < half; ++k) {
+                unsigned int u = a[i + k];
+                unsigned int v = static_cast<unsigned int>(static_cast<unsigned long long>(a[i + k + half]) * roots[k] % mod);
+                a[i + k] = u + v >= mod ? u + v - mod : u + v;
+                a[i + k + half] = u >= v ? u - v : u + mod - v;
             }
         }
-        result.length = result.data[maxLen] > 0 ? maxLen + 1 : maxLen;
-        result.isMinus = lhs.isMinus;
-        return result;
-    } else {
-        if (lhs.isMinus) {
-            return rhs - abs(lhs);
-        } else {
-            return lhs - abs(rhs);
+    }
+    if (invert) {
+        unsigned long long inv = _PowMod(n, mod - 2, mod);
+        for (size_t i = 0; i < n; ++i) {
+            a[i] = static_cast<unsigned int>(a[i] * inv % mod);
         }
     }
 }
 
-Bint operator-(const Bint &b) {
-    Bint result(b);
-    result.isMinus = !result.isMinus;
-    return result;
+// a * b as a cyclic convolution of length size modulo Mod
+template <unsigned int Mod>
+std::vector<unsigned int> Bint::_Convolve(const int *a, size_t n, const int *b, size_t m, size_t size) {
+    std::vector<unsigned int> fa(size, 0);
+    std::vector<unsigned int> fb(size, 0);
+    std::copy(a, a + n, fa.begin());
+    std::copy(b, b + m, fb.begin());
+    _Ntt<Mod>(fa, false);
+    _Ntt<Mod>(fb, false);
+    for (size_t i = 0; i < size; ++i) {
+        fa[i] = static_cast<unsigned int>(static_cast<unsigned long long>(fa[i]) * fb[i] % Mod);
+    }
+    _Ntt<Mod>(fa, true);
+    return fa;
 }
 
-Bint operator-(Bint &&b) {
-    b.isMinus = !b.isMinus;
-    return b;
+// Convolution modulo two primes, recombined by the Chinese remainder
+// theorem; exact while n * 10^8 per coefficient stays below their product
+void Bint::_MulNtt(const int *a, size_t n, const int *b, size_t m, int *r) {
+    const unsigned int P1 = 998244353;
+    const unsigned int P2 = 469762049;
+    size_t size = 1;
+    while (size < n + m) {
+        size <<= 1;
+    }
+    std::vector<unsigned int> res1 = _Convolve<P1>(a, n, b, m, size);
+    std::vector<unsigned int> res2 = _Convolve<P2>(a, n, b, m, size);
+    const unsigned long long inv = _PowMod(P1, P2 - 2, P2);
+    unsigned long long carry = 0;
+    for (size_t k = 0; k < n + m; ++k) {
+        unsigned long long r1 = res1[k];
+        unsigned long long diff = (res2[k] + P2 - r1 % P2) % P2;
+        unsigned long long x = r1 + static_cast<unsigned long long>(P1) * (diff * inv % P2);
+        x += carry;
+        r[k] = static_cast<int>(x % 10000);
+        carry = x / 10000;
+    }
 }
 
-Bint operator-(const Bint &lhs, const Bint &rhs) {
-    if (lhs.isMinus == rhs.isMinus) {
-        if (lhs.isMinus) {
-            return -(abs(lhs) - abs(rhs));
-        } else {
-            if (lhs < rhs) {
-                return -(rhs - lhs);
-            }
-            Bint result(std::max(lhs.length, rhs.length));
-            for (size_t i = 0; i < lhs.length; ++i) {
-                result.data[i] = lhs.data[i] - rhs.data[i];
-            }
-            for (size_t i = 0; i < lhs.length; ++i) {
-                if (result.data[i] < 0) {
-                    result.data[i] += 10000;
-                    ++result.data[i + 1];
-                }
-            }
-            while (result.length > 1 && result.data[result.length - 1] == 0) {
-                --result.length;
-            }
-            return result;
-        }
+void Bint::_Multiply(const int *a, size_t n, const int *b, size_t m, int *r) {
+    size_t shorter = std::min(n, m);
+    if (shorter < KARATSUBA_THRESHOLD) {
+        _MulSchool(a, n, b, m, r);
+    } else if (shorter >= NTT_THRESHOLD && n + m <= NTT_MAX_LENGTH) {
+        _MulNtt(a, n, b, m, r);
     } else {
-        return lhs + (-rhs);
+        _MulKaratsuba(a, n, b, m, r);
     }
 }
 
 Bint operator*(const Bint &lhs, const Bint &rhs) {
-    size_t expectLen = lhs.length + rhs.length + 2;
-    Bint result(expectLen);
-    for (size_t i = 0; i < lhs.length; ++i) {
-        for (size_t j = 0; j < rhs.length; ++j) {
-            long long tmp = result.data[i + j] +
-                            static_cast<long long>(lhs.data[i]) * rhs.data[j];
-            if (tmp >= 10000) {
-                result.data[i + j] = tmp % 10000;
-                result.data[i + j + 1] += static_cast<int>(tmp / 10000);
-            } else {
-                result.data[i + j] = tmp;
-            }
-        }
-    }
-    result.length = lhs.length + rhs.length - 1;
-    while (result.data[result.length] > 0) {
-        ++result.length;
-    }
-    while (result.length > 1 && result.data[result.length - 1] == 0) {
-        --result.length;
-    }
+    Bint result(lhs.length + rhs.length);
+    int *r = result._Limbs();
+    Bint::_Multiply(lhs._Limbs(), lhs.length, rhs._Limbs(), rhs.length, r);
+    result.length = lhs.length + rhs.length;
+    result.isMinus = lhs.isMinus != rhs.isMinus;
+    result._Trim();
     return result;
 }
 
+Bint operator*(Bint &&lhs, const Bint &rhs) {
+    lhs *= rhs;
+    return std::move(lhs);
+}
+
+Bint operator*(const Bint &lhs, Bint &&rhs) {
+    rhs *= lhs;
+    return std::move(rhs);
+}
+
+Bint operator*(Bint &&lhs, Bint &&rhs) {
+    lhs *= rhs;
+    return std::move(lhs);
+}
+
 Bint::~Bint() {
-    if (data != nullptr) {
-        delete[] data;
-        data = nullptr;
+    if (capacity > INLINE_CAPACITY) {
+        delete[] store.heap;
     }
 }
 }  // namespace Util
+
+// The limbs are inline or behind a pointer, never referenced from
+// elsewhere in the object, so moving its bytes moves a Bint
+namespace sjtu {
+template <>
+struct is_trivially_relocatable<Util::Bint> : std::true_type {};
+}  // namespace sjtu
@@ -1,34 +1,126 @@
 #ifndef DIAMOND_MATRIX_HPP
 #define DIAMOND_MATRIX_HPP
 
+#include <algorithm>
 #include <iomanip>
 #include <iostream>
 #include <stdexcept>
-#include <vector>
+#include <type_traits>
+#include <utility>
+
+#include "allocator.hpp"
+#include "vector.hpp"
+
+// Tells GCC that a loop's iterations do not depend on one another
+#if defined(__GNUC__) && !defined(__clang__)
+#define DIAMOND_IVDEP _Pragma("GCC ivdep")
+#else
+#define DIAMOND_IVDEP
+#endif
 
 namespace Diamond {
 
+namespace detail {
+/**
+ * How the kernels below treat an element type. Arithmetic types run flat
+ * loops over the aligned buffer that the compiler vectorizes, and the
+ * product works on block x block tiles so that the tile of the right
+ * operand stays in cache. Other types, such as Util::Bint, are updated
+ * in place one element at a time, untiled, as each operation costs far
+ * more than a cache miss.
+ */
+template <typename _Td>
+struct MatrixTraits {
+    static constexpr bool vectorizable = std::is_arithmetic<_Td>::value;
+    static constexpr size_t block = vectorizable ? 64 : ~size_t(0);
+};
+
+// The buffer of a Matrix starts on a cache line
+template <typename _Td>
+inline _Td *Aligned(_Td *p) {
+#if defined(__GNUC__)
+    if constexpr (MatrixTraits<_Td>::vectorizable) {
+        return static_cast<_Td *>(__builtin_assume_aligned(p, 64));
+    }
+#endif
+    return p;
+}
+
+// op(dst[i], src[i]) for i in [0, n); dst and src may be the same buffer
+template <typename _Td, typename _Op>
+void ZipInPlace(_Td *dst, const _Td *src, size_t n, _Op op) {
+    dst = Aligned(dst);
+    src = Aligned(src);
+    DIAMOND_IVDEP
+    for (size_t i = 0; i < n; ++i) {
+        op(dst[i], src[i]);
+    }
+}
+
+template <typename _Td, typename _Op>
+void MapInPlace(_Td *dst, size_t n, _Op op) {
+    dst = Aligned(dst);
+    DIAMOND_IVDEP
+    for (size_t i = 0; i < n; ++i) {
+        op(dst[i]);
+    }
+}
+
+/**
+ * Adds the n x p product of the n x m a and the m x p b, all row-major,
+ * to c. Each c[i][j] still sums its terms in increasing k.
+ */
+template <typename _Td>
+void MultiplyAdd(const _Td *a, const _Td *b, _Td *c, size_t n, size_t m, size_t p) {
+    const size_t block = MatrixTraits<_Td>::block;
+    for (size_t kk = 0; kk < m; kk += std::min(block, m - kk)) {
+        size_t kEnd = kk + std::min(block, m - kk);
+        for (size_t jj = 0; jj < p; jj += std::min(block, p - jj)) {
+            size_t jEnd = jj + std::min(block, p - jj);
+            for (size_t i = 0; i < n; ++i) {
+                const _Td *ai = a + i * m;
+                _Td *ci = c + i * p;
+                for (size_t k = kk; k < kEnd; ++k) {
+                    const _Td &aik = ai[k];
+                    const _Td *bk = b + k * p;
+                    DIAMOND_IVDEP
+                    for (size_t j = jj; j < jEnd; ++j) {
+                        ci[j] += aik * bk[j];
+                    }
+                }
+            }
+        }
+    }
+}
+}  // namespace detail
+
+/**
+ * A dense matrix stored row-major in one contiguous buffer, aligned to a
+ * cache line. m[i] is a proxy for row i that indexes straight into it.
+ */
 template <typename _Td>
 class Matrix {
    protected:
+    using Storage = sjtu::vector<_Td, sjtu::aligned_allocator<_Td, 64>>;
+
     size_t n_rows = 0;
     size_t n_cols = 0;
-    std::vector<std::vector<_Td>> data;
+    Storage data;
     class RowProxy {
-        std::vector<_Td> &row;
+        _Td *row;
 
        public:
-        RowProxy(std::vector<_Td> &_row) : row(_row) {
+        RowProxy(_Td *_row) : row(_row) {
         }
         _Td &operator[](const size_t &pos) {
             return row[pos];
         }
     };
     class ConstRowProxy {
-        const std::vector<_Td> &row;
+        const _Td *row;
 
        public:
-        ConstRowProxy(const std::vector<_Td> &_row) : row(_row) {
+        ConstRowProxy(const _Td *_row) : row(_row) {
         }
         const _Td &operator[](const size_t &pos) const {
             return row[pos];
@@ -38,33 +130,36 @@ class Matrix {
    public:
     Matrix() {};
     Matrix(const size_t &_n_rows, const size_t &_n_cols)
-        : n_rows(_n_rows),
-          n_cols(_n_cols),
-          data(
-              std::vector<std::vector<_Td>>(n_rows, std::vector<_Td>(n_cols))) {
+        : n_rows(_n_rows), n_cols(_n_cols) {
+        data.resize(n_rows * n_cols);
     }
     Matrix(const size_t &_n_rows, const size_t &_n_cols, const _Td &fillValue)
-        : n_rows(_n_rows),
-          n_cols(_n_cols),
-          data(std::vector<std::vector<_Td>>(
-              n_rows, std::vector<_Td>(n_cols, fillValue))) {
+        : n_rows(_n_rows), n_cols(_n_cols) {
+        data.assign(n_rows * n_cols, fillValue);
     }
     Matrix(const Matrix<_Td> &mat)
         : n_rows(mat.n_rows), n_cols(mat.n_cols), data(mat.data) {
     }
+    // Takes over mat's buffer, leaving it an empty 0 x 0 matrix
     Matrix(Matrix<_Td> &&mat) noexcept
-        : n_rows(mat.n_rows), n_cols(mat.n_cols), data(mat.data) {
+        : n_rows(mat.n_rows), n_cols(mat.n_cols), data(std::move(mat.data)) {
+        mat.n_rows = 0;
+        mat.n_cols = 0;
     }
     Matrix<_Td> &operator=(const Matrix<_Td> &rhs) {
+        this->data = rhs.data;
         this->n_rows = rhs.n_rows;
         this->n_cols = rhs.n_cols;
-        this->data = rhs.data;
         return *this;
     }
-    Matrix<_Td> &operator=(Matrix<_Td> &&rhs) {
-        this->n_rows = rhs.n_rows;
-        this->n_cols = rhs.n_cols;
-        this->data = rhs.data;
+    Matrix<_Td> &operator=(Matrix<_Td> &&rhs) noexcept {
+        if (this != &rhs) {
+            this->data = std::move(rhs.data);
+            this->n_rows = rhs.n_rows;
+            this->n_cols = rhs.n_cols;
+            rhs.n_rows = 0;
+            rhs.n_cols = 0;
+        }
         return *this;
     }
     inline const size_t &RowSize() const {
@@ -74,44 +169,125 @@ class Matrix {
         return n_cols;
     }
     RowProxy operator[](const size_t &Kth) {
-        return RowProxy(this->data[Kth]);
+        return RowProxy(this->data.data() + Kth * n_cols);
     }
     const ConstRowProxy operator[](const size_t &Kth) const {
-        return ConstRowProxy(this->data[Kth]);
+        return ConstRowProxy(this->data.data() + Kth * n_cols);
+    }
+    /**
+     * The n_rows * n_cols elements, row after row.
+     */
+    _Td *Data() {
+        return this->data.data();
     }
+    const _Td *Data() const {
+        return this->data.data();
+    }
+
+    // In place; none of these allocate, except *= by a matrix that is not
+    // square or is *this
+    Matrix<_Td> &operator+=(const Matrix<_Td> &rhs) {
+        CheckSameSize(rhs);
+        detail::ZipInPlace(Data(), rhs.Data(), data.size(), [](_Td &x, const _Td &y) { x += y; });
+        return *this;
+    }
+    Matrix<_Td> &operator-=(const Matrix<_Td> &rhs) {
+        CheckSameSize(rhs);
+        detail::ZipInPlace(Data(), rhs.Data(), data.size(), [](_Td &x, const _Td &y) { x -= y; });
+        return *this;
+    }
+    Matrix<_Td> &operator*=(const _Td &rhs) {
+        // rhs may be an element of *this
+        _Td factor(rhs);
+        detail::MapInPlace(Data(), data.size(), [&factor](_Td &x) { x *= factor; });
+        return *this;
+    }
+    /**
+     * Row i of the product needs only row i of *this, so a square rhs
+     * is applied a band of rows at a time through scratch rows that are
+     * swapped in.
+     */
+    Matrix<_Td> &operator*=(const Matrix<_Td> &rhs);
     ~Matrix() = default;
+
+   private:
+    void CheckSameSize(const Matrix<_Td> &rhs) const {
+        if (n_rows != rhs.n_rows || n_cols != rhs.n_cols) {
+            throw std::invalid_argument("different matrics\'s sizes");
+        }
+    }
 };
 
-/**
- * Sum of two matrics.
- */
 template <typename _Td>
-Matrix<_Td> operator+(const Matrix<_Td> &a, const Matrix<_Td> &b) {
-    if (a.RowSize() != b.RowSize() || a.ColSize() != b.ColSize()) {
+Matrix<_Td> &Matrix<_Td>::operator*=(const Matrix<_Td> &rhs) {
+    if (n_cols != rhs.n_rows) {
         throw std::invalid_argument("different matrics\'s sizes");
     }
-    Matrix<_Td> c(a.RowSize(), a.ColSize());
-    for (size_t i = 0; i < a.RowSize(); ++i) {
-        for (size_t j = 0; j < a.ColSize(); ++j) {
-            c[i][j] = a[i][j] + b[i][j];
+    if (this == &rhs || rhs.n_rows != rhs.n_cols) {
+        return *this = *this * rhs;
+    }
+    size_t band = std::min(n_rows, size_t(64));
+    Storage scratch;
+    scratch.assign(band * n_cols, _Td(0));
+    for (size_t i = 0; i < n_rows; i += band) {
+        size_t rows = std::min(band, n_rows - i);
+        _Td *own = Data() + i * n_cols;
+        detail::MultiplyAdd<_Td>(own, rhs.Data(), scratch.data(), rows, n_cols, n_cols);
+        for (size_t k = 0; k < rows * n_cols; ++k) {
+            std::swap(own[k], scratch[k]);
+            scratch[k] = 0;
         }
     }
+    return *this;
+}
+
+/**
+ * Sum of two matrics. The rvalue overloads add into the operand they
+ * take instead of allocating.
+ */
+template <typename _Td>
+Matrix<_Td> operator+(const Matrix<_Td> &a, const Matrix<_Td> &b) {
+    Matrix<_Td> c(a);
+    c += b;
     return c;
 }
 
+template <typename _Td>
+Matrix<_Td> operator+(Matrix<_Td> &&a, const Matrix<_Td> &b) {
+    a += b;
+    return std::move(a);
+}
+
+template <typename _Td>
+Matrix<_Td> operator+(const Matrix<_Td> &a, Matrix<_Td> &&b) {
+    b += a;
+    return std::move(b);
+}
+
+template <typename _Td>
+Matrix<_Td> operator+(Matrix<_Td> &&a, Matrix<_Td> &&b) {
+    a += b;
+    return std::move(a);
+}
+
 template <typename _Td>
 Matrix<_Td> operator-(const Matrix<_Td> &a, const Matrix<_Td> &b) {
-    if (a.RowSize() != b.RowSize() || a.ColSize() != b.ColSize()) {
-        throw std::invalid_argument("different matrics\'s sizes");
-    }
-    Matrix<_Td> c(a.RowSize(), a.ColSize());
-    for (size_t i = 0; i < a.RowSize(); ++i) {
-        for (size_t j = 0; j < a.ColSize(); ++j) {
-            c[i][j] = a[i][j] - b[i][j];
-        }
-    }
+    Matrix<_Td> c(a);
+    c -= b;
     return c;
 }
+
+template <typename _Td>
+Matrix<_Td> operator-(Matrix<_Td> &&a, const Matrix<_Td> &b) {
+    a -= b;
+    return std::move(a);
+}
+
+template <typename _Td>
+Matrix<_Td> operator-(Matrix<_Td> &&a, Matrix<_Td> &&b) {
+    a -= b;
+    return std::move(a);
+}
 template <typename _Td>
 bool operator==(const Matrix<_Td> &a, const Matrix<_Td> &b) {
     if (a.RowSize() != b.RowSize() || a.ColSize() != b.ColSize()) {
@@ -143,7 +319,7 @@ Matrix<_Td> operator-(Matrix<_Td> &&mat) {
             mat[i][j] = -mat[i][j];
         }
     }
-    return mat;
+    return std::move(mat);
 }
 
 /**
@@ -155,13 +331,7 @@ Matrix<_Td> operator*(const Matrix<_Td> &a, const Matrix<_Td> &b) {
         throw std::invalid_argument("different matrics\'s sizes");
     }
     Matrix<_Td> c(a.RowSize(), b.ColSize(), 0);
-    for (size_t i = 0; i < a.RowSize(); ++i) {
-        for (size_t j = 0; j < b.ColSize(); ++j) {
-            for (size_t k = 0; k < a.ColSize(); ++k) {
-                c[i][j] += a[i][k] * b[k][j];
-            }
-        }
-    }
+    detail::MultiplyAdd(a.Data(), b.Data(), c.Data(), a.RowSize(), a.ColSize(), b.ColSize());
     return c;
 }
 
@@ -170,23 +340,15 @@ Matrix<_Td> operator*(const Matrix<_Td> &a, const Matrix<_Td> &b) {
  */
 template <typename _Td>
 Matrix<_Td> operator*(const Matrix<_Td> &a, const _Td &b) {
-    Matrix<_Td> c(a.RowSize(), a.ColSize());
-    for (size_t i = 0; i < a.RowSize(); ++i) {
-        for (size_t j = 0; j < a.ColSize(); ++j) {
-            c[i][j] = a[i][j] * b;
-        }
-    }
+    Matrix<_Td> c(a);
+    c *= b;
     return c;
 }
 
 template <typename _Td>
 Matrix<_Td> operator*(const _Td &b, const Matrix<_Td> &a) {
-    Matrix<_Td> c(a.RowSize(), a.ColSize());
-    for (size_t i = 0; i < a.RowSize(); ++i) {
-        for (size_t j = 0; j < a.ColSize(); ++j) {
-            c[i][j] = a[i][j] * b;
-        }
-    }
+    Matrix<_Td> c(a);
+    c *= b;
     return c;
 }
 
@@ -248,7 +410,7 @@ Matrix<_Td> Pow(Matrix<_Td> A, size_t &b) {
     Matrix<_Td> result = I<_Td>(A.ColSize());
     while (b > 0) {
         if (b & static_cast<size_t>(1)) {
-            result = result * A;
+            result *= A;
         }
         A = A * A;
         b = b >> static_cast<size_t>(1);
@@ -257,4 +419,12 @@ Matrix<_Td> Pow(Matrix<_Td> A, size_t &b) {
 }
 
 }  // namespace Diamond
+
+// A Matrix owns its buffer through a pointer only, so moving its bytes
+// moves it
+namespace sjtu {
+template <typename _Td>
+struct is_trivially_relocatable<Diamond::Matrix<_Td>> : std::true_type {};
+}  // namespace sjtu
+
 #endif
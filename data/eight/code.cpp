@@ -0,0 +1,115 @@
+#include "vector.hpp"
+
+#include <iostream>
+#include <string>
+
+// Counts how often it is copied and moved
+class Tracked {
+public:
+	static int copies;
+	static int moves;
+	int key;
+	std::string name;
+	Tracked(int k, const std::string &n) : key(k), name(n) {}
+	Tracked(const Tracked &other) : key(other.key), name(other.name) {
+		++copies;
+	}
+	Tracked(Tracked &&other) noexcept : key(other.key), name(std::move(other.name)) {
+		++moves;
+	}
+	Tracked &operator=(const Tracked &other) {
+		key = other.key;
+		name = other.name;
+		++copies;
+		return *this;
+	}
+	Tracked &operator=(Tracked &&other) noexcept {
+		key = other.key;
+		name = std::move(other.name);
+		++moves;
+		return *this;
+	}
+};
+int Tracked::copies = 0;
+int Tracked::moves = 0;
+
+void Print(const sjtu::vector<Tracked> &v)
+{
+	for (sjtu::vector<Tracked>::const_iterator it = v.cbegin(); it != v.cend(); ++it) {
+		std::cout << (*it).key << ":" << (*it).name << " ";
+	}
+	std::cout << std::endl;
+}
+
+sjtu::vector<Tracked> Build(int n)
+{
+	sjtu::vector<Tracked> v;
+	for (int i = 0; i < n; ++i) {
+		v.emplace_back(i, std::string(1, 'a' + i % 26));
+	}
+	return v;
+}
+
+void TestEmplace()
+{
+	std::cout << "Testing emplace_back and emplace..." << std::endl;
+	sjtu::vector<Tracked> v = Build(100);
+	std::cout << "copies after build: " << Tracked::copies << std::endl;
+	Tracked &last = v.emplace_back(100, "last");
+	std::cout << last.key << " " << last.name << std::endl;
+	v.emplace(v.cbegin(), -1, "first");
+	v.emplace(v.cbegin() + 50, -50, "middle");
+	v.emplace(v.cend(), 101, "end");
+	std::cout << v.size() << " " << v.front().name << " " << v[50].name << " " << v.back().name << std::endl;
+	std::cout << "copies after emplace: " << Tracked::copies << std::endl;
+}
+
+void TestRvalue()
+{
+	std::cout << "Testing rvalue push_back and insert..." << std::endl;
+	Tracked::copies = 0;
+	sjtu::vector<Tracked> v;
+	for (int i = 0; i < 10; ++i) {
+		v.push_back(Tracked(i, "pushed"));
+	}
+	v.insert(v.begin() + 3, Tracked(30, "inserted"));
+	v.insert(0, Tracked(-10, "front"));
+	Tracked t(99, "named");
+	v.insert(v.end(), std::move(t));
+	Print(v);
+	std::cout << "copies: " << Tracked::copies << std::endl;
+	v.insert(v.begin() + 2, v[5]);
+	v.insert(v.begin(), std::move(v[1]));
+	v.erase(2);
+	Print(v);
+	std::cout << "copies: " << Tracked::copies << std::endl;
+}
+
+void TestMove()
+{
+	std::cout << "Testing move constructor and move assignment..." << std::endl;
+	Tracked::copies = 0;
+	Tracked::moves = 0;
+	sjtu::vector<Tracked> a = Build(20);
+	sjtu::vector<Tracked> b(std::move(a));
+	std::cout << a.size() << " " << a.empty() << " " << b.size() << std::endl;
+	sjtu::vector<Tracked> c = Build(3);
+	int moves = Tracked::moves;
+	c = std::move(b);
+	std::cout << b.size() << " " << c.size() << " " << c[19].name << std::endl;
+	std::cout << "element moves: " << Tracked::moves - moves << std::endl;
+	c = std::move(c);
+	std::cout << c.size() << std::endl;
+	b.push_back(Tracked(1, "reused"));
+	a = c;
+	std::cout << b.size() << " " << b[0].name << " " << a.size() << std::endl;
+	std::cout << "copies: " << Tracked::copies << std::endl;
+}
+
+int main()
+{
+	TestEmplace();
+	TestRvalue();
+	TestMove();
+	return 0;
+}
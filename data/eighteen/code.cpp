@@ -0,0 +1,241 @@
+#include "class-bint.hpp"
+#include "class-matrix.hpp"
+#include "serialize.hpp"
+#include "vector.hpp"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <streambuf>
+#include <string>
+
+template<>
+struct sjtu::codec<Util::Bint> : sjtu::text_codec<Util::Bint> {};
+
+// Shape first, then every entry through the Bint codec
+template<>
+struct sjtu::codec<Diamond::Matrix<Util::Bint>> {
+	static void write(std::ostream &os, const Diamond::Matrix<Util::Bint> &m) {
+		sjtu::write_binary<uint64_t>(os, m.RowSize());
+		sjtu::write_binary<uint64_t>(os, m.ColSize());
+		for (size_t i = 0; i < m.RowSize(); ++i) {
+			for (size_t j = 0; j < m.ColSize(); ++j) {
+				sjtu::codec<Util::Bint>::write(os, m[i][j]);
+			}
+		}
+	}
+	static Diamond::Matrix<Util::Bint> read(std::istream &is) {
+		size_t rows = sjtu::read_binary<uint64_t>(is);
+		size_t cols = sjtu::read_binary<uint64_t>(is);
+		Diamond::Matrix<Util::Bint> m(rows, cols);
+		for (size_t i = 0; i < rows; ++i) {
+			for (size_t j = 0; j < cols; ++j) {
+				m[i][j] = sjtu::codec<Util::Bint>::read(is);
+			}
+		}
+		return m;
+	}
+};
+
+struct Sample {
+	int id;
+	double value;
+};
+
+void TestTrivial()
+{
+	std::cout << "Testing trivially copyable elements..." << std::endl;
+	sjtu::vector<long long> v;
+	for (long long i = 0; i < 100000; ++i) {
+		v.push_back(i * i);
+	}
+	std::stringstream buffer;
+	sjtu::save(buffer, v);
+	std::cout << "bytes " << buffer.str().size() << std::endl;
+
+	sjtu::vector<long long> w;
+	w.push_back(-1);
+	sjtu::load(buffer, w);
+	std::cout << w.size() << " " << w[0] << " " << w.back() << " capacity " << w.capacity() << std::endl;
+
+	const std::string path = "/tmp/sjtu_serialize_eighteen.bin";
+	sjtu::vector<Sample> s;
+	for (int i = 0; i < 1000; ++i) {
+		s.push_back(Sample{i, i / 4.0});
+	}
+	sjtu::save_file(path, s);
+	sjtu::vector<Sample> t;
+	sjtu::load_file(path, t);
+	std::cout << t.size() << " " << t[999].id << " " << t[999].value << std::endl;
+
+	try {
+		sjtu::vector<int> wrong;
+		sjtu::load_file(path, wrong);
+		std::cout << "loaded" << std::endl;
+	} catch (sjtu::runtime_error &) {
+		std::cout << "runtime_error" << std::endl;
+	}
+	std::remove(path.c_str());
+}
+
+void TestStreaming()
+{
+	std::cout << "Testing streaming reader..." << std::endl;
+	sjtu::vector<int> v;
+	for (int i = 0; i < 1000; ++i) {
+		v.push_back(i);
+	}
+	std::stringstream buffer;
+	sjtu::save(buffer, v);
+
+	sjtu::vector_reader<int> reader(buffer);
+	std::cout << "total " << reader.size() << std::endl;
+	sjtu::vector<int> batch;
+	long long sum = 0;
+	int batches = 0;
+	while (!reader.done()) {
+		batch.clear();
+		reader.read(batch, 300);
+		for (size_t i = 0; i < batch.size(); ++i) {
+			sum += batch[i];
+		}
+		std::cout << "batch " << batch.size() << std::endl;
+		++batches;
+	}
+	std::cout << batches << " batches sum " << sum << " next " << reader.read(batch, 10) << std::endl;
+}
+
+void TestCodec()
+{
+	std::cout << "Testing codecs..." << std::endl;
+	sjtu::vector<Util::Bint> v;
+	Util::Bint x(1);
+	for (int i = 0; i < 30; ++i) {
+		v.push_back(x);
+		x = x * Util::Bint(-97);
+	}
+	std::stringstream buffer;
+	sjtu::save(buffer, v);
+	sjtu::vector<Util::Bint> w;
+	sjtu::load(buffer, w);
+	std::cout << w.size() << " " << w[29] << " equal " << (w[29] == v[29]) << std::endl;
+
+	sjtu::vector<Diamond::Matrix<Util::Bint>> m;
+	for (int k = 1; k <= 3; ++k) {
+		m.push_back(Diamond::Matrix<Util::Bint>(k, k + 1, Util::Bint(k * 1000000007LL)));
+	}
+	std::stringstream mbuffer;
+	sjtu::save(mbuffer, m);
+	sjtu::vector<Diamond::Matrix<Util::Bint>> n;
+	sjtu::load(mbuffer, n);
+	std::cout << n.size() << std::endl;
+	for (size_t i = 0; i < n.size(); ++i) {
+		std::cout << n[i];
+	}
+
+	std::stringstream truncated(buffer.str().substr(0, 40));
+	try {
+		sjtu::load(truncated, w);
+		std::cout << "loaded" << std::endl;
+	} catch (sjtu::runtime_error &) {
+		std::cout << "runtime_error" << std::endl;
+	}
+}
+
+// Hands out a string but cannot seek, like a pipe
+struct Unseekable : std::streambuf {
+	std::string data;
+
+	explicit Unseekable(const std::string &s) : data(s) {
+		setg(&data[0], &data[0], &data[0] + data.size());
+	}
+};
+
+// A header claiming count elements, followed by body
+template<typename T>
+std::string Forged(uint64_t count, const std::string &body)
+{
+	sjtu::vector<T> empty;
+	std::stringstream buffer;
+	sjtu::save(buffer, empty);
+	std::string s = buffer.str();
+	std::memcpy(&s[s.size() - sizeof(uint64_t)], &count, sizeof(count));
+	return s + body;
+}
+
+void TestCorrupt()
+{
+	std::cout << "Testing corrupt input..." << std::endl;
+	const uint64_t huge = uint64_t(1) << 60;
+	std::string body(80, '\x01');
+	const char *names[] = {"seekable", "unseekable"};
+	for (int k = 0; k < 2; ++k) {
+		std::stringstream seekable(Forged<long long>(huge, body));
+		Unseekable pipe(Forged<long long>(huge, body));
+		std::istream unseekable(&pipe);
+		sjtu::vector<long long> v;
+		v.push_back(5);
+		try {
+			sjtu::load(k == 0 ? static_cast<std::istream &>(seekable) : unseekable, v);
+			std::cout << "loaded" << std::endl;
+		} catch (sjtu::runtime_error &) {
+			std::cout << names[k] << " runtime_error size " << v.size() << " capacity below 2^17 "
+					  << (v.capacity() < (1 << 17)) << std::endl;
+		}
+	}
+
+	// count * sizeof(T) wraps around to 8 bytes, which the file has
+	const std::string path = "/tmp/sjtu_serialize_eighteen_forged.bin";
+	{
+		std::ofstream os(path, std::ios::binary);
+		os << Forged<long long>((uint64_t(1) << 61) + 1, std::string(8, '\x01'));
+	}
+	sjtu::vector<long long> f;
+	try {
+		sjtu::load_file(path, f);
+		std::cout << "loaded" << std::endl;
+	} catch (sjtu::runtime_error &) {
+		std::cout << "file runtime_error size " << f.size() << std::endl;
+	}
+	std::remove(path.c_str());
+
+	// An empty record cannot be read as a number
+	std::string record(sizeof(uint64_t), '\0');
+	std::stringstream empty(Forged<Util::Bint>(1, record));
+	sjtu::vector<Util::Bint> w;
+	try {
+		sjtu::load(empty, w);
+		std::cout << "loaded " << w[0] << std::endl;
+	} catch (sjtu::runtime_error &) {
+		std::cout << "runtime_error size " << w.size() << std::endl;
+	}
+
+	// Batches of codec elements grow the vector geometrically
+	sjtu::vector<Util::Bint> v;
+	for (int i = 0; i < 1000; ++i) {
+		v.push_back(Util::Bint(i));
+	}
+	std::stringstream buffer;
+	sjtu::save(buffer, v);
+	sjtu::vector_reader<Util::Bint> reader(buffer);
+	sjtu::vector<Util::Bint> all;
+	int reallocations = 0;
+	while (!reader.done()) {
+		size_t capacity = all.capacity();
+		reader.read(all, 10);
+		reallocations += all.capacity() != capacity;
+	}
+	std::cout << all.size() << " " << all[999] << " reallocations below 20 " << (reallocations < 20) << std::endl;
+}
+
+int main()
+{
+	TestTrivial();
+	TestStreaming();
+	TestCodec();
+	TestCorrupt();
+	return 0;
+}
@@ -0,0 +1,193 @@
+#include "small_vector.hpp"
+
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <stdexcept>
+#include <string>
+
+static size_t heap_allocations = 0;
+static long long heap_blocks = 0;
+
+void *operator new(size_t size)
+{
+	++heap_allocations;
+	++heap_blocks;
+	void *p = std::malloc(size == 0 ? 1 : size);
+	if (p == nullptr) {
+		throw std::bad_alloc();
+	}
+	return p;
+}
+
+void operator delete(void *p) noexcept
+{
+	heap_blocks -= p != nullptr;
+	std::free(p);
+}
+
+void operator delete(void *p, size_t) noexcept
+{
+	heap_blocks -= p != nullptr;
+	std::free(p);
+}
+
+template<typename Vec>
+void Print(const Vec &v)
+{
+	for (typename Vec::const_iterator it = v.cbegin(); it != v.cend(); ++it) {
+		std::cout << *it << " ";
+	}
+	std::cout << std::endl;
+}
+
+void TestInline()
+{
+	std::cout << "Testing inline storage..." << std::endl;
+	size_t before = heap_allocations;
+	long long sum = 0;
+	for (int round = 0; round < 1000; ++round) {
+		sjtu::small_vector<int, 10> v;
+		for (int i = 0; i < 8; ++i) {
+			v.push_back(round + i);
+		}
+		v.insert(v.begin() + 2, -1);
+		v.erase(v.begin());
+		sjtu::small_vector<int, 10> w(v);
+		w = v;
+		sum += w[0] + w.back();
+	}
+	std::cout << sum << " allocations: " << heap_allocations - before << std::endl;
+}
+
+void TestSpill()
+{
+	std::cout << "Testing spill to heap..." << std::endl;
+	sjtu::small_vector<std::string, 4> v;
+	for (int i = 0; i < 4; ++i) {
+		v.push_back(std::to_string(i));
+	}
+	std::cout << v.size() << " " << v.capacity() << " " << v.is_small() << std::endl;
+	v.push_back("4");
+	std::cout << v.size() << " " << v.capacity() << " " << v.is_small() << std::endl;
+	v.insert(0, v[4]);
+	v.emplace(v.cbegin() + 3, 2, 'x');
+	Print(v);
+	sjtu::small_vector<std::string, 4> moved(std::move(v));
+	std::cout << v.size() << " " << v.is_small() << " " << moved.size() << std::endl;
+	while (moved.size() > 3) {
+		moved.pop_back();
+	}
+	moved.shrink_to_fit();
+	std::cout << moved.size() << " " << moved.capacity() << " " << moved.is_small() << std::endl;
+	Print(moved);
+	v = moved;
+	v.push_back("back");
+	moved = std::move(v);
+	Print(moved);
+}
+
+void TestExceptions()
+{
+	std::cout << "Testing exceptions..." << std::endl;
+	sjtu::small_vector<int, 2> v;
+	try {
+		v.pop_back();
+	} catch (sjtu::container_is_empty &) {
+		std::cout << "container_is_empty" << std::endl;
+	}
+	v.push_back(1);
+	try {
+		v.at(1);
+	} catch (sjtu::index_out_of_bound &) {
+		std::cout << "index_out_of_bound" << std::endl;
+	}
+	sjtu::small_vector<int, 2> w;
+	try {
+		std::cout << (v.end() - w.begin()) << std::endl;
+	} catch (sjtu::invalid_iterator &) {
+		std::cout << "invalid_iterator" << std::endl;
+	}
+}
+
+// Copies throw once armed; with no noexcept move, growth copies too
+struct Fragile {
+	static int live;
+	static int copies_left;
+	int value;
+
+	explicit Fragile(int v) : value(v) {
+		++live;
+	}
+	Fragile(const Fragile &other) : value(other.value) {
+		if (copies_left >= 0 && copies_left-- == 0) {
+			throw std::runtime_error("copy failed");
+		}
+		++live;
+	}
+	~Fragile() {
+		--live;
+	}
+};
+
+int Fragile::live = 0;
+int Fragile::copies_left = -1;
+
+void TestUnwind()
+{
+	std::cout << "Testing unwinding..." << std::endl;
+	{
+		sjtu::small_vector<Fragile, 2> v;
+		for (int i = 0; i < 4; ++i) {
+			v.push_back(Fragile(i));
+		}
+		long long blocks = heap_blocks;
+		int live = Fragile::live;
+		// Fails on the new element, then on each relocated one; counted once the exception is gone
+		for (int fail = 0; fail <= 4; ++fail) {
+			Fragile extra(9);
+			Fragile::copies_left = fail;
+			bool thrown = false;
+			try {
+				v.push_back(extra);
+			} catch (std::runtime_error &) {
+				thrown = true;
+			}
+			Fragile::copies_left = -1;
+			std::cout << "thrown " << thrown << " size " << v.size() << " capacity " << v.capacity() << " back "
+					  << v[3].value << " leaked " << (Fragile::live - live - 1) << " " << (heap_blocks - blocks)
+					  << std::endl;
+		}
+
+		// Growing by reserve and copying the whole vector
+		Fragile::copies_left = 2;
+		bool thrown = false;
+		try {
+			v.reserve(100);
+		} catch (std::runtime_error &) {
+			thrown = true;
+		}
+		std::cout << "thrown " << thrown << " capacity " << v.capacity() << " leaked " << (Fragile::live - live) << " "
+				  << (heap_blocks - blocks) << std::endl;
+		Fragile::copies_left = 3;
+		thrown = false;
+		try {
+			sjtu::small_vector<Fragile, 2> copy(v);
+		} catch (std::runtime_error &) {
+			thrown = true;
+		}
+		std::cout << "thrown " << thrown << " leaked " << (Fragile::live - live) << " " << (heap_blocks - blocks)
+				  << std::endl;
+		Fragile::copies_left = -1;
+	}
+	std::cout << "live " << Fragile::live << std::endl;
+}
+
+int main()
+{
+	TestInline();
+	TestSpill();
+	TestExceptions();
+	TestUnwind();
+	return 0;
+}
@@ -0,0 +1,123 @@
+#include "vector.hpp"
+
+#include <iostream>
+#include <sstream>
+#include <string>
+
+// Relocated by copy: the move constructor may throw
+class Copyable {
+public:
+	int v;
+	Copyable(int v = 0) : v(v) {}
+	Copyable(const Copyable &other) : v(other.v) {}
+	Copyable(Copyable &&other) : v(other.v) {}
+	Copyable &operator=(const Copyable &other) {
+		v = other.v;
+		return *this;
+	}
+};
+
+// Relocated by move
+class Movable {
+public:
+	std::string s;
+	Movable(int v = 0) : s(std::to_string(v)) {}
+	Movable(const Movable &) = default;
+	Movable(Movable &&) noexcept = default;
+	Movable &operator=(const Movable &) = default;
+	Movable &operator=(Movable &&) noexcept = default;
+};
+
+template<typename V>
+void Print(const char *label)
+{
+	const sjtu::vector_stats &s = V::stats();
+	std::cout << label
+			  << " allocations " << s.allocations
+			  << " reallocations " << s.reallocations
+			  << " copied " << s.copied
+			  << " moved " << s.moved
+			  << " bitwise " << s.bitwise
+			  << " shifted " << s.shifted
+			  << " peak " << s.peak_capacity
+			  << " released " << s.released
+			  << " slack " << s.released_slack << std::endl;
+}
+
+void TestGrowth()
+{
+	std::cout << "Testing growth counters..." << std::endl;
+	{
+		sjtu::vector<int> v;
+		for (int i = 0; i < 100; ++i) {
+			v.push_back(i);
+		}
+	}
+	Print<sjtu::vector<int>>("push_back");
+	std::cout << "bytes " << sjtu::vector<int>::stats().bytes_relocated << std::endl;
+
+	sjtu::vector<int>::stats().reset();
+	{
+		sjtu::vector<int> v;
+		v.reserve(100);
+		for (int i = 0; i < 100; ++i) {
+			v.push_back(i);
+		}
+	}
+	Print<sjtu::vector<int>>("reserved");
+}
+
+void TestRelocationKinds()
+{
+	std::cout << "Testing relocation kinds..." << std::endl;
+	{
+		sjtu::vector<Copyable> a;
+		sjtu::vector<Movable> b;
+		for (int i = 0; i < 10; ++i) {
+			a.push_back(Copyable(i));
+			b.push_back(Movable(i));
+		}
+	}
+	Print<sjtu::vector<Copyable>>("copyable");
+	Print<sjtu::vector<Movable>>("movable");
+}
+
+void TestShifts()
+{
+	std::cout << "Testing shift counters..." << std::endl;
+	sjtu::vector<long> v;
+	v.reserve(16);
+	for (long i = 0; i < 10; ++i) {
+		v.push_back(i);
+	}
+	v.insert(v.begin(), 42L);
+	v.erase(v.begin() + 5);
+	v.erase(v.begin(), v.begin() + 2);
+	Print<sjtu::vector<long>>("shifts");
+}
+
+void TestRegistry()
+{
+	std::cout << "Testing registry..." << std::endl;
+	int types = 0;
+	sjtu::for_each_vector_stats([&types](const sjtu::vector_stats &) {
+		++types;
+	});
+	std::cout << "types " << types << std::endl;
+
+	std::ostringstream os;
+	sjtu::dump_vector_stats(os);
+	std::cout << "dump " << (os.str().find("reallocations") != std::string::npos) << std::endl;
+
+	sjtu::reset_vector_stats();
+	Print<sjtu::vector<long>>("after reset");
+}
+
+int main()
+{
+	TestGrowth();
+	TestRelocationKinds();
+	TestShifts();
+	TestRegistry();
+	return 0;
+}
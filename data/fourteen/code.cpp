@@ -0,0 +1,141 @@
+#include "vector.hpp"
+
+#include <iostream>
+#include <iterator>
+#include <list>
+#include <sstream>
+#include <string>
+#include <vector>
+
+unsigned long long seed = 20240601;
+
+size_t Random(size_t n)
+{
+	seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+	return (seed >> 33) % n;
+}
+
+template<typename T>
+bool Same(const sjtu::vector<T> &a, const std::vector<T> &b)
+{
+	if (a.size() != b.size()) {
+		return false;
+	}
+	for (size_t i = 0; i < a.size(); ++i) {
+		if (!(a[i] == b[i])) {
+			return false;
+		}
+	}
+	return true;
+}
+
+template<typename T, typename Make>
+void Compare(const char *name, Make make)
+{
+	sjtu::vector<T> a;
+	std::vector<T> b;
+	bool ok = true;
+	for (int step = 0; step < 2000 && ok; ++step) {
+		size_t pos = Random(b.size() + 1);
+		switch (Random(6)) {
+		case 0: {
+			size_t count = Random(20);
+			T value = make(step);
+			a.insert(a.cbegin() + pos, count, value);
+			b.insert(b.begin() + pos, count, value);
+			break;
+		}
+		case 1: {
+			std::vector<T> src;
+			for (size_t i = Random(30); i > 0; --i) {
+				src.push_back(make(step + i));
+			}
+			a.insert(a.cbegin() + pos, src.begin(), src.end());
+			b.insert(b.begin() + pos, src.begin(), src.end());
+			break;
+		}
+		case 2: {
+			size_t last = pos + Random(b.size() - pos + 1);
+			a.erase(a.cbegin() + pos, a.cbegin() + last);
+			b.erase(b.begin() + pos, b.begin() + last);
+			break;
+		}
+		case 3: {
+			if (b.size() > 100) {
+				std::vector<T> src(b.begin(), b.begin() + Random(b.size()));
+				a.assign(src.begin(), src.end());
+				b.assign(src.begin(), src.end());
+			}
+			break;
+		}
+		case 4: {
+			if (!b.empty()) {
+				size_t index = Random(b.size());
+				a.insert(a.cbegin() + pos, 3, a[index]);
+				T value = b[index];
+				b.insert(b.begin() + pos, 3, value);
+			}
+			break;
+		}
+		default: {
+			T value = make(step);
+			a.push_back(value);
+			b.push_back(value);
+			break;
+		}
+		}
+		ok = Same(a, b);
+	}
+	std::cout << name << ": " << (ok ? "OK" : "MISMATCH") << std::endl;
+}
+
+int MakeInt(size_t i)
+{
+	return static_cast<int>(i * 31 % 1000);
+}
+
+std::string MakeString(size_t i)
+{
+	return std::string(i % 7 + 1, static_cast<char>('a' + i % 26));
+}
+
+void TestRandomized()
+{
+	std::cout << "Testing range operations against std::vector..." << std::endl;
+	Compare<int>("int", MakeInt);
+	Compare<std::string>("string", MakeString);
+}
+
+void TestRangeConstructor()
+{
+	std::cout << "Testing range constructor and input iterators..." << std::endl;
+	std::list<std::string> words;
+	words.push_back("one");
+	words.push_back("two");
+	words.push_back("three");
+	sjtu::vector<std::string> v(words.begin(), words.end());
+	std::istringstream in("4 5 6");
+	sjtu::vector<int> numbers((std::istream_iterator<int>(in)), std::istream_iterator<int>());
+	std::istringstream more("1 2 3");
+	numbers.insert(numbers.cbegin() + 1, std::istream_iterator<int>(more), std::istream_iterator<int>());
+	for (size_t i = 0; i < v.size(); ++i) {
+		std::cout << v[i] << " ";
+	}
+	for (size_t i = 0; i < numbers.size(); ++i) {
+		std::cout << numbers[i] << " ";
+	}
+	std::cout << std::endl;
+	sjtu::vector<int> filled;
+	filled.insert(filled.cend(), 5, 7);
+	sjtu::vector<int>::iterator it = filled.insert(filled.cbegin() + 2, numbers.begin(), numbers.end());
+	std::cout << (it - filled.begin()) << " " << filled.size() << " " << filled[2] << std::endl;
+	it = filled.erase(filled.cbegin() + 1, filled.cend() - 1);
+	std::cout << (it - filled.begin()) << " " << filled.size() << " " << *it << std::endl;
+}
+
+int main()
+{
+	TestRandomized();
+	TestRangeConstructor();
+	return 0;
+}
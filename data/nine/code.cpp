@@ -0,0 +1,88 @@
+#include "vector.hpp"
+
+#include <iostream>
+#include <string>
+
+template<typename Vec>
+void PrintGrowth(const char *name)
+{
+	Vec v;
+	size_t last = v.capacity();
+	std::cout << name << ":";
+	for (int i = 0; i < 100; ++i) {
+		v.push_back(i);
+		if (v.capacity() != last) {
+			last = v.capacity();
+			std::cout << " " << last;
+		}
+	}
+	std::cout << std::endl;
+}
+
+void TestGrowthPolicy()
+{
+	std::cout << "Testing growth policies..." << std::endl;
+	PrintGrowth<sjtu::vector<int>>("double");
+	PrintGrowth<sjtu::vector<int, std::allocator<int>, sjtu::half_growth>>("half");
+	PrintGrowth<sjtu::vector<int, std::allocator<int>, sjtu::chunk_growth<32>>>("chunk");
+}
+
+void TestReserve()
+{
+	std::cout << "Testing reserve and shrink_to_fit..." << std::endl;
+	sjtu::vector<std::string> v;
+	v.reserve(1000);
+	std::cout << v.size() << " " << v.capacity() << std::endl;
+	const std::string *first = nullptr;
+	for (int i = 0; i < 1000; ++i) {
+		v.push_back(std::to_string(i));
+		if (i == 0) {
+			first = &v[0];
+		}
+	}
+	std::cout << (first == &v[0] ? "no reallocation" : "reallocated") << " " << v.capacity() << std::endl;
+	v.reserve(10);
+	std::cout << v.capacity() << std::endl;
+	for (int i = 0; i < 990; ++i) {
+		v.pop_back();
+	}
+	v.shrink_to_fit();
+	std::cout << v.size() << " " << v.capacity() << " " << v.back() << std::endl;
+	v.clear();
+	v.shrink_to_fit();
+	std::cout << v.size() << " " << v.capacity() << std::endl;
+	v.push_back("again");
+	std::cout << v.size() << " " << v.front() << std::endl;
+}
+
+void TestResize()
+{
+	std::cout << "Testing resize..." << std::endl;
+	sjtu::vector<int> v;
+	v.resize(5);
+	for (size_t i = 0; i < v.size(); ++i) {
+		std::cout << v[i] << " ";
+	}
+	std::cout << std::endl;
+	v.resize(8, 7);
+	v.resize(3);
+	v.resize(6, 9);
+	for (size_t i = 0; i < v.size(); ++i) {
+		std::cout << v[i] << " ";
+	}
+	std::cout << std::endl;
+	sjtu::vector<std::string> s;
+	s.push_back("self");
+	s.resize(40, s[0]);
+	std::cout << s.size() << " " << s[39] << std::endl;
+	s.resize(0);
+	std::cout << s.size() << " " << s.empty() << std::endl;
+}
+
+int main()
+{
+	TestGrowthPolicy();
+	TestReserve();
+	TestResize();
+	return 0;
+}
@@ -0,0 +1,126 @@
+#include "class-bint.hpp"
+#include "parallel.hpp"
+#include "vector.hpp"
+
+#include <atomic>
+#include <iostream>
+#include <string>
+
+// Counts live objects; copying the one tagged to fail throws
+class Fragile {
+public:
+	static std::atomic<int> live;
+	static int fail_at;
+	int id;
+	Fragile(int id) : id(id) {
+		++live;
+	}
+	Fragile(const Fragile &other) : id(other.id) {
+		if (id == fail_at) {
+			throw std::runtime_error("copy failed");
+		}
+		++live;
+	}
+	~Fragile() {
+		--live;
+	}
+};
+std::atomic<int> Fragile::live(0);
+int Fragile::fail_at = -1;
+
+void TestCopy(sjtu::parallel_policy policy)
+{
+	std::cout << "Testing parallel copy..." << std::endl;
+	sjtu::vector<std::string> v;
+	for (int i = 0; i < 20000; ++i) {
+		v.push_back(std::to_string(i));
+	}
+	sjtu::vector<std::string> w = sjtu::parallel_copy(policy, v);
+	bool same = w.size() == v.size();
+	for (size_t i = 0; same && i < v.size(); ++i) {
+		same = w[i] == v[i];
+	}
+	std::cout << "copy " << w.size() << " " << same << std::endl;
+
+	sjtu::vector<int> a;
+	for (int i = 0; i < 50000; ++i) {
+		a.push_back(i);
+	}
+	sjtu::vector<int> b;
+	b.push_back(1);
+	sjtu::parallel_assign(policy, b, a);
+	std::cout << "assign " << b.size() << " " << b[49999] << std::endl;
+
+	sjtu::parallel_clear(policy, w);
+	std::cout << "clear " << w.size() << " " << (w.capacity() >= 20000) << std::endl;
+	sjtu::parallel_fill(policy, w, 5000, std::string("x"));
+	std::cout << "fill " << w.size() << " " << w[4999] << std::endl;
+}
+
+void TestForEachTransform(sjtu::parallel_policy policy)
+{
+	std::cout << "Testing for_each and transform..." << std::endl;
+	sjtu::vector<long long> v;
+	for (int i = 0; i < 40000; ++i) {
+		v.push_back(i);
+	}
+	sjtu::parallel_for_each(policy, v, [](long long &x) {
+		x *= 2;
+	});
+	std::atomic<long long> sum(0);
+	const sjtu::vector<long long> &cv = v;
+	sjtu::parallel_for_each(policy, cv, [&sum](const long long &x) {
+		sum += x;
+	});
+	std::cout << "sum " << sum << std::endl;
+
+	sjtu::vector<Util::Bint> squares;
+	sjtu::parallel_transform(policy, v, squares, [](long long x) {
+		return Util::Bint(x) * Util::Bint(x);
+	});
+	std::cout << "transform " << squares.size() << " " << squares[39999] << std::endl;
+}
+
+void TestUnwind(sjtu::parallel_policy policy)
+{
+	std::cout << "Testing unwinding..." << std::endl;
+	{
+		sjtu::vector<Fragile> v;
+		for (int i = 0; i < 30000; ++i) {
+			v.push_back(Fragile(i));
+		}
+		Fragile::fail_at = 17777;
+		try {
+			sjtu::vector<Fragile> w = sjtu::parallel_copy(policy, v);
+			std::cout << "copied" << std::endl;
+		} catch (std::runtime_error &e) {
+			std::cout << e.what() << " live " << Fragile::live << std::endl;
+		}
+		sjtu::vector<Fragile> out;
+		out.push_back(Fragile(-2));
+		try {
+			sjtu::parallel_transform(policy, v, out, [](const Fragile &f) {
+				return f;
+			});
+		} catch (std::runtime_error &e) {
+			std::cout << e.what() << " kept " << out.size() << " live " << Fragile::live << std::endl;
+		}
+		Fragile::fail_at = -1;
+	}
+	std::cout << "live " << Fragile::live << std::endl;
+}
+
+int main()
+{
+	sjtu::thread_pool pool(3);
+	sjtu::parallel_policy parallel{1024, &pool};
+	std::cout << "threads " << pool.concurrency() << std::endl;
+	TestCopy(parallel);
+	TestForEachTransform(parallel);
+	TestUnwind(parallel);
+	std::cout << "Sequential" << std::endl;
+	TestCopy(sjtu::seq);
+	TestForEachTransform(sjtu::seq);
+	TestUnwind(sjtu::seq);
+	return 0;
+}
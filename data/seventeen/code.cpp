@@ -0,0 +1,109 @@
+#include "mapped_vector.hpp"
+
+#include <cstdio>
+#include <fcntl.h>
+#include <iostream>
+#include <string>
+#include <unistd.h>
+
+struct Point {
+	int x, y;
+};
+
+const std::string path = "/tmp/sjtu_mapped_vector_seventeen.bin";
+
+void TestBuildAndReopen()
+{
+	std::cout << "Testing build and reopen..." << std::endl;
+	std::remove(path.c_str());
+	{
+		sjtu::mapped_vector<long long> v(path);
+		std::cout << "new size " << v.size() << std::endl;
+		for (long long i = 0; i < 1000000; ++i) {
+			v.push_back(i * 3);
+		}
+		v.sync();
+	}
+	{
+		sjtu::mapped_vector<long long> v(path);
+		long long sum = 0;
+		for (long long x : v) {
+			sum += x;
+		}
+		std::cout << "reopened size " << v.size() << " sum " << sum << std::endl;
+		v.shrink_to_fit();
+		std::cout << "capacity " << v.capacity() << std::endl;
+		v.resize(10);
+	}
+	{
+		sjtu::mapped_vector<long long> v(path);
+		std::cout << "resized " << v.size() << " back " << v.back() << std::endl;
+	}
+}
+
+void TestEditing()
+{
+	std::cout << "Testing editing..." << std::endl;
+	std::remove(path.c_str());
+	sjtu::mapped_vector<Point> v(path);
+	for (int i = 0; i < 10; ++i) {
+		v.push_back(Point{i, -i});
+	}
+	v.insert(v.begin(), Point{100, 100});
+	v.insert(v.begin() + 3, 2, Point{7, 7});
+	v.erase(v.begin() + 5);
+	v.erase(v.end() - 3, v.end());
+	v.push_back(v[0]);
+	v.emplace_back(Point{1, 2});
+	v.pop_back();
+	for (size_t i = 0; i < v.size(); ++i) {
+		std::cout << v[i].x << "," << v[i].y << " ";
+	}
+	std::cout << std::endl;
+
+	Point more[] = {{5, 5}, {6, 6}};
+	v.assign(more, more + 2);
+	std::cout << v.size() << " " << v.front().x << " " << v.back().y << std::endl;
+
+	sjtu::mapped_vector<Point> w(std::move(v));
+	std::cout << "moved " << w.size() << " " << v.size() << std::endl;
+
+	try {
+		w.at(2);
+	} catch (sjtu::index_out_of_bound &) {
+		std::cout << "index_out_of_bound" << std::endl;
+	}
+}
+
+void TestBadFile()
+{
+	std::cout << "Testing wrong element type..." << std::endl;
+	try {
+		sjtu::mapped_vector<char> v(path);
+		std::cout << "opened" << std::endl;
+	} catch (sjtu::runtime_error &) {
+		std::cout << "runtime_error" << std::endl;
+	}
+
+	// A failed open gives its descriptor back, so the next one is reused
+	int probe = ::open("/dev/null", O_RDONLY);
+	::close(probe);
+	for (int i = 0; i < 3; ++i) {
+		try {
+			sjtu::mapped_vector<long long> v(path);
+		} catch (sjtu::runtime_error &) {
+		}
+	}
+	int again = ::open("/dev/null", O_RDONLY);
+	::close(again);
+	std::cout << "descriptors leaked " << (again - probe) << std::endl;
+	std::remove(path.c_str());
+}
+
+int main()
+{
+	TestBuildAndReopen();
+	TestEditing();
+	TestBadFile();
+	return 0;
+}
@@ -0,0 +1,176 @@
+#include "vector.hpp"
+
+#include <iostream>
+#include <string>
+
+// Counts the special member calls the vector makes
+class Tracked {
+public:
+	static int constructed;
+	static int assigned;
+	static int destroyed;
+	std::string s;
+	Tracked(int v = 0) : s(std::to_string(v)) {
+		++constructed;
+	}
+	Tracked(const Tracked &other) : s(other.s) {
+		++constructed;
+	}
+	Tracked &operator=(const Tracked &other) {
+		s = other.s;
+		++assigned;
+		return *this;
+	}
+	~Tracked() {
+		++destroyed;
+	}
+	static void Reset() {
+		constructed = assigned = destroyed = 0;
+	}
+	static void Print(const char *label) {
+		std::cout << label << " constructed " << constructed << " assigned " << assigned
+				  << " destroyed " << destroyed << std::endl;
+	}
+};
+int Tracked::constructed = 0;
+int Tracked::assigned = 0;
+int Tracked::destroyed = 0;
+
+template<typename T>
+class CountingAllocator {
+public:
+	using value_type = T;
+	static int allocations;
+	CountingAllocator() {}
+	template<typename U>
+	CountingAllocator(const CountingAllocator<U> &) {}
+	T *allocate(size_t n) {
+		++allocations;
+		return std::allocator<T>().allocate(n);
+	}
+	void deallocate(T *p, size_t n) {
+		std::allocator<T>().deallocate(p, n);
+	}
+	bool operator==(const CountingAllocator &) const {
+		return true;
+	}
+	bool operator!=(const CountingAllocator &) const {
+		return false;
+	}
+};
+template<typename T>
+int CountingAllocator<T>::allocations = 0;
+
+template<typename V>
+void PrintVector(const V &v)
+{
+	for (size_t i = 0; i < v.size(); ++i) {
+		std::cout << v[i] << " ";
+	}
+	std::cout << std::endl;
+}
+
+void TestReuse()
+{
+	std::cout << "Testing capacity reuse..." << std::endl;
+	typedef sjtu::vector<int, CountingAllocator<int>> vec;
+	vec a, b;
+	for (int i = 0; i < 100; ++i) {
+		a.push_back(i);
+		b.push_back(-i);
+	}
+	const int *buffer = b.data();
+	CountingAllocator<int>::allocations = 0;
+	for (int tick = 0; tick < 1000; ++tick) {
+		b = a;
+	}
+	std::cout << "allocations " << CountingAllocator<int>::allocations << std::endl;
+	std::cout << "same buffer " << (b.data() == buffer) << std::endl;
+	std::cout << "size " << b.size() << " last " << b.back() << std::endl;
+
+	vec small;
+	small.push_back(1);
+	b = small;
+	std::cout << "shrunk size " << b.size() << " capacity kept " << (b.capacity() >= 100) << std::endl;
+
+	CountingAllocator<int>::allocations = 0;
+	b.assign(a);
+	std::cout << "assign allocations " << CountingAllocator<int>::allocations << " size " << b.size() << std::endl;
+	std::cout << "copy equal " << (b[42] == 42) << std::endl;
+}
+
+void TestElementOps()
+{
+	std::cout << "Testing element operations..." << std::endl;
+	sjtu::vector<Tracked> a, b;
+	for (int i = 0; i < 10; ++i) {
+		a.push_back(Tracked(i));
+	}
+	b.reserve(20);
+	for (int i = 0; i < 4; ++i) {
+		b.push_back(Tracked(i));
+	}
+	Tracked::Reset();
+	b = a;
+	Tracked::Print("grow in place");
+	Tracked::Reset();
+	sjtu::vector<Tracked> c;
+	c.push_back(Tracked(7));
+	c.push_back(Tracked(8));
+	Tracked::Reset();
+	b = c;
+	Tracked::Print("shrink in place");
+	std::cout << b.size() << " " << b[0].s << " " << b[1].s << std::endl;
+	Tracked::Reset();
+	sjtu::vector<Tracked> d;
+	d = a;
+	Tracked::Print("empty target");
+}
+
+void TestSelfAssign()
+{
+	std::cout << "Testing self assignment..." << std::endl;
+	sjtu::vector<Tracked> v;
+	for (int i = 0; i < 5; ++i) {
+		v.push_back(Tracked(i));
+	}
+	const Tracked *buffer = v.data();
+	Tracked::Reset();
+	sjtu::vector<Tracked> &alias = v;
+	v = alias;
+	v.assign(alias);
+	Tracked::Print("self");
+	std::cout << "same buffer " << (v.data() == buffer) << " size " << v.size() << std::endl;
+}
+
+void TestAssignCount()
+{
+	std::cout << "Testing assign count..." << std::endl;
+	sjtu::vector<int> v;
+	for (int i = 0; i < 8; ++i) {
+		v.push_back(i);
+	}
+	v.assign(3, v[5]);
+	PrintVector(v);
+	v.assign(6, 9);
+	PrintVector(v);
+	v.assign(20, v[0]);
+	std::cout << v.size() << " " << v[19] << std::endl;
+	v.assign(0, 1);
+	std::cout << "empty " << v.empty() << std::endl;
+
+	sjtu::vector<std::string> s;
+	s.push_back("a");
+	s.push_back("b");
+	s.assign(4, s[1]);
+	PrintVector(s);
+}
+
+int main()
+{
+	TestReuse();
+	TestElementOps();
+	TestSelfAssign();
+	TestAssignCount();
+	return 0;
+}
@@ -0,0 +1,121 @@
+#include "vector.hpp"
+#include "allocator.hpp"
+
+#include <iostream>
+#include <string>
+
+// Allocator that counts allocations, to check the vector goes through it
+template<typename T>
+class CountingAllocator {
+public:
+	using value_type = T;
+	static int allocations;
+	static int deallocations;
+	CountingAllocator() {}
+	template<typename U>
+	CountingAllocator(const CountingAllocator<U> &) {}
+	T *allocate(size_t n) {
+		++allocations;
+		return std::allocator<T>().allocate(n);
+	}
+	void deallocate(T *p, size_t n) {
+		++deallocations;
+		std::allocator<T>().deallocate(p, n);
+	}
+	bool operator==(const CountingAllocator &) const {
+		return true;
+	}
+	bool operator!=(const CountingAllocator &) const {
+		return false;
+	}
+};
+template<typename T>
+int CountingAllocator<T>::allocations = 0;
+template<typename T>
+int CountingAllocator<T>::deallocations = 0;
+
+void TestCustomAllocator()
+{
+	std::cout << "Testing custom allocator..." << std::endl;
+	{
+		sjtu::vector<std::string, CountingAllocator<std::string>> v;
+		for (int i = 0; i < 100; ++i) {
+			v.push_back(std::to_string(i));
+		}
+		sjtu::vector<std::string, CountingAllocator<std::string>> w(v);
+		w = v;
+		w.insert(w.begin(), "front");
+		std::cout << w.size() << " " << w.front() << " " << w.back() << std::endl;
+	}
+	std::cout << CountingAllocator<std::string>::allocations << " "
+	          << CountingAllocator<std::string>::deallocations << std::endl;
+}
+
+void TestArena()
+{
+	std::cout << "Testing arena allocator..." << std::endl;
+	sjtu::arena arena(4096);
+	for (int round = 0; round < 3; ++round) {
+		sjtu::arena_allocator<int> alloc(arena);
+		long long sum = 0;
+		for (int k = 0; k < 100; ++k) {
+			sjtu::vector<int, sjtu::arena_allocator<int>> v(alloc);
+			for (int i = 0; i < 7; ++i) {
+				v.push_back(k * i);
+			}
+			for (size_t i = 0; i < v.size(); ++i) {
+				sum += v[i];
+			}
+		}
+		sjtu::vector<long long, sjtu::arena_allocator<long long>> big(alloc);
+		for (int i = 0; i < 10000; ++i) {
+			big.push_back(i);
+		}
+		std::cout << sum << " " << big.back() << std::endl;
+		arena.reset();
+	}
+	sjtu::arena_allocator<int> alloc(arena);
+	int *p = alloc.allocate(1);
+	std::cout << (arena.capacity() > 0 ? "block kept" : "no block") << std::endl;
+	alloc.deallocate(p, 1);
+}
+
+void TestPool()
+{
+	std::cout << "Testing pool allocator..." << std::endl;
+	sjtu::pool pool;
+	sjtu::pool_allocator<std::string> alloc(pool);
+	sjtu::vector<sjtu::vector<std::string, sjtu::pool_allocator<std::string>>> table;
+	for (int i = 0; i < 50; ++i) {
+		table.push_back(sjtu::vector<std::string, sjtu::pool_allocator<std::string>>(alloc));
+		for (int j = 0; j <= i % 8; ++j) {
+			table[i].push_back(std::string(j + 1, 'a' + i % 26));
+		}
+	}
+	for (int i = 0; i < 50; i += 7) {
+		std::cout << table[i].size() << ":" << table[i].back() << " ";
+	}
+	std::cout << std::endl;
+	sjtu::vector<std::string, sjtu::pool_allocator<std::string>> moved(std::move(table[8]));
+	table[9] = std::move(moved);
+	std::cout << table[8].size() << " " << table[9].size() << " " << table[9][0] << std::endl;
+	sjtu::pool_allocator<int> ints(pool);
+	int *a = ints.allocate(3);
+	ints.deallocate(a, 3);
+	int *b = ints.allocate(4);
+	std::cout << (a == b ? "slot reused" : "slot not reused") << std::endl;
+	ints.deallocate(b, 4);
+	int *huge = ints.allocate(100000);
+	huge[99999] = 1;
+	ints.deallocate(huge, 100000);
+	table.clear();
+	pool.reset();
+}
+
+int main()
+{
+	TestCustomAllocator();
+	TestArena();
+	TestPool();
+	return 0;
+}
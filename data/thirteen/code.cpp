@@ -0,0 +1,80 @@
+#include "vector.hpp"
+#include "small_vector.hpp"
+
+#include <algorithm>
+#include <iostream>
+#include <numeric>
+#include <string>
+
+struct Point {
+	int x;
+	int y;
+};
+
+template<typename It>
+void Print(It first, It last)
+{
+	for (; first != last; ++first) {
+		std::cout << *first << " ";
+	}
+	std::cout << std::endl;
+}
+
+void TestAlgorithms()
+{
+	std::cout << "Testing std algorithms..." << std::endl;
+	sjtu::vector<int> v;
+	for (int i = 0; i < 20; ++i) {
+		v.push_back(i * 7 % 20);
+	}
+	std::sort(v.begin(), v.end());
+	Print(v.cbegin(), v.cend());
+	sjtu::vector<int>::iterator it = std::lower_bound(v.begin(), v.end(), 13);
+	std::cout << *it << " at " << (it - v.begin()) << std::endl;
+	std::cout << std::binary_search(v.cbegin(), v.cend(), 21) << std::endl;
+	std::reverse(v.begin(), v.end());
+	int out[20];
+	std::copy(v.cbegin(), v.cend(), out);
+	std::cout << out[0] << " " << std::accumulate(out, out + 20, 0) << std::endl;
+	std::nth_element(v.begin(), v.begin() + 10, v.end());
+	std::cout << v[10] << std::endl;
+
+	sjtu::small_vector<std::string, 4> s;
+	s.push_back("pear");
+	s.push_back("apple");
+	s.push_back("fig");
+	s.push_back("kiwi");
+	s.push_back("banana");
+	std::sort(s.begin(), s.end());
+	Print(s.begin(), s.end());
+}
+
+void TestRandomAccess()
+{
+	std::cout << "Testing random access operations..." << std::endl;
+	sjtu::vector<int> v;
+	for (int i = 0; i < 10; ++i) {
+		v.push_back(i);
+	}
+	sjtu::vector<int>::iterator it = v.begin() + 3;
+	sjtu::vector<int>::const_iterator cit = it;
+	std::cout << it[2] << " " << cit[-1] << " " << *(2 + it) << std::endl;
+	std::cout << (cit == it) << (it < v.end()) << (v.end() > cit) << (it <= cit) << (it >= v.begin()) << std::endl;
+	std::cout << (v.cend() - it) << " " << (it - v.cbegin()) << std::endl;
+	const sjtu::vector<int> &cv = v;
+	Print(cv.rbegin(), cv.rend());
+	Print(v.rbegin() + 2, v.rend() - 5);
+
+	sjtu::vector<Point> points;
+	points.push_back(Point{1, 2});
+	points.push_back(Point{3, 4});
+	points.begin()->x = 5;
+	std::cout << points.begin()->x << " " << (points.cend() - 1)->y << std::endl;
+}
+
+int main()
+{
+	TestAlgorithms();
+	TestRandomAccess();
+	return 0;
+}
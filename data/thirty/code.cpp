@@ -0,0 +1,179 @@
+#include "flat_map.hpp"
+#include "flat_set.hpp"
+
+#include <functional>
+#include <iostream>
+#include <map>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
+template<typename Map, typename Ref>
+bool Same(const Map &m, const Ref &ref)
+{
+	if (m.size() != ref.size()) {
+		return false;
+	}
+	typename Ref::const_iterator r = ref.begin();
+	for (typename Map::const_iterator it = m.begin(); it != m.end(); ++it, ++r) {
+		if (it->first != r->first || it->second != r->second) {
+			return false;
+		}
+	}
+	return true;
+}
+
+void TestAgainstMap()
+{
+	std::cout << "Testing flat_map against std::map..." << std::endl;
+	std::mt19937 gen(28);
+	sjtu::flat_map<int, std::string> m;
+	std::map<int, std::string> ref;
+	bool same = true;
+	size_t hits = 0;
+	for (int step = 0; step < 20000; ++step) {
+		int k = static_cast<int>(gen() % 3000);
+		std::string v = std::to_string(step);
+		switch (gen() % 8) {
+		case 0: {
+			bool inserted = m.insert(sjtu::pair<int, std::string>(k, v)).second;
+			same = same && inserted == ref.insert(std::make_pair(k, v)).second;
+			break;
+		}
+		case 1:
+			same = same && m.erase(k) == ref.erase(k);
+			break;
+		case 2:
+			m[k] = v;
+			ref[k] = v;
+			break;
+		case 3: {
+			bool found = m.find(k) != m.end();
+			same = same && found == (ref.find(k) != ref.end()) && m.contains(k) == found;
+			hits += found;
+			break;
+		}
+		case 4: {
+			auto lo = m.lower_bound(k);
+			auto hi = m.upper_bound(k);
+			auto rlo = ref.lower_bound(k);
+			auto rhi = ref.upper_bound(k);
+			same = same && (lo == m.end()) == (rlo == ref.end()) && (lo == m.end() || lo->first == rlo->first);
+			same = same && (hi == m.end()) == (rhi == ref.end()) && (hi == m.end() || hi->first == rhi->first);
+			break;
+		}
+		case 5: {
+			std::vector<sjtu::pair<int, std::string>> batch;
+			size_t n = gen() % 50;
+			for (size_t i = 0; i < n; ++i) {
+				int key = gen() % 4 == 0 ? k + static_cast<int>(gen() % 3000) : static_cast<int>(gen() % 3000);
+				batch.push_back(sjtu::pair<int, std::string>(key, v + "." + std::to_string(i)));
+				ref.insert(std::make_pair(batch.back().first, batch.back().second));
+			}
+			m.insert_range(batch.begin(), batch.end());
+			break;
+		}
+		case 6:
+			same = same && m.insert_or_assign(k, v).second == (ref.find(k) == ref.end());
+			ref[k] = v;
+			break;
+		default:
+			same = same && m.try_emplace(k, 3, 'x').second == ref.emplace(k, std::string(3, 'x')).second;
+			break;
+		}
+		if (step % 1000 == 0) {
+			same = same && Same(m, ref);
+		}
+	}
+	std::cout << "same " << (same && Same(m, ref)) << " size " << m.size() << " hits " << hits << std::endl;
+}
+
+void TestBulk()
+{
+	std::cout << "Testing bulk construction..." << std::endl;
+	std::vector<sjtu::pair<int, int>> sorted;
+	for (int i = 0; i < 100000; ++i) {
+		sorted.push_back(sjtu::pair<int, int>(i * 3, i));
+	}
+	sjtu::flat_map<int, int> m(sjtu::sorted_unique, sorted.begin(), sorted.end());
+	std::cout << m.size() << " " << m.at(2997) << " " << m.count(2998) << " " << (m.lower_bound(2998)->first) << std::endl;
+
+	sjtu::vector<sjtu::pair<int, int>> storage;
+	storage.push_back(sjtu::pair<int, int>(1, 10));
+	storage.push_back(sjtu::pair<int, int>(2, 20));
+	sjtu::flat_map<int, int> adopted(sjtu::sorted_unique, std::move(storage));
+	std::cout << adopted.size() << " " << adopted[2] << " " << storage.size() << std::endl;
+
+	std::vector<sjtu::pair<int, int>> unsorted = {{3, 0}, {1, 0}, {2, 0}};
+	try {
+		sjtu::flat_map<int, int> bad(sjtu::sorted_unique, unsorted.begin(), unsorted.end());
+	} catch (sjtu::runtime_error &e) {
+		std::cout << e.what() << std::endl;
+	}
+	try {
+		m.at(1);
+	} catch (sjtu::index_out_of_bound &e) {
+		std::cout << e.what() << std::endl;
+	}
+
+	// Existing keys win over new ones, and the first of equal new keys wins
+	sjtu::flat_map<int, std::string> names;
+	names[5] = "old";
+	std::vector<sjtu::pair<int, std::string>> batch = {{7, "first"}, {5, "new"}, {1, "one"}, {7, "second"}, {9, "nine"}};
+	names.insert_range(batch.begin(), batch.end());
+	for (auto it = names.begin(); it != names.end(); ++it) {
+		std::cout << it->first << "=" << it->second << " ";
+	}
+	std::cout << std::endl;
+
+	sjtu::flat_map<int, std::string> from_range(batch.begin(), batch.end());
+	std::cout << from_range.size() << " " << from_range[7] << " " << (from_range == names) << std::endl;
+}
+
+void TestSet()
+{
+	std::cout << "Testing flat_set..." << std::endl;
+	std::mt19937 gen(82);
+	sjtu::flat_set<int, std::greater<int>> s;
+	std::set<int, std::greater<int>> ref;
+	std::vector<int> keys;
+	for (int i = 0; i < 5000; ++i) {
+		keys.push_back(static_cast<int>(gen() % 10000));
+	}
+	s.insert_range(keys.begin(), keys.begin() + 2500);
+	ref.insert(keys.begin(), keys.begin() + 2500);
+	for (size_t i = 2500; i < keys.size(); ++i) {
+		s.insert(keys[i]);
+		ref.insert(keys[i]);
+	}
+	for (int i = 0; i < 1000; ++i) {
+		int k = static_cast<int>(gen() % 10000);
+		s.erase(k);
+		ref.erase(k);
+	}
+	bool same = s.size() == ref.size();
+	auto r = ref.begin();
+	for (auto it = s.begin(); same && it != s.end(); ++it, ++r) {
+		same = *it == *r;
+	}
+	std::cout << "same " << same << " size " << s.size() << " first " << *s.begin() << " lower_bound(5000) "
+			  << *s.lower_bound(5000) << " " << *ref.lower_bound(5000) << std::endl;
+
+	sjtu::flat_set<std::string> words;
+	std::vector<std::string> text = {"pear", "apple", "fig", "apple", "kiwi", "fig"};
+	words.insert_range(text.begin(), text.end());
+	words.emplace(3, 'z');
+	for (auto it = words.begin(); it != words.end(); ++it) {
+		std::cout << *it << " ";
+	}
+	std::cout << words.count("kiwi") << words.count("plum") << std::endl;
+}
+
+int main()
+{
+	TestAgainstMap();
+	TestBulk();
+	TestSet();
+	return 0;
+}
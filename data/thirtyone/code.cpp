@@ -0,0 +1,364 @@
+#include "vector.hpp"
+#include "algorithm.hpp"
+#include "class-bint.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+template<typename T>
+bool Same(const sjtu::vector<T> &a, const std::vector<T> &b)
+{
+	return a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin());
+}
+
+template<typename T, typename Make>
+sjtu::vector<T> Random(size_t n, unsigned seed, Make make)
+{
+	std::mt19937_64 gen(seed);
+	sjtu::vector<T> v;
+	for (size_t i = 0; i < n; ++i) {
+		v.push_back(make(gen));
+	}
+	return v;
+}
+
+template<typename T, typename Compare = std::less<T>>
+bool SortsLike(sjtu::parallel_policy policy, sjtu::vector<T> v, Compare comp = Compare())
+{
+	std::vector<T> expected(v.begin(), v.end());
+	std::sort(expected.begin(), expected.end(), comp);
+	sjtu::sort(policy, v, comp);
+	return Same(v, expected);
+}
+
+void TestSort(sjtu::parallel_policy policy)
+{
+	std::cout << "Testing sort..." << std::endl;
+	auto wide = [](std::mt19937_64 &gen) {
+		return static_cast<long long>(gen());
+	};
+	auto narrow = [](std::mt19937_64 &gen) {
+		return static_cast<long long>(gen() % 1000) - 500;
+	};
+	// Below and above the radix threshold, and across many chunks
+	const size_t sizes[] = {0, 1, 100, 5000, 100000};
+	for (size_t n : sizes) {
+		std::cout << n << " " << SortsLike(policy, Random<long long>(n, 1, wide))
+				  << SortsLike(policy, Random<long long>(n, 2, narrow))
+				  << SortsLike(policy, Random<long long>(n, 3, wide), std::greater<long long>()) << std::endl;
+	}
+	std::cout << SortsLike(policy, Random<int>(70000, 4, [](std::mt19937_64 &gen) {
+		return static_cast<int>(gen());
+	})) << SortsLike(policy, Random<unsigned>(70000, 5, [](std::mt19937_64 &gen) {
+		return static_cast<unsigned>(gen());
+	})) << SortsLike(policy, Random<signed char>(70000, 6, [](std::mt19937_64 &gen) {
+		return static_cast<signed char>(gen());
+	})) << SortsLike(policy, Random<unsigned long long>(70000, 7, [](std::mt19937_64 &gen) {
+		return gen() >> (gen() % 64);
+	})) << SortsLike(policy, Random<double>(70000, 8, [](std::mt19937_64 &gen) {
+		return static_cast<double>(static_cast<long long>(gen())) / 3;
+	})) << std::endl;
+
+	sjtu::vector<long long> v = Random<long long>(50000, 9, wide);
+	sjtu::vector<long long> scratch;
+	std::vector<long long> expected(v.begin(), v.end());
+	std::sort(expected.begin(), expected.end());
+	sjtu::radix_sort(policy, v, scratch);
+	const long long* buffer = scratch.data();
+	bool same = Same(v, expected);
+	sjtu::radix_sort(policy, v, scratch);
+	std::cout << same << Same(v, expected) << (scratch.data() == buffer) << std::endl;
+
+	// Already sorted, reversed and all equal
+	sjtu::vector<long long> up;
+	sjtu::vector<long long> equal;
+	for (long long i = 0; i < 30000; ++i) {
+		up.push_back(i);
+		equal.push_back(7);
+	}
+	sjtu::vector<long long> down = up;
+	std::reverse(down.begin(), down.end());
+	std::cout << SortsLike(policy, up) << SortsLike(policy, down) << SortsLike(policy, equal)
+			  << SortsLike(policy, down, std::greater<long long>()) << std::endl;
+}
+
+struct Keyed {
+	int key;
+	int order;
+};
+
+bool ByKey(const Keyed &a, const Keyed &b)
+{
+	return a.key < b.key;
+}
+
+void TestStableSort(sjtu::parallel_policy policy)
+{
+	std::cout << "Testing stable_sort..." << std::endl;
+	sjtu::vector<Keyed> scratch;
+	const size_t sizes[] = {0, 1, 31, 33, 1000, 60000};
+	for (size_t n : sizes) {
+		std::mt19937 gen(static_cast<unsigned>(n));
+		sjtu::vector<Keyed> v;
+		for (size_t i = 0; i < n; ++i) {
+			v.push_back(Keyed{static_cast<int>(gen() % 100), static_cast<int>(i)});
+		}
+		std::vector<Keyed> expected(v.begin(), v.end());
+		std::stable_sort(expected.begin(), expected.end(), ByKey);
+		sjtu::stable_sort(policy, v, scratch, ByKey);
+		bool same = true;
+		for (size_t i = 0; i < n; ++i) {
+			same = same && v[i].key == expected[i].key && v[i].order == expected[i].order;
+		}
+		std::cout << n << " " << same << std::endl;
+	}
+	// The largest size was last, so the buffer is big enough from now on
+	const Keyed* buffer = scratch.data();
+	sjtu::vector<Keyed> again;
+	for (int i = 0; i < 60000; ++i) {
+		again.push_back(Keyed{(i * 7919) % 13, i});
+	}
+	sjtu::stable_sort(policy, again, scratch, ByKey);
+	bool ordered = true;
+	for (size_t i = 1; i < again.size(); ++i) {
+		ordered = ordered && (again[i - 1].key < again[i].key ||
+			(again[i - 1].key == again[i].key && again[i - 1].order < again[i].order));
+	}
+	std::cout << ordered << (scratch.data() == buffer) << std::endl;
+
+	sjtu::vector<long long> w = Random<long long>(40000, 10, [](std::mt19937_64 &gen) {
+		return static_cast<long long>(gen() % 50);
+	});
+	std::vector<long long> expected(w.begin(), w.end());
+	std::sort(expected.begin(), expected.end());
+	sjtu::stable_sort(policy, w);
+	std::cout << Same(w, expected) << std::endl;
+}
+
+void TestMerge(sjtu::parallel_policy policy)
+{
+	std::cout << "Testing merge..." << std::endl;
+	const size_t sizes[][2] = {{0, 0}, {0, 10}, {10, 0}, {3000, 5}, {20000, 30000}};
+	for (const auto &size : sizes) {
+		sjtu::vector<long long> a = Random<long long>(size[0], 11, [](std::mt19937_64 &gen) {
+			return static_cast<long long>(gen() % 1000);
+		});
+		sjtu::vector<long long> b = Random<long long>(size[1], 12, [](std::mt19937_64 &gen) {
+			return static_cast<long long>(gen() % 1000);
+		});
+		sjtu::sort(policy, a);
+		sjtu::sort(policy, b);
+		sjtu::vector<long long> out;
+		out.push_back(-1);
+		sjtu::merge(policy, a, b, out);
+		std::vector<long long> expected(1, -1);
+		std::merge(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(expected));
+		std::cout << size[0] << "+" << size[1] << " " << Same(out, expected) << std::endl;
+	}
+
+	// Of equal keys, those of the first range come first
+	sjtu::vector<Keyed> a;
+	sjtu::vector<Keyed> b;
+	for (int i = 0; i < 20000; ++i) {
+		a.push_back(Keyed{i / 4, i});
+		b.push_back(Keyed{i / 3, -i});
+	}
+	sjtu::vector<Keyed> out;
+	sjtu::merge(policy, a, b, out, ByKey);
+	std::vector<Keyed> expected;
+	std::merge(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(expected), ByKey);
+	bool same = out.size() == expected.size();
+	for (size_t i = 0; same && i < out.size(); ++i) {
+		same = out[i].key == expected[i].key && out[i].order == expected[i].order;
+	}
+	std::cout << same << std::endl;
+}
+
+void TestSearch(sjtu::parallel_policy policy)
+{
+	std::cout << "Testing find, count and min_max..." << std::endl;
+	sjtu::vector<long long> v;
+	for (long long i = 0; i < 100000; ++i) {
+		v.push_back((i * 37) % 1001 - 500);
+	}
+	const sjtu::vector<long long> &cv = v;
+	std::cout << (sjtu::find(policy, v, 123LL) - v.begin()) << " " << (sjtu::find(policy, cv, 499LL) - cv.cbegin())
+			  << " " << (sjtu::find(policy, v, 501LL) == v.end()) << std::endl;
+	v[99999] = 1000;
+	v[70000] = 1000;
+	std::cout << (sjtu::find(policy, v, 1000LL) - v.begin()) << " " << sjtu::count(policy, v, 7LL) << " "
+			  << sjtu::count(policy, v, 1000LL) << " " << sjtu::count(policy, v, 2000LL) << std::endl;
+	sjtu::find(policy, v, 1000LL)[0] = -1000;
+	sjtu::pair<long long, long long> range = sjtu::min_max(policy, v);
+	std::cout << range.first << " " << range.second << std::endl;
+
+	sjtu::vector<double> d;
+	for (int i = 0; i < 50000; ++i) {
+		d.push_back(std::sin(i * 0.001) * 100);
+	}
+	d.push_back(NAN);
+	sjtu::pair<double, double> dr = sjtu::min_max(policy, d);
+	std::cout << dr.first << " " << dr.second << " " << sjtu::count(policy, d, 0.0) << " "
+			  << (sjtu::find(policy, d, d[31415]) - d.begin()) << std::endl;
+
+	sjtu::vector<unsigned char> bytes;
+	for (int i = 0; i < 70000; ++i) {
+		bytes.push_back(static_cast<unsigned char>(i % 200 + 20));
+	}
+	sjtu::pair<unsigned char, unsigned char> br = sjtu::min_max(policy, bytes);
+	std::cout << int(br.first) << " " << int(br.second) << " " << sjtu::count(policy, bytes, (unsigned char)(20))
+			  << std::endl;
+
+	sjtu::vector<int> empty;
+	try {
+		sjtu::min_max(policy, empty);
+	} catch (sjtu::container_is_empty &e) {
+		std::cout << e.what() << " " << (sjtu::find(policy, empty, 1) == empty.end()) << " "
+				  << sjtu::count(policy, empty, 1) << std::endl;
+	}
+}
+
+void TestBint(sjtu::parallel_policy policy)
+{
+	std::cout << "Testing Bint..." << std::endl;
+	std::mt19937 gen(31);
+	sjtu::vector<Util::Bint> v;
+	for (int i = 0; i < 20000; ++i) {
+		Util::Bint x(static_cast<long long>(gen() % 2000001) - 1000000);
+		if (i % 5 == 0) {
+			x *= x;
+			x *= static_cast<long long>(gen() % 1000) - 500;
+		}
+		v.push_back(x);
+	}
+	std::cout << SortsLike(policy, v) << SortsLike(policy, v, std::greater<Util::Bint>()) << std::endl;
+	sjtu::vector<Util::Bint> stable = v;
+	sjtu::stable_sort(policy, stable);
+	sjtu::vector<Util::Bint> half(v.begin(), v.begin() + 10000);
+	sjtu::vector<Util::Bint> rest(v.begin() + 10000, v.end());
+	sjtu::sort(policy, half);
+	sjtu::sort(policy, rest);
+	sjtu::vector<Util::Bint> merged;
+	sjtu::merge(policy, half, rest, merged);
+	std::cout << (merged.size() == stable.size() && std::equal(merged.begin(), merged.end(), stable.begin()))
+			  << std::endl;
+
+	sjtu::pair<Util::Bint, Util::Bint> range = sjtu::min_max(policy, v);
+	std::cout << range.first << " " << range.second << " " << (range.first == stable.front())
+			  << (range.second == stable.back()) << std::endl;
+	std::cout << (sjtu::find(policy, v, v[12345]) - v.begin() <= 12345) << " "
+			  << (sjtu::count(policy, v, v[777]) >= 1) << " " << (sjtu::find(policy, v, Util::Bint("1" + std::string(40, '0'))) == v.end())
+			  << std::endl;
+}
+
+// Throws on its limit-th call, counting from zero
+struct Flaky {
+	std::atomic<long long> *calls;
+	long long limit;
+
+	bool operator()(const std::string &a, const std::string &b) const {
+		if (calls->fetch_add(1) == limit) {
+			throw std::runtime_error("comparison failed");
+		}
+		return a < b;
+	}
+};
+
+// Whether v holds the elements of kept, in any order
+bool SameElements(const sjtu::vector<std::string> &v, std::vector<std::string> kept)
+{
+	std::vector<std::string> now(v.begin(), v.end());
+	std::sort(now.begin(), now.end());
+	std::sort(kept.begin(), kept.end());
+	return now == kept;
+}
+
+// Fails the sort after the given fractions of its comparisons; counts
+// are the same on every run
+template<typename Sort>
+void ThrowAt(const char *name, const sjtu::vector<std::string> &input, std::vector<double> at, Sort sort)
+{
+	std::atomic<long long> calls(0);
+	sjtu::vector<std::string> v = input;
+	sort(v, Flaky{&calls, -1});
+	long long total = calls.load();
+	for (double fraction : at) {
+		calls = 0;
+		v = input;
+		try {
+			sort(v, Flaky{&calls, static_cast<long long>(total * fraction)});
+			std::cout << "sorted" << std::endl;
+		} catch (std::runtime_error &) {
+			std::cout << name << " kept " << SameElements(v, std::vector<std::string>(input.begin(), input.end()))
+					  << std::endl;
+		}
+	}
+}
+
+void TestThrowingComparison(sjtu::parallel_policy policy)
+{
+	std::cout << "Testing throwing comparisons..." << std::endl;
+	sjtu::vector<std::string> input;
+	std::mt19937 gen(40);
+	for (int i = 0; i < 50000; ++i) {
+		input.push_back(std::to_string(gen()) + std::string(20, 'x'));
+	}
+	// Within the chunks std::sort may lose an element, so sort fails in its merges only
+	ThrowAt("sort", input, {0.9, 0.99, 0.9999}, [policy](sjtu::vector<std::string> &v, Flaky comp) {
+		sjtu::sort(policy, v, comp);
+	});
+	ThrowAt("stable_sort", input, {0.001, 0.3, 0.9, 0.9999}, [policy](sjtu::vector<std::string> &v, Flaky comp) {
+		sjtu::stable_sort(policy, v, comp);
+	});
+}
+
+// Neither trivially copyable nor default constructible
+struct Named {
+	std::string name;
+
+	explicit Named(int i) : name(std::to_string(i)) {}
+};
+
+void TestNoDefaultConstructor(sjtu::parallel_policy policy)
+{
+	std::cout << "Testing sort without default constructor..." << std::endl;
+	sjtu::vector<Named> v;
+	for (int i = 0; i < 30000; ++i) {
+		v.push_back(Named((i * 7919) % 30000));
+	}
+	auto by_name = [](const Named &a, const Named &b) {
+		return a.name < b.name;
+	};
+	sjtu::sort(policy, v, by_name);
+	std::cout << std::is_sorted(v.begin(), v.end(), by_name) << " " << v.size() << " " << v.front().name << " "
+			  << v.back().name << std::endl;
+}
+
+int main()
+{
+	sjtu::thread_pool pool(3);
+	sjtu::parallel_policy parallel{1024, &pool};
+	std::cout << "threads " << pool.concurrency() << std::endl;
+	TestSort(parallel);
+	TestStableSort(parallel);
+	TestMerge(parallel);
+	TestSearch(parallel);
+	TestBint(parallel);
+	TestThrowingComparison(parallel);
+	TestNoDefaultConstructor(parallel);
+	std::cout << "Sequential" << std::endl;
+	TestSort(sjtu::seq);
+	TestStableSort(sjtu::seq);
+	TestMerge(sjtu::seq);
+	TestSearch(sjtu::seq);
+	TestBint(sjtu::seq);
+	TestNoDefaultConstructor(sjtu::seq);
+	return 0;
+}
@@ -0,0 +1,75 @@
+#include "vector.hpp"
+#include "class-bint.hpp"
+
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <utility>
+
+static size_t heap_allocations = 0;
+
+void *operator new(size_t size)
+{
+	++heap_allocations;
+	void *p = std::malloc(size == 0 ? 1 : size);
+	if (p == nullptr) {
+		throw std::bad_alloc();
+	}
+	return p;
+}
+
+void operator delete(void *p) noexcept
+{
+	std::free(p);
+}
+
+void operator delete(void *p, size_t) noexcept
+{
+	std::free(p);
+}
+
+void TestSmallIntegers()
+{
+	std::cout << "Testing integer-built Bints..." << std::endl;
+	size_t before = heap_allocations;
+	Util::Bint a(5);
+	Util::Bint b(-2147483647 - 1);
+	Util::Bint c(9999999999999999LL);
+	Util::Bint d(-9999999999999999LL);
+	Util::Bint e(0LL);
+	a = 7;
+	b = 123456789012LL;
+	e = -1;
+	std::cout << "allocations " << heap_allocations - before << std::endl;
+	std::cout << a << " " << b << " " << c << " " << d << " " << e << std::endl;
+
+	// Five limbs do not fit inline
+	before = heap_allocations;
+	Util::Bint f(-9223372036854775807LL - 1);
+	Util::Bint g(10000000000000000LL);
+	std::cout << "allocations " << heap_allocations - before << std::endl;
+	std::cout << f << " " << g << std::endl;
+}
+
+void TestMovedFrom()
+{
+	std::cout << "Testing moved-from Bints..." << std::endl;
+	Util::Bint a(-5);
+	Util::Bint b(Util::Bint("-123456789012345678901234567890"));
+	a = std::move(b);
+	std::cout << a << " " << b << " " << (b == Util::Bint(0)) << std::endl;
+	b += Util::Bint(-3);
+	std::cout << b << std::endl;
+
+	Util::Bint c(42);
+	Util::Bint d(-8);
+	c = std::move(d);
+	std::cout << c << " " << d << " " << (d == Util::Bint(0)) << std::endl;
+}
+
+int main()
+{
+	TestSmallIntegers();
+	TestMovedFrom();
+	return 0;
+}
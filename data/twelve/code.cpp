@@ -0,0 +1,50 @@
+#include "vector.hpp"
+
+#include <iostream>
+
+// Built with SJTU_VECTOR_CHECKED=1, so every access below is verified
+
+template<typename F>
+void Expect(const char *name, F f)
+{
+	try {
+		f();
+		std::cout << name << ": no exception" << std::endl;
+	} catch (sjtu::index_out_of_bound &) {
+		std::cout << name << ": index_out_of_bound" << std::endl;
+	} catch (sjtu::container_is_empty &) {
+		std::cout << name << ": container_is_empty" << std::endl;
+	} catch (sjtu::invalid_iterator &) {
+		std::cout << name << ": invalid_iterator" << std::endl;
+	}
+}
+
+int main()
+{
+	sjtu::vector<int> v;
+	for (int i = 0; i < 10; ++i) {
+		v.push_back(i * i);
+	}
+	const sjtu::vector<int> &cv = v;
+	sjtu::vector<int> empty;
+
+	Expect("at", [&]() { v.at(10); });
+	Expect("operator[]", [&]() { v[10]; });
+	Expect("const operator[]", [&]() { cv[9]; });
+	Expect("front", [&]() { empty.front(); });
+	Expect("back", [&]() { empty.back(); });
+	Expect("end dereference", [&]() { *v.end(); });
+	Expect("past end", [&]() { v.end() + 1; });
+	Expect("before begin", [&]() { v.begin() - 1; });
+	Expect("increment past end", [&]() { sjtu::vector<int>::iterator it = v.end(); ++it; });
+	Expect("const end dereference", [&]() { *cv.cend(); });
+	Expect("walk", [&]() {
+		sjtu::vector<int>::iterator it = v.end();
+		while (it != v.begin()) {
+			--it;
+		}
+		std::cout << *it << " " << *(v.begin() + 9) << " " << v.data()[4] << std::endl;
+	});
+	Expect("null iterator", [&]() { *sjtu::vector<int>::iterator(); });
+	return 0;
+}
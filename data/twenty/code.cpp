@@ -0,0 +1,197 @@
+#include "concurrent_vector.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Set to make every allocation fail
+static std::atomic<bool> out_of_memory(false);
+
+void *operator new(size_t size)
+{
+	void *p = out_of_memory ? nullptr : std::malloc(size == 0 ? 1 : size);
+	if (p == nullptr) {
+		throw std::bad_alloc();
+	}
+	return p;
+}
+
+void operator delete(void *p) noexcept
+{
+	std::free(p);
+}
+
+void operator delete(void *p, size_t) noexcept
+{
+	std::free(p);
+}
+
+class Picky {
+public:
+	int v;
+	Picky(int v) : v(v) {
+		if (v < 0) {
+			throw std::runtime_error("negative");
+		}
+	}
+};
+
+void TestConcurrentPush()
+{
+	std::cout << "Testing concurrent push_back..." << std::endl;
+	sjtu::concurrent_vector<long long> v;
+	v.push_back(-1);
+	const long long *first = &v[0];
+	const int threads = 4, per_thread = 20000;
+	std::atomic<bool> writing(true);
+	std::atomic<long long> reads(0);
+
+	// A reader walking the vector while it grows
+	std::thread reader([&] {
+		while (writing) {
+			size_t n = v.size();
+			if (n > 0 && v.at(n - 1) >= -1) {
+				++reads;
+			}
+		}
+	});
+	std::vector<std::thread> writers;
+	for (int t = 0; t < threads; ++t) {
+		writers.push_back(std::thread([&v, t] {
+			for (int i = 0; i < per_thread; ++i) {
+				v.push_back((long long)t * per_thread + i);
+			}
+		}));
+	}
+	for (size_t t = 0; t < writers.size(); ++t) {
+		writers[t].join();
+	}
+	writing = false;
+	reader.join();
+
+	std::cout << "size " << v.size() << " first stable " << (&v[0] == first) << std::endl;
+	std::vector<long long> all(v.begin() + 1, v.end());
+	std::sort(all.begin(), all.end());
+	bool complete = all.size() == (size_t)threads * per_thread;
+	for (size_t i = 0; complete && i < all.size(); ++i) {
+		complete = all[i] == (long long)i;
+	}
+	std::cout << "complete " << complete << std::endl;
+	std::cout << "capacity " << (v.capacity() >= v.size()) << std::endl;
+}
+
+void TestGrowBy()
+{
+	std::cout << "Testing grow_by..." << std::endl;
+	sjtu::concurrent_vector<std::string> v;
+	std::vector<std::thread> workers;
+	for (int t = 0; t < 3; ++t) {
+		workers.push_back(std::thread([&v, t] {
+			for (int i = 0; i < 100; ++i) {
+				sjtu::concurrent_vector<std::string>::iterator it = v.grow_by(5, std::string(1, 'a' + t));
+				*it += "!";
+			}
+		}));
+	}
+	for (size_t t = 0; t < workers.size(); ++t) {
+		workers[t].join();
+	}
+	int marks = 0, letters[3] = {0, 0, 0};
+	for (size_t i = 0; i < v.size(); ++i) {
+		letters[v[i][0] - 'a']++;
+		marks += v[i].size() == 2;
+	}
+	std::cout << v.size() << " " << letters[0] << " " << letters[1] << " " << letters[2] << " marks " << marks << std::endl;
+
+	sjtu::concurrent_vector<std::string> copy(v);
+	std::cout << "copy " << copy.size() << " " << std::equal(copy.begin(), copy.end(), v.begin()) << std::endl;
+	v.clear();
+	std::cout << "cleared " << v.size() << std::endl;
+	v.emplace_back(3, 'z');
+	std::cout << v.front() << std::endl;
+}
+
+void TestBrokenSlot()
+{
+	std::cout << "Testing failed construction..." << std::endl;
+	sjtu::concurrent_vector<Picky> v;
+	v.emplace_back(1);
+	try {
+		v.emplace_back(-1);
+	} catch (std::runtime_error &e) {
+		std::cout << e.what() << std::endl;
+	}
+	v.emplace_back(3);
+	std::cout << "size " << v.size() << " " << v.at(0).v << " " << v.at(2).v << std::endl;
+	try {
+		v.at(1);
+	} catch (sjtu::runtime_error &) {
+		std::cout << "runtime_error" << std::endl;
+	}
+	try {
+		v.at(3);
+	} catch (sjtu::index_out_of_bound &) {
+		std::cout << "index_out_of_bound" << std::endl;
+	}
+}
+
+// A segment that cannot be allocated claims no slots, so no reader waits for them
+void TestFailedSegment()
+{
+	std::cout << "Testing failed segments..." << std::endl;
+	sjtu::concurrent_vector<int> v;
+	for (int i = 0; i < 8; ++i) {
+		v.push_back(i);
+	}
+	out_of_memory = true;
+	try {
+		v.push_back(8);
+	} catch (std::bad_alloc &) {
+		std::cout << "bad_alloc " << v.size() << std::endl;
+	}
+	try {
+		v.grow_by(30, 1);
+	} catch (std::bad_alloc &) {
+		std::cout << "bad_alloc " << v.size() << std::endl;
+	}
+	out_of_memory = false;
+	v.push_back(8);
+	std::cout << "size " << v.size() << " " << v.at(8) << " " << v.back() << std::endl;
+}
+
+// Wider than operator new aligns by default
+struct alignas(64) Line {
+	long long v;
+};
+
+void TestOverAligned()
+{
+	std::cout << "Testing over-aligned elements..." << std::endl;
+	sjtu::concurrent_vector<Line> v;
+	v.grow_by(100, Line{7});
+	for (long long i = 0; i < 1000; ++i) {
+		v.push_back(Line{i});
+	}
+	bool aligned = true;
+	for (size_t i = 0; i < v.size(); ++i) {
+		aligned = aligned && reinterpret_cast<std::uintptr_t>(&v[i]) % alignof(Line) == 0;
+	}
+	std::cout << v.size() << " " << v[50].v << " " << v.back().v << " aligned " << aligned << std::endl;
+}
+
+int main()
+{
+	TestConcurrentPush();
+	TestGrowBy();
+	TestBrokenSlot();
+	TestFailedSegment();
+	TestOverAligned();
+	return 0;
+}
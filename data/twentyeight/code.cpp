@@ -0,0 +1,97 @@
+#include "vector.hpp"
+#include "exceptions.hpp"
+
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+#include <new>
+#include <string>
+#include <type_traits>
+
+static size_t heap_allocations = 0;
+
+void *operator new(size_t size)
+{
+	++heap_allocations;
+	void *p = std::malloc(size == 0 ? 1 : size);
+	if (p == nullptr) {
+		throw std::bad_alloc();
+	}
+	return p;
+}
+
+void operator delete(void *p) noexcept
+{
+	std::free(p);
+}
+
+void operator delete(void *p, size_t) noexcept
+{
+	std::free(p);
+}
+
+void TestTraits()
+{
+	std::cout << "Testing traits..." << std::endl;
+	std::cout << std::is_base_of<std::exception, sjtu::exception>::value
+			  << std::is_base_of<sjtu::exception, sjtu::index_out_of_bound>::value
+			  << std::is_nothrow_copy_constructible<sjtu::index_out_of_bound>::value
+			  << std::is_nothrow_default_constructible<sjtu::runtime_error>::value
+			  << noexcept(std::declval<const sjtu::exception &>().what()) << std::endl;
+}
+
+void TestMessages()
+{
+	std::cout << "Testing messages..." << std::endl;
+	std::cout << sjtu::exception().what() << std::endl;
+	std::cout << sjtu::index_out_of_bound().what() << std::endl;
+	std::cout << sjtu::runtime_error("bad header").what() << std::endl;
+	std::cout << sjtu::invalid_iterator("").what() << std::endl;
+	sjtu::container_is_empty empty("pop_back");
+	sjtu::container_is_empty copy(empty);
+	std::cout << copy.what() << " / " << copy.variant() << std::endl;
+
+	std::string longer(200, 'x');
+	sjtu::runtime_error cut(longer.c_str());
+	std::cout << std::string(cut.what()).size() + 1 << " " << sjtu::exception::message_capacity << std::endl;
+
+	try {
+		throw sjtu::index_out_of_bound("at");
+	} catch (std::exception &e) {
+		std::cout << e.what() << std::endl;
+	}
+}
+
+void TestLoop()
+{
+	std::cout << "Testing throws in a loop..." << std::endl;
+	sjtu::vector<int> v;
+	for (int i = 0; i < 10; ++i) {
+		v.push_back(i);
+	}
+	sjtu::vector<int> none;
+	size_t before = heap_allocations;
+	int caught = 0;
+	for (int i = 0; i < 10000; ++i) {
+		try {
+			v.at(10 + i);
+		} catch (sjtu::index_out_of_bound &e) {
+			sjtu::index_out_of_bound kept(e);
+			caught += kept.what()[0] == 'i';
+		}
+		try {
+			none.pop_back();
+		} catch (sjtu::exception &e) {
+			caught += e.what()[0] == 'c';
+		}
+	}
+	std::cout << "caught " << caught << " allocations " << heap_allocations - before << std::endl;
+}
+
+int main()
+{
+	TestTraits();
+	TestMessages();
+	TestLoop();
+	return 0;
+}
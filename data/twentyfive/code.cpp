@@ -0,0 +1,141 @@
+#include "vector.hpp"
+#include "class-bint.hpp"
+
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <random>
+#include <string>
+
+static size_t heap_allocations = 0;
+
+void *operator new(size_t size)
+{
+	++heap_allocations;
+	void *p = std::malloc(size == 0 ? 1 : size);
+	if (p == nullptr) {
+		throw std::bad_alloc();
+	}
+	return p;
+}
+
+void operator delete(void *p) noexcept
+{
+	std::free(p);
+}
+
+void operator delete(void *p, size_t) noexcept
+{
+	std::free(p);
+}
+
+std::string RandomNumber(std::mt19937 &gen, size_t digits)
+{
+	std::string s;
+	if (gen() % 2) {
+		s += '-';
+	}
+	s += static_cast<char>('1' + gen() % 9);
+	for (size_t i = 1; i < digits; ++i) {
+		s += static_cast<char>('0' + gen() % 10);
+	}
+	return s;
+}
+
+void TestCompound()
+{
+	std::cout << "Testing compound operators..." << std::endl;
+	Util::Bint x("99999999999999999999");
+	x += Util::Bint(1);
+	std::cout << x << " ";
+	x -= Util::Bint("100000000000000000001");
+	std::cout << x << " ";
+	x *= Util::Bint(-123456789);
+	std::cout << x << " ";
+	x *= -1000000007LL;
+	std::cout << x << " ";
+	x *= 0;
+	std::cout << x << " " << (x == Util::Bint(0)) << std::endl;
+
+	// Each operand may be the destination itself
+	Util::Bint y("-5000000000");
+	y += y;
+	std::cout << y << " ";
+	y *= y;
+	std::cout << y << " ";
+	y -= y;
+	std::cout << y << " " << (y == -y) << std::endl;
+
+	Util::Bint z(7);
+	z -= Util::Bint(10);
+	std::cout << z << " ";
+	z += Util::Bint(3);
+	std::cout << z << " " << -z << std::endl;
+}
+
+void TestOrder()
+{
+	std::cout << "Testing comparisons..." << std::endl;
+	Util::Bint values[] = {Util::Bint("-100000000"), Util::Bint(-5), Util::Bint(0), Util::Bint(5),
+		Util::Bint("000000000000000005"), Util::Bint("-0"), Util::Bint("100000000")};
+	for (const Util::Bint &a : values) {
+		for (const Util::Bint &b : values) {
+			std::cout << (a < b) + 2 * (a == b) + 4 * (a > b);
+		}
+		std::cout << " ";
+	}
+	std::cout << std::endl;
+}
+
+// The rvalue operators go on in the storage of a temporary
+void TestExpressions()
+{
+	std::cout << "Testing expressions..." << std::endl;
+	Util::Bint a("123456789012345678901234567890");
+	Util::Bint b("-98765432109876543210");
+	Util::Bint c(31337);
+	std::cout << a + b + c << " " << a - b - c << " " << c - (a + b) << " " << a * b * c << " "
+			  << (a - a) * b + c << std::endl;
+}
+
+void TestAccumulate()
+{
+	std::cout << "Testing allocation-free accumulation..." << std::endl;
+	std::mt19937 gen(2025);
+	sjtu::vector<Util::Bint> v;
+	for (int i = 0; i < 2000; ++i) {
+		v.push_back(Util::Bint(RandomNumber(gen, 1 + gen() % 60)));
+	}
+	Util::Bint sum;
+	Util::Bint scaled;
+	Util::Bint product;
+	size_t before = 0;
+	for (int round = 0; round < 3; ++round) {
+		if (round == 1) {
+			before = heap_allocations;
+		}
+		sum = 0;
+		scaled = 0;
+		product = 1;
+		for (size_t i = 0; i < v.size(); ++i) {
+			sum += v[i];
+			scaled -= v[i];
+			scaled *= 3;
+			if (i % 100 == 0) {
+				product *= v[i];
+			}
+		}
+	}
+	size_t allocations = heap_allocations - before;
+	std::cout << sum << std::endl << scaled << std::endl << product << std::endl;
+	std::cout << "allocations in later rounds " << allocations << std::endl;
+}
+
+int main()
+{
+	TestCompound();
+	TestOrder();
+	TestExpressions();
+	TestAccumulate();
+	return 0;
+}
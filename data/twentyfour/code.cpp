@@ -0,0 +1,101 @@
+#include "vector.hpp"
+#include "class-bint.hpp"
+
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+
+std::string RandomDigits(std::mt19937 &gen, size_t digits, bool nines)
+{
+	std::string s(1, nines ? '9' : static_cast<char>('1' + gen() % 9));
+	for (size_t i = 1; i < digits; ++i) {
+		s += nines ? '9' : static_cast<char>('0' + gen() % 10);
+	}
+	return s;
+}
+
+// Digit-by-digit long multiplication of decimal strings, as a reference
+std::string Reference(const std::string &a, const std::string &b)
+{
+	std::vector<long long> r(a.size() + b.size(), 0);
+	for (size_t i = 0; i < a.size(); ++i) {
+		for (size_t j = 0; j < b.size(); ++j) {
+			r[i + j + 1] += (a[i] - '0') * (b[j] - '0');
+		}
+	}
+	for (size_t k = r.size() - 1; k > 0; --k) {
+		r[k - 1] += r[k] / 10;
+		r[k] %= 10;
+	}
+	std::string s;
+	for (size_t k = 0; k < r.size(); ++k) {
+		if (!s.empty() || r[k] != 0) {
+			s += static_cast<char>('0' + r[k]);
+		}
+	}
+	return s.empty() ? "0" : s;
+}
+
+std::string Str(const Util::Bint &x)
+{
+	std::ostringstream os;
+	os << x;
+	return os.str();
+}
+
+void TestSizes()
+{
+	std::cout << "Testing products across algorithms..." << std::endl;
+	std::mt19937 gen(2024);
+	// Limb counts around the schoolbook/Karatsuba/NTT switch points,
+	// balanced and lopsided
+	const size_t sizes[][2] = {{1, 1}, {3, 5}, {47, 47}, {48, 48}, {49, 200}, {100, 100}, {300, 7},
+		{1535, 1535}, {1536, 1536}, {1600, 1700}, {2048, 60}};
+	for (const auto &size : sizes) {
+		for (bool nines : {false, true}) {
+			if (nines && size[0] > 1000) {
+				continue;  // the reference is quadratic in digits
+			}
+			std::string a = RandomDigits(gen, size[0] * 4 - 1, nines);
+			std::string b = RandomDigits(gen, size[1] * 4 - 2, nines);
+			std::string product = Str(Util::Bint(a) * Util::Bint(b));
+			std::cout << size[0] << "x" << size[1] << (nines ? " nines" : " random") << " digits "
+					  << product.size() << " equal " << (product == Reference(a, b)) << std::endl;
+		}
+	}
+}
+
+void TestSigns()
+{
+	std::cout << "Testing signs..." << std::endl;
+	std::cout << Util::Bint(-12345) * Util::Bint(6789) << " " << Util::Bint(-12345) * Util::Bint(-6789) << " "
+			  << Util::Bint(0) * Util::Bint(-5) << " " << (Util::Bint(0) * Util::Bint(-5) == Util::Bint(0)) << std::endl;
+	Util::Bint x(1);
+	for (int i = 0; i < 15; ++i) {
+		x = x * Util::Bint(-99991);
+	}
+	std::cout << x << std::endl;
+}
+
+void TestVector()
+{
+	std::cout << "Testing a vector of factorials..." << std::endl;
+	sjtu::vector<Util::Bint> f;
+	f.push_back(Util::Bint(1));
+	for (int i = 1; i <= 600; ++i) {
+		f.push_back(f.back() * Util::Bint(i));
+	}
+	std::string last = Str(f.back());
+	std::cout << last.size() << " " << last.substr(0, 20) << std::endl;
+	// 600! * 600! through the larger algorithms against the reference
+	std::cout << "square equal " << (Str(f.back() * f.back()) == Reference(last, last)) << std::endl;
+}
+
+int main()
+{
+	TestSizes();
+	TestSigns();
+	TestVector();
+	return 0;
+}
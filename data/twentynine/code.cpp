@@ -0,0 +1,140 @@
+// First, so that it is checked to compile on its own
+#include "utility.hpp"
+#include "vector.hpp"
+#include "class-bint.hpp"
+
+#include <iostream>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <type_traits>
+
+// Counts how it is built
+struct Tracked {
+	static int copies;
+	static int moves;
+	int v;
+	Tracked(int x = 0) : v(x) {}
+	Tracked(int x, int y) : v(x * 100 + y) {}
+	Tracked(const Tracked &other) : v(other.v) {
+		++copies;
+	}
+	Tracked(Tracked &&other) noexcept : v(other.v) {
+		++moves;
+	}
+	Tracked &operator=(const Tracked &other) {
+		v = other.v;
+		++copies;
+		return *this;
+	}
+	Tracked &operator=(Tracked &&other) noexcept {
+		v = other.v;
+		++moves;
+		return *this;
+	}
+};
+
+int Tracked::copies = 0;
+int Tracked::moves = 0;
+
+// Neither copyable nor movable
+struct Pinned {
+	int a;
+	std::string b;
+	Pinned(int x, const char *y) : a(x), b(y) {}
+	Pinned(const Pinned &) = delete;
+};
+
+void Counts(const char *name)
+{
+	std::cout << name << " copies " << Tracked::copies << " moves " << Tracked::moves << std::endl;
+	Tracked::copies = 0;
+	Tracked::moves = 0;
+}
+
+void TestForwarding()
+{
+	std::cout << "Testing forwarding..." << std::endl;
+	sjtu::pair<Tracked, Tracked> a(Tracked(1), Tracked(2));
+	Counts("temporaries");
+	Tracked x(3);
+	sjtu::pair<Tracked, Tracked> b(x, Tracked(4));
+	Counts("lvalue and temporary");
+	sjtu::pair<Tracked, Tracked> c(5, 6);
+	Counts("converted");
+	sjtu::pair<Tracked, Tracked> d(std::move(c));
+	Counts("move");
+	sjtu::pair<Tracked, long> e(sjtu::pair<Tracked, int>(Tracked(7), 8));
+	Counts("converting move");
+	d = a;
+	Counts("copy assignment");
+	d = std::move(b);
+	Counts("move assignment");
+	std::cout << a.first.v << a.second.v << d.first.v << d.second.v << e.first.v << e.second << std::endl;
+
+	sjtu::pair<std::unique_ptr<int>, std::string> owner(std::unique_ptr<int>(new int(9)), "nine");
+	sjtu::pair<std::unique_ptr<int>, std::string> taken(std::move(owner));
+	std::cout << *taken.first << " " << taken.second << " " << (owner.first == nullptr) << std::endl;
+}
+
+void TestConstraints()
+{
+	std::cout << "Testing constraints..." << std::endl;
+	using P = sjtu::pair<int, std::string>;
+	std::cout << std::is_constructible<P, int, const char *>::value << std::is_constructible<P, int, int *>::value
+			  << std::is_constructible<P, std::string, std::string>::value
+			  << std::is_constructible<sjtu::pair<long, std::string>, const P &>::value
+			  << std::is_constructible<sjtu::pair<int *, std::string>, const P &>::value
+			  << std::is_copy_assignable<P>::value << std::is_move_assignable<P>::value << std::endl;
+}
+
+void TestTraits()
+{
+	std::cout << "Testing traits..." << std::endl;
+	std::cout << std::is_trivially_copyable<sjtu::pair<int, double>>::value
+			  << std::is_trivially_copyable<sjtu::pair<int, std::string>>::value
+			  << sjtu::is_trivially_relocatable<sjtu::pair<int, double>>::value
+			  << sjtu::is_trivially_relocatable<sjtu::pair<int, Util::Bint>>::value
+			  << sjtu::is_trivially_relocatable<sjtu::pair<Util::Bint, std::string>>::value << std::endl;
+
+	sjtu::vector<sjtu::pair<int, Util::Bint>> v;
+	for (int i = 0; i < 100; ++i) {
+		v.push_back(sjtu::pair<int, Util::Bint>(i, Util::Bint(i) * Util::Bint("1000000000000")));
+	}
+	v.insert(v.begin(), sjtu::pair<int, Util::Bint>(-1, Util::Bint(-1)));
+	v.erase(v.begin() + 50);
+	std::cout << v.size() << " " << v[0].second << " " << v[50].first << " " << v[99].second << std::endl;
+}
+
+void TestPiecewise()
+{
+	std::cout << "Testing piecewise construction..." << std::endl;
+	sjtu::pair<Tracked, std::string> p(std::piecewise_construct, std::forward_as_tuple(1, 2),
+		std::forward_as_tuple(3, 'z'));
+	std::cout << p.first.v << " " << p.second << std::endl;
+	Counts("piecewise");
+
+	sjtu::pair<Pinned, int> pinned(std::piecewise_construct, std::forward_as_tuple(4, "four"), std::forward_as_tuple());
+	std::cout << pinned.first.a << " " << pinned.first.b << " " << pinned.second << std::endl;
+
+	std::string s("moved");
+	sjtu::pair<std::string, std::string> q(std::piecewise_construct, std::forward_as_tuple(std::move(s)),
+		std::forward_as_tuple(s));
+	std::cout << q.first << " [" << q.second << "]" << std::endl;
+
+	sjtu::vector<sjtu::pair<Tracked, Tracked>> v;
+	v.reserve(4);
+	v.emplace_back(std::piecewise_construct, std::forward_as_tuple(5, 6), std::forward_as_tuple(7));
+	v.emplace_back(8, 9);
+	std::cout << v[0].first.v << " " << v[0].second.v << " " << v[1].first.v << " " << v[1].second.v << std::endl;
+	Counts("emplace_back");
+}
+
+int main()
+{
+	TestForwarding();
+	TestConstraints();
+	TestTraits();
+	TestPiecewise();
+	return 0;
+}
@@ -0,0 +1,123 @@
+#include "segmented_vector.hpp"
+
+#include <algorithm>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// Counts copies and moves, to check that growth never relocates
+class Counted {
+public:
+	static long long relocations;
+	int v;
+	Counted(int v = 0) : v(v) {}
+	Counted(const Counted &other) : v(other.v) {
+		++relocations;
+	}
+	Counted(Counted &&other) noexcept : v(other.v) {
+		++relocations;
+	}
+	Counted &operator=(const Counted &other) = default;
+	Counted &operator=(Counted &&other) = default;
+};
+long long Counted::relocations = 0;
+
+void TestGrowth()
+{
+	std::cout << "Testing growth without relocation..." << std::endl;
+	sjtu::segmented_vector<Counted> v;
+	v.emplace_back(0);
+	const Counted *first = &v[0];
+	for (int i = 1; i < 3000000; ++i) {
+		v.emplace_back(i);
+	}
+	long long sum = 0;
+	for (size_t i = 0; i < v.size(); i += 1000) {
+		sum += v[i].v;
+	}
+	std::cout << "size " << v.size() << " relocations " << Counted::relocations
+	          << " first stable " << (&v[0] == first) << " sum " << sum << std::endl;
+	std::cout << "capacity " << (v.capacity() >= v.size() && v.capacity() - v.size() < sjtu::segmented_chunk_size<Counted>::value) << std::endl;
+
+	for (int round = 0; round < 1000; ++round) {
+		for (int i = 0; i < 16; ++i) {
+			v.pop_back();
+		}
+		for (int i = 0; i < 16; ++i) {
+			v.emplace_back(round);
+		}
+	}
+	std::cout << "back " << v.back().v << std::endl;
+}
+
+void TestInterface()
+{
+	std::cout << "Testing vector interface..." << std::endl;
+	sjtu::segmented_vector<std::string, 4> v;
+	for (int i = 0; i < 10; ++i) {
+		v.push_back(std::to_string(i));
+	}
+	v.insert(v.begin(), "front");
+	v.insert(5, v[5]);
+	v.erase(v.begin() + 2);
+	v.erase(v.size() - 1);
+	v.emplace(v.end(), 2, 'x');
+	for (const std::string &s : v) {
+		std::cout << s << " ";
+	}
+	std::cout << std::endl;
+
+	std::sort(v.begin(), v.end());
+	std::cout << v.front() << " " << v.back() << " " << v.size() << std::endl;
+
+	sjtu::segmented_vector<std::string, 4> w(v);
+	v.resize(3);
+	v.shrink_to_fit();
+	std::cout << v.size() << " " << v.capacity() << " " << w.size() << std::endl;
+	w = v;
+	std::cout << w.size() << " " << w[2] << std::endl;
+	sjtu::segmented_vector<std::string, 4> m(std::move(w));
+	std::cout << m.size() << " " << w.size() << std::endl;
+	m.resize(6, "y");
+	std::cout << m[5] << " " << *(m.rbegin() + 5) << std::endl;
+
+	try {
+		m.at(6);
+	} catch (sjtu::index_out_of_bound &) {
+		std::cout << "index_out_of_bound" << std::endl;
+	}
+	m.clear();
+	try {
+		m.pop_back();
+	} catch (sjtu::container_is_empty &) {
+		std::cout << "container_is_empty" << std::endl;
+	}
+}
+
+void TestReserve()
+{
+	std::cout << "Testing reserve..." << std::endl;
+	sjtu::segmented_vector<int, 16> v;
+	v.reserve(100000);
+	std::cout << v.capacity() << std::endl;
+	std::vector<int> ref;
+	for (int i = 0; i < 5000; ++i) {
+		v.push_back(i * 7 % 1000);
+		ref.push_back(i * 7 % 1000);
+	}
+	for (int i = 0; i < 100; ++i) {
+		v.insert(i * 3, i);
+		ref.insert(ref.begin() + i * 3, i);
+		v.erase(i * 5);
+		ref.erase(ref.begin() + i * 5);
+	}
+	std::cout << "equal " << std::equal(v.begin(), v.end(), ref.begin()) << " " << v.size() << std::endl;
+}
+
+int main()
+{
+	TestGrowth();
+	TestInterface();
+	TestReserve();
+	return 0;
+}
@@ -0,0 +1,136 @@
+#include "vector.hpp"
+#include "class-matrix.hpp"
+#include "class-bint.hpp"
+
+#include <iostream>
+#include <random>
+#include <stdexcept>
+
+template<typename T>
+Diamond::Matrix<T> Random(std::mt19937 &gen, size_t rows, size_t cols)
+{
+	Diamond::Matrix<T> m(rows, cols);
+	for (size_t i = 0; i < rows; ++i) {
+		for (size_t j = 0; j < cols; ++j) {
+			m[i][j] = static_cast<T>(static_cast<int>(gen() % 201) - 100);
+		}
+	}
+	return m;
+}
+
+// The textbook triple loop, as a reference
+template<typename T>
+Diamond::Matrix<T> Naive(const Diamond::Matrix<T> &a, const Diamond::Matrix<T> &b)
+{
+	Diamond::Matrix<T> c(a.RowSize(), b.ColSize(), 0);
+	for (size_t i = 0; i < a.RowSize(); ++i) {
+		for (size_t j = 0; j < b.ColSize(); ++j) {
+			for (size_t k = 0; k < a.ColSize(); ++k) {
+				c[i][j] += a[i][k] * b[k][j];
+			}
+		}
+	}
+	return c;
+}
+
+template<typename T>
+void TestProducts(const char *name)
+{
+	std::cout << "Testing " << name << " products..." << std::endl;
+	std::mt19937 gen(27);
+	// Shapes below, at and across the 64-element tiles
+	const size_t shapes[][3] = {{1, 1, 1}, {3, 70, 5}, {64, 64, 64}, {65, 129, 63}, {70, 130, 200}, {150, 90, 90}};
+	for (const auto &shape : shapes) {
+		Diamond::Matrix<T> a = Random<T>(gen, shape[0], shape[1]);
+		Diamond::Matrix<T> b = Random<T>(gen, shape[1], shape[2]);
+		Diamond::Matrix<T> expected = Naive(a, b);
+		Diamond::Matrix<T> c = a;
+		c *= b;
+		std::cout << shape[0] << "x" << shape[1] << "x" << shape[2] << " " << (a * b == expected)
+				  << (c == expected) << " " << c.RowSize() << "x" << c.ColSize() << std::endl;
+	}
+}
+
+void TestElementwise()
+{
+	std::cout << "Testing element-wise operators..." << std::endl;
+	std::mt19937 gen(72);
+	Diamond::Matrix<int> a = Random<int>(gen, 37, 41);
+	Diamond::Matrix<int> b = Random<int>(gen, 37, 41);
+	Diamond::Matrix<int> sum(37, 41);
+	Diamond::Matrix<int> diff(37, 41);
+	Diamond::Matrix<int> scaled(37, 41);
+	for (size_t i = 0; i < 37; ++i) {
+		for (size_t j = 0; j < 41; ++j) {
+			sum[i][j] = a[i][j] + b[i][j];
+			diff[i][j] = a[i][j] - b[i][j];
+			scaled[i][j] = a[i][j] * -3;
+		}
+	}
+	Diamond::Matrix<int> c = a;
+	c += b;
+	Diamond::Matrix<int> d = a;
+	d -= b;
+	Diamond::Matrix<int> e = a;
+	e *= -3;
+	std::cout << (a + b == sum) << (a - b == diff) << (a * -3 == scaled) << (-3 * a == scaled) << (c == sum)
+			  << (d == diff) << (e == scaled) << std::endl;
+	std::cout << (Diamond::Matrix<int>(a) + b == sum) << (a + Diamond::Matrix<int>(b) == sum)
+			  << (Diamond::Matrix<int>(a) + Diamond::Matrix<int>(b) == sum) << (Diamond::Matrix<int>(a) - b == diff)
+			  << (Diamond::Matrix<int>(a) - Diamond::Matrix<int>(b) == diff) << std::endl;
+
+	// Operands that are the destination, or one of its elements
+	Diamond::Matrix<int> f = a;
+	f += f;
+	Diamond::Matrix<int> g = a;
+	g -= g;
+	Diamond::Matrix<int> h = a;
+	h *= h[0][0];
+	std::cout << (f == a * 2) << (g == Diamond::Matrix<int>(37, 41, 0)) << (h == a * a[0][0]) << std::endl;
+
+	Diamond::Matrix<int> s = Random<int>(gen, 70, 70);
+	Diamond::Matrix<int> square = Naive(s, s);
+	s *= s;
+	std::cout << (s == square) << std::endl;
+
+	try {
+		a += Diamond::Matrix<int>(37, 40);
+	} catch (std::invalid_argument &) {
+		std::cout << "invalid_argument" << std::endl;
+	}
+	try {
+		a *= Diamond::Matrix<int>(40, 40);
+	} catch (std::invalid_argument &) {
+		std::cout << "invalid_argument" << std::endl;
+	}
+}
+
+void TestBint()
+{
+	std::cout << "Testing Bint matrices..." << std::endl;
+	Diamond::Matrix<Util::Bint> fib(2, 2, Util::Bint(1));
+	fib[1][1] = 0;
+	size_t n = 300;
+	Diamond::Matrix<Util::Bint> p = Diamond::Pow(fib, n);
+	std::cout << p[0][1] << std::endl;
+
+	std::mt19937 gen(7);
+	Diamond::Matrix<Util::Bint> a = Random<Util::Bint>(gen, 12, 12);
+	Diamond::Matrix<Util::Bint> cube = a * a * a;
+	Diamond::Matrix<Util::Bint> b = a;
+	b *= a;
+	b *= a;
+	b += cube;
+	b -= a;
+	std::cout << (cube == Naive(Naive(a, a), a)) << (b == cube + cube - a) << " " << b[3][4] << std::endl;
+}
+
+int main()
+{
+	TestProducts<int>("int");
+	TestProducts<double>("double");
+	TestProducts<long long>("long long");
+	TestElementwise();
+	TestBint();
+	return 0;
+}
@@ -0,0 +1,116 @@
+#include "vector.hpp"
+#include "class-bint.hpp"
+
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+
+std::string RandomNumber(std::mt19937 &gen, size_t digits)
+{
+	std::string s;
+	if (gen() % 2) {
+		s += '-';
+	}
+	s += static_cast<char>('1' + gen() % 9);
+	for (size_t i = 1; i < digits; ++i) {
+		s += static_cast<char>('0' + gen() % 10);
+	}
+	return s;
+}
+
+void TestParse()
+{
+	std::cout << "Testing parsing..." << std::endl;
+	const char *texts[] = {"", "-", "0", "-0", "--5", "---5", "0005", "-00001234", "10000", "99999999",
+		"100000000", "123456789012345678901234567890"};
+	for (const char *text : texts) {
+		Util::Bint x(text);
+		std::cout << "[" << text << "] " << x << " " << x.TextLength() << std::endl;
+	}
+	Util::Bint y(std::string_view("12345678", 5));
+	std::cout << y << " " << (y == Util::Bint(std::string("12345"))) << std::endl;
+
+	Util::Bint z(42);
+	std::istringstream in("12x4");
+	try {
+		in >> z;
+	} catch (std::invalid_argument &) {
+		std::cout << "invalid_argument " << z << std::endl;
+	}
+	try {
+		Util::Bint w("-1-2");
+	} catch (std::invalid_argument &) {
+		std::cout << "invalid_argument" << std::endl;
+	}
+}
+
+void TestPrint()
+{
+	std::cout << "Testing printing..." << std::endl;
+	Util::Bint x("-1000000020003");
+	char buffer[32];
+	std::to_chars_result r = x.ToChars(buffer, buffer + 14);
+	std::cout << (r.ec == std::errc()) << " " << std::string(buffer, r.ptr) << std::endl;
+	r = x.ToChars(buffer, buffer + 13);
+	std::cout << (r.ec == std::errc::value_too_large) << " " << (r.ptr == buffer + 13) << std::endl;
+
+	// Width and fill apply to the whole number, as for built-in types
+	std::cout << "[" << std::setw(16) << x << "][" << std::left << std::setw(6) << Util::Bint(-7) << "]["
+			  << std::right << std::setfill('*') << std::setw(3) << Util::Bint(5) << "][" << Util::Bint(99)
+			  << "][" << std::setw(4) << 1 << "]" << std::setfill(' ') << std::endl;
+}
+
+void TestRoundTrip()
+{
+	std::cout << "Testing round trips..." << std::endl;
+	std::mt19937 gen(4096);
+	const size_t sizes[] = {1, 3, 4, 5, 8, 9, 63, 64, 65, 1000, 100000};
+	for (size_t digits : sizes) {
+		std::string text = RandomNumber(gen, digits);
+		Util::Bint x(text);
+		std::ostringstream os;
+		os << x;
+		Util::Bint y;
+		std::istringstream is(os.str());
+		is >> y;
+		std::cout << digits << " " << (os.str() == text) << (x.ToString() == text) << (x.TextLength() == text.size())
+				  << (y == x) << std::endl;
+	}
+}
+
+void TestWriteAll()
+{
+	std::cout << "Testing WriteAll..." << std::endl;
+	sjtu::vector<Util::Bint> v;
+	Util::WriteAll(std::cout, v);
+	Util::Bint x(1);
+	for (int i = 0; i < 12; ++i) {
+		x *= -9999;
+		v.push_back(x);
+	}
+	Util::WriteAll(std::cout, v);
+	Util::WriteAll(std::cout, v, ' ');
+	std::cout << std::endl;
+
+	std::ostringstream all;
+	std::ostringstream each;
+	std::mt19937 gen(7);
+	v.clear();
+	for (int i = 0; i < 500; ++i) {
+		v.push_back(Util::Bint(RandomNumber(gen, 1 + gen() % 90)));
+		each << v.back() << ",";
+	}
+	Util::WriteAll(all, v, ',');
+	std::cout << (all.str() == each.str()) << " " << all.str().size() << std::endl;
+}
+
+int main()
+{
+	TestParse();
+	TestPrint();
+	TestRoundTrip();
+	TestWriteAll();
+	return 0;
+}
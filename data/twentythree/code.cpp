@@ -0,0 +1,202 @@
+#include "vector.hpp"
+
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// Copies (and, unless NoexceptMove, moves) burn the fuse and throw once
+// it runs out; every live object owns a heap int so leaks show up
+int fuse = -1;
+int live = 0;
+
+struct Boom {};
+
+void Burn() {
+	if (fuse > 0 && --fuse == 0) {
+		throw Boom();
+	}
+}
+
+template<bool NoexceptMove>
+class Bomb {
+public:
+	int *p;
+	Bomb(int v = 0) {
+		Burn();
+		p = new int(v);
+		++live;
+	}
+	Bomb(const Bomb &other) {
+		Burn();
+		p = new int(*other.p);
+		++live;
+	}
+	Bomb(Bomb &&other) noexcept(NoexceptMove) {
+		if (!NoexceptMove) {
+			Burn();
+		}
+		p = new int(*other.p);
+		++live;
+	}
+	Bomb &operator=(const Bomb &other) {
+		Burn();
+		*p = *other.p;
+		return *this;
+	}
+	Bomb &operator=(Bomb &&other) noexcept(NoexceptMove) {
+		if (!NoexceptMove) {
+			Burn();
+		}
+		*p = *other.p;
+		return *this;
+	}
+	~Bomb() {
+		delete p;
+		--live;
+	}
+};
+
+template<typename T>
+using Vec = sjtu::vector<T>;
+
+template<typename T>
+std::vector<int> Values(const Vec<T> &v) {
+	std::vector<int> out;
+	for (size_t i = 0; i < v.size(); ++i) {
+		out.push_back(*v[i].p);
+	}
+	return out;
+}
+
+// Eight elements, either with the buffer full or with room for eight more
+template<typename T>
+Vec<T> Make(bool spare) {
+	Vec<T> v;
+	v.reserve(spare ? 16 : 8);
+	for (int i = 0; i < 8; ++i) {
+		v.push_back(T(i));
+	}
+	return v;
+}
+
+struct Case {
+	const char *name;
+	bool spare;
+	bool strong;  // expected even when moves throw
+};
+
+template<typename T>
+void Run(const Case &c, std::function<void(Vec<T> &)> op) {
+	int throws = 0;
+	bool strong = true;
+	bool consistent = true;
+	for (int k = 1;; ++k) {
+		Vec<T> v = Make<T>(c.spare);
+		std::vector<int> before = Values(v);
+		size_t capacity = v.capacity();
+		bool threw = false;
+		fuse = k;
+		try {
+			op(v);
+		} catch (Boom &) {
+			threw = true;
+		}
+		fuse = -1;
+		if (!threw) {
+			break;
+		}
+		++throws;
+		if (live != (int)v.size()) {
+			consistent = false;
+		}
+		if (Values(v) != before || v.capacity() != capacity) {
+			strong = false;
+		}
+	}
+	std::cout << c.name << " throws " << throws << " consistent " << consistent;
+	if (c.strong) {
+		std::cout << " strong " << strong;
+	}
+	std::cout << " live " << live << std::endl;
+}
+
+template<typename T>
+void RunAll(bool noexcept_move) {
+	T value(42);
+	std::vector<T> range;
+	for (int i = 0; i < 3; ++i) {
+		range.push_back(T(100 + i));
+	}
+	int extra = 1 + (int)range.size();
+	live -= extra;
+
+	Run<T>({"push_back full", false, true}, [&](Vec<T> &v) {
+		v.push_back(value);
+	});
+	Run<T>({"push_back spare", true, true}, [&](Vec<T> &v) {
+		v.push_back(value);
+	});
+	Run<T>({"push_back self", false, true}, [&](Vec<T> &v) {
+		v.push_back(v[3]);
+	});
+	Run<T>({"insert full", false, true}, [&](Vec<T> &v) {
+		v.insert(v.begin() + 3, value);
+	});
+	Run<T>({"insert spare", true, noexcept_move}, [&](Vec<T> &v) {
+		v.insert(v.begin() + 3, value);
+	});
+	Run<T>({"insert self", true, noexcept_move}, [&](Vec<T> &v) {
+		v.insert(v.begin() + 1, v[5]);
+	});
+	Run<T>({"emplace spare", true, noexcept_move}, [&](Vec<T> &v) {
+		v.emplace(v.begin() + 2, 7);
+	});
+	Run<T>({"insert count full", false, true}, [&](Vec<T> &v) {
+		v.insert(v.begin() + 2, 3, value);
+	});
+	Run<T>({"insert count spare", true, noexcept_move}, [&](Vec<T> &v) {
+		v.insert(v.begin() + 2, 3, value);
+	});
+	Run<T>({"insert count end", true, true}, [&](Vec<T> &v) {
+		v.insert(v.end(), 3, value);
+	});
+	Run<T>({"insert range full", false, true}, [&](Vec<T> &v) {
+		v.insert(v.begin() + 5, range.begin(), range.end());
+	});
+	Run<T>({"insert range spare", true, noexcept_move}, [&](Vec<T> &v) {
+		v.insert(v.begin() + 5, range.begin(), range.end());
+	});
+	Run<T>({"reserve", false, true}, [&](Vec<T> &v) {
+		v.reserve(100);
+	});
+	Run<T>({"shrink_to_fit", true, true}, [&](Vec<T> &v) {
+		v.shrink_to_fit();
+	});
+	Run<T>({"resize full", false, true}, [&](Vec<T> &v) {
+		v.resize(12, value);
+	});
+	Run<T>({"resize spare", true, true}, [&](Vec<T> &v) {
+		v.resize(12);
+	});
+	Run<T>({"assign larger", false, true}, [&](Vec<T> &v) {
+		Vec<T> other;
+		fuse = -fuse;
+		for (int i = 0; i < 10; ++i) {
+			other.push_back(T(i));
+		}
+		fuse = -fuse;
+		v = other;
+	});
+
+	live += extra;
+}
+
+int main() {
+	std::cout << "Testing with noexcept moves..." << std::endl;
+	RunAll<Bomb<true>>(true);
+	std::cout << "Testing with throwing moves..." << std::endl;
+	RunAll<Bomb<false>>(false);
+	std::cout << "live " << live << std::endl;
+	return 0;
+}
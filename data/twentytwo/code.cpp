@@ -0,0 +1,150 @@
+#include "devector.hpp"
+
+#include <algorithm>
+#include <deque>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+
+// Copy may throw and there is no move, so nothing is shifted in place
+class Stubborn {
+public:
+	static int live;
+	static int fail_countdown;
+	int v;
+	Stubborn(int v = 0) : v(v) {
+		++live;
+	}
+	Stubborn(const Stubborn &other) : v(other.v) {
+		if (fail_countdown > 0 && --fail_countdown == 0) {
+			throw std::runtime_error("copy failed");
+		}
+		++live;
+	}
+	Stubborn &operator=(const Stubborn &other) {
+		v = other.v;
+		return *this;
+	}
+	~Stubborn() {
+		--live;
+	}
+};
+int Stubborn::live = 0;
+int Stubborn::fail_countdown = 0;
+
+void TestQueue()
+{
+	std::cout << "Testing front operations..." << std::endl;
+	sjtu::devector<long long> v;
+	for (long long i = 0; i < 1LL << 20; ++i) {
+		v.push_back(i);
+	}
+	std::cout << v.back() << std::endl;
+	for (long long i = 0; i < 1LL << 11; ++i) {
+		v.insert(v.begin(), i);
+	}
+	long long sum = 0;
+	for (size_t i = 0; i < 1LL << 10; ++i) {
+		sum += v.front();
+		v.erase(v.begin());
+	}
+	std::cout << v.size() << " " << v.front() << " sum " << sum << std::endl;
+
+	// A sliding window: push at the back, pop at the front
+	sjtu::devector<int> window;
+	for (int i = 0; i < 1000000; ++i) {
+		window.push_back(i);
+		if (window.size() > 100) {
+			window.pop_front();
+		}
+	}
+	std::cout << window.size() << " " << window.front() << " " << window.back()
+	          << " capacity bounded " << (window.capacity() < 1000) << std::endl;
+}
+
+void TestAgainstDeque()
+{
+	std::cout << "Testing random operations..." << std::endl;
+	std::mt19937 gen(2579);
+	sjtu::devector<std::string> v;
+	std::deque<std::string> ref;
+	for (int step = 0; step < 20000; ++step) {
+		int op = gen() % 8;
+		std::string s = std::to_string(step);
+		if (op == 0) {
+			v.push_front(s);
+			ref.push_front(s);
+		} else if (op == 1) {
+			v.push_back(s);
+			ref.push_back(s);
+		} else if (op == 2 && !ref.empty()) {
+			v.pop_front();
+			ref.pop_front();
+		} else if (op == 3 && !ref.empty()) {
+			v.pop_back();
+			ref.pop_back();
+		} else if (op == 4) {
+			size_t at = gen() % (ref.size() + 1);
+			v.insert(v.begin() + at, s);
+			ref.insert(ref.begin() + at, s);
+		} else if (op == 5 && !ref.empty()) {
+			size_t at = gen() % ref.size();
+			v.erase(v.begin() + at);
+			ref.erase(ref.begin() + at);
+		} else if (op == 6) {
+			size_t at = gen() % (ref.size() + 1);
+			size_t n = 1 + gen() % 4;
+			v.insert(v.begin() + at, n, v.empty() ? s : v[0]);
+			ref.insert(ref.begin() + at, n, ref.empty() ? s : ref[0]);
+		} else if (!ref.empty()) {
+			size_t at = gen() % ref.size();
+			size_t n = std::min<size_t>(gen() % 4, ref.size() - at);
+			v.erase(v.begin() + at, v.begin() + at + n);
+			ref.erase(ref.begin() + at, ref.begin() + at + n);
+		}
+	}
+	std::cout << "size " << v.size() << " equal " << std::equal(v.begin(), v.end(), ref.begin(), ref.end()) << std::endl;
+	std::cout << "contiguous " << (&v[v.size() - 1] - &v[0] == (long)v.size() - 1) << std::endl;
+
+	sjtu::devector<std::string> copy(v);
+	sjtu::devector<std::string> assigned;
+	assigned = copy;
+	assigned.shrink_to_fit();
+	std::cout << "copies " << std::equal(assigned.begin(), assigned.end(), ref.begin(), ref.end())
+	          << " " << (assigned.capacity() == assigned.size()) << std::endl;
+}
+
+void TestStrongGuarantee()
+{
+	std::cout << "Testing failed copies..." << std::endl;
+	{
+		sjtu::devector<Stubborn> v;
+		for (int i = 0; i < 8; ++i) {
+			v.push_back(Stubborn(i));
+		}
+		v.shrink_to_fit();
+		Stubborn::fail_countdown = 5;
+		try {
+			v.insert(v.begin() + 3, Stubborn(100));
+		} catch (std::runtime_error &e) {
+			std::cout << e.what() << " size " << v.size() << " third " << v[3].v << std::endl;
+		}
+		Stubborn::fail_countdown = 0;
+		v.push_front(Stubborn(-1));
+		v.erase(v.begin() + 2);
+		for (size_t i = 0; i < v.size(); ++i) {
+			std::cout << v[i].v << " ";
+		}
+		std::cout << std::endl;
+	}
+	std::cout << "live " << Stubborn::live << std::endl;
+}
+
+int main()
+{
+	TestQueue();
+	TestAgainstDeque();
+	TestStrongGuarantee();
+	return 0;
+}
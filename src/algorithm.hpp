@@ -0,0 +1,812 @@
+#ifndef SJTU_ALGORITHM_HPP
+#define SJTU_ALGORITHM_HPP
+
+#include "bits.hpp"
+#include "exceptions.hpp"
+#include "parallel.hpp"
+#include "utility.hpp"
+#include "vector.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <climits>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace sjtu
+{
+namespace algorithm_detail
+{
+using parallel_detail::chunking;
+
+// Below this many elements a radix sort loses to its own counting
+constexpr size_t radix_threshold = 1 << 12;
+// Buckets of at most this many bytes are radix sorted within the cache
+constexpr size_t radix_cached = 1 << 19;
+// stable_sort starts from runs this long sorted by insertion
+constexpr size_t insertion_run = 32;
+// find, count and min_max scan blocks this many elements apart
+constexpr size_t stop_check = 1 << 12;
+
+// Elements compared side by side: a cache line's worth, which the
+// compiler turns into a few vector instructions per block
+template<typename T>
+constexpr size_t lanes = sizeof(T) < 64 ? 64 / sizeof(T) : 1;
+
+// 64-bit lanes are compared for equality from SSE4.1 on and for order
+// from SSE4.2 on; before that, blocks of them are slower than one loop
+#if defined(__SSE4_2__) || defined(__aarch64__)
+constexpr bool wide_lanes = true;
+#else
+constexpr bool wide_lanes = false;
+#endif
+
+template<typename T>
+struct lane_find : std::integral_constant<bool, std::is_arithmetic<T>::value && (sizeof(T) < 8 || wide_lanes)> {};
+
+// Floating point minimum and maximum are vector instructions already in SSE2
+template<typename T>
+struct lane_min_max
+	: std::integral_constant<bool, std::is_arithmetic<T>::value &&
+		(sizeof(T) < 8 || std::is_floating_point<T>::value || wide_lanes)> {};
+
+// Whether sort() may order T by its bits under Compare
+template<typename T, typename Compare>
+struct radix_sortable
+	: std::integral_constant<bool, std::is_integral<T>::value && !std::is_same<T, bool>::value &&
+		(std::is_same<Compare, std::less<T>>::value || std::is_same<Compare, std::less<>>::value)> {};
+
+/**
+ * makes scratch hold at least n elements to be assigned over
+ * Only growth constructs anything, so a scratch vector kept between
+ * calls costs nothing the second time.
+ */
+template<typename T, typename Alloc, typename Growth>
+T* prepare_scratch(const parallel_policy &policy, vector<T, Alloc, Growth> &scratch, size_t n) {
+	if (scratch.size() < n) {
+		scratch.reserve(n);
+		scratch.append_raw(n - scratch.size(), [&policy](T* dest, size_t count) {
+			// Trivially copyable elements are all written before being read
+			if constexpr (!std::is_trivially_copyable<T>::value) {
+				parallel_detail::construct(policy, dest, count, [](T* p, size_t) {
+					new (p) T();
+				});
+			}
+			return count;
+		});
+	}
+	return scratch.data();
+}
+
+/**
+ * fills an empty scratch with the n elements of data, moved out of it
+ * This needs no default constructor, unlike prepare_scratch().
+ */
+template<typename T, typename Alloc, typename Growth>
+T* move_to_scratch(const parallel_policy &policy, vector<T, Alloc, Growth> &scratch, T* data, size_t n) {
+	scratch.reserve(n);
+	scratch.append_raw(n, [&policy, data](T* dest, size_t count) {
+		parallel_detail::construct(policy, dest, count, [data](T* p, size_t i) {
+			new (p) T(std::move(data[i]));
+		});
+		return count;
+	});
+	return scratch.data();
+}
+
+template<typename T>
+void move_back(thread_pool* pool, const chunking &chunks, T* src, T* dest) {
+	parallel_detail::run(pool, chunks, [src, dest](size_t begin, size_t end) {
+		std::move(src + begin, src + end, dest + begin);
+	});
+}
+
+/**
+ * returns how many elements of a are among the first d of the merge of
+ * a and b that takes from a on ties
+ */
+template<typename T, typename Compare>
+size_t co_rank(const T* a, size_t na, const T* b, size_t nb, size_t d, Compare &comp) {
+	size_t lo = d > nb ? d - nb : 0;
+	size_t hi = d < na ? d : na;
+	while (lo < hi) {
+		size_t mid = lo + (hi - lo) / 2;
+		if (comp(b[d - mid - 1], a[mid])) {
+			hi = mid;
+		} else {
+			lo = mid + 1;
+		}
+	}
+	return lo;
+}
+
+// Moves the first na of merged to a and the next nb to b
+template<typename T>
+void unmerge(T* merged, T* a, size_t na, T* b, size_t nb) {
+	std::move(merged, merged + na, a);
+	std::move(merged + na, merged + na + nb, b);
+}
+
+/**
+ * moves the merge of [a, ae) and [b, be) to dest, taking from a on ties
+ * If comp throws, the elements moved so far go back to the slots they
+ * left, though not in their order.
+ */
+template<typename T, typename Compare>
+void merge_move(T* a, T* ae, T* b, T* be, T* dest, Compare &comp) {
+	if constexpr (std::is_trivially_copyable<T>::value) {
+		// Moving copies, so the elements are still all where they were
+		std::merge(a, ae, b, be, dest, comp);
+		return;
+	}
+	T* const a0 = a;
+	T* const b0 = b;
+	T* const d0 = dest;
+	try {
+		for (; a != ae && b != be; ++dest) {
+			if (comp(*b, *a)) {
+				*dest = std::move(*b++);
+			} else {
+				*dest = std::move(*a++);
+			}
+		}
+	} catch (...) {
+		unmerge(d0, a0, a - a0, b0, b - b0);
+		throw;
+	}
+	std::move(b, be, std::move(a, ae, dest));
+}
+
+/**
+ * merges the sorted chunks of data pairwise until one run is left,
+ * moving back and forth between data and scratch
+ * Every round cuts its output at the chunk boundaries, so all chunks
+ * are written concurrently however few runs remain. Where each output
+ * chunk starts in its two runs is found before any element moves: the
+ * searches look at elements that neighbouring chunks move away. The
+ * chunks start out in scratch instead if in_scratch is set. If comp
+ * throws, the round under way is undone and every element is moved
+ * back to data.
+ */
+template<typename T, typename Compare>
+void merge_chunks(thread_pool* pool, const chunking &chunks, T* data, T* scratch, Compare &comp,
+	bool in_scratch = false) {
+	T* src = in_scratch ? scratch : data;
+	T* dest = in_scratch ? data : scratch;
+	if (chunks.count <= 1) {
+		if (src != data) {
+			move_back(pool, chunks, src, data);
+		}
+		return;
+	}
+	auto at = [&chunks](size_t k) {
+		return k < chunks.count ? chunks.begin(k) : chunks.n;
+	};
+	// taken[k]: elements of the first run that precede output chunk k
+	std::unique_ptr<size_t[]> taken(new size_t[chunks.count]);
+	// done[k]: output chunk k of this round is all in dest
+	std::unique_ptr<bool[]> done(new bool[chunks.count]);
+	size_t width = 1;
+	// Where output chunk k takes its elements from in the two runs
+	auto piece = [&](size_t k, size_t &i, size_t &ie, size_t &j, size_t &je) {
+		size_t pair_size = 2 * width;
+		size_t first = k / pair_size * pair_size;
+		size_t a = at(first);
+		size_t b = at(first + width);
+		// The last chunk of a pair ends where the first run does
+		size_t last = k + 1 < first + pair_size && k + 1 < chunks.count ? taken[k + 1] : b - a;
+		i = a + taken[k];
+		ie = a + last;
+		j = b + chunks.begin(k) - a - taken[k];
+		je = b + chunks.end(k) - a - last;
+	};
+	try {
+		for (; width < chunks.count; width *= 2) {
+			size_t pair_size = 2 * width;
+			std::fill(done.get(), done.get() + chunks.count, false);
+			parallel_detail::run(pool, chunks, [&](size_t begin, size_t) {
+				size_t k = begin / chunks.size;
+				size_t first = k / pair_size * pair_size;
+				size_t a = at(first);
+				size_t b = at(first + width);
+				taken[k] = co_rank(src + a, b - a, src + b, at(first + pair_size) - b, begin - a, comp);
+			});
+			parallel_detail::run(pool, chunks, [&](size_t begin, size_t) {
+				size_t k = begin / chunks.size;
+				size_t i, ie, j, je;
+				piece(k, i, ie, j, je);
+				merge_move(src + i, src + ie, src + j, src + je, dest + begin, comp);
+				done[k] = true;
+			});
+			std::swap(src, dest);
+		}
+	} catch (...) {
+		// A failed chunk has put its elements back already
+		for (size_t k = 0; k < chunks.count; ++k) {
+			if (done[k]) {
+				size_t i, ie, j, je;
+				piece(k, i, ie, j, je);
+				unmerge(dest + chunks.begin(k), src + i, ie - i, src + j, je - j);
+			}
+		}
+		if (src != data) {
+			move_back(pool, chunks, src, data);
+		}
+		throw;
+	}
+	if (src != data) {
+		move_back(pool, chunks, src, data);
+	}
+}
+
+template<typename T, typename Compare>
+void insertion_sort(T* first, T* last, Compare &comp) {
+	for (T* i = first + 1; i < last; ++i) {
+		if (comp(*i, *(i - 1))) {
+			T tmp(std::move(*i));
+			T* j = i;
+			try {
+				do {
+					*j = std::move(*(j - 1));
+					--j;
+				} while (j != first && comp(tmp, *(j - 1)));
+			} catch (...) {
+				// j is the one slot without an element
+				*j = std::move(tmp);
+				throw;
+			}
+			*j = std::move(tmp);
+		}
+	}
+}
+
+/**
+ * stable bottom-up merge sort of [data, data + n) through scratch,
+ * which must have room for n elements; allocates nothing
+ * If comp throws, data is left with all of its elements.
+ */
+template<typename T, typename Compare>
+void merge_sort(T* data, T* scratch, size_t n, Compare &comp) {
+	for (size_t i = 0; i < n; i += insertion_run) {
+		insertion_sort(data + i, data + std::min(i + insertion_run, n), comp);
+	}
+	T* src = data;
+	T* dest = scratch;
+	for (size_t width = insertion_run; width < n; width *= 2) {
+		size_t i = 0;
+		try {
+			for (; i < n; i += 2 * width) {
+				size_t mid = std::min(i + width, n);
+				size_t end = std::min(i + 2 * width, n);
+				merge_move(src + i, src + mid, src + mid, src + end, dest + i, comp);
+			}
+		} catch (...) {
+			// Each merge writes the range it reads, and the failed one is undone
+			std::move(dest, dest + i, src);
+			if (src != data) {
+				std::move(src, src + n, data);
+			}
+			throw;
+		}
+		std::swap(src, dest);
+	}
+	if (src != data) {
+		std::move(src, src + n, data);
+	}
+}
+
+/**
+ * integers compared as unsigned keys, a byte at a time; signed ones have
+ * their sign bit flipped, so that negatives come first
+ */
+template<typename T>
+struct radix_key {
+	using U = typename std::make_unsigned<T>::type;
+	static constexpr size_t radix = 256;
+	static constexpr unsigned bits = sizeof(T) * CHAR_BIT;
+	static constexpr U flip = std::is_signed<T>::value ? U(U(1) << (bits - 1)) : U(0);
+
+	static size_t digit(T x, unsigned shift) {
+		return static_cast<size_t>(static_cast<U>(static_cast<U>(x) ^ flip) >> shift & (radix - 1));
+	}
+};
+
+/**
+ * sorts [data, data + n) by its bytes up to the one at shift, lowest
+ * first, moving between data and scratch
+ * The counts of every byte are taken in a single pass, as they do not
+ * depend on the order, and bytes all elements share are skipped.
+ */
+template<typename T>
+void radix_sort_cached(T* data, T* scratch, size_t n, unsigned shift) {
+	using key = radix_key<T>;
+	size_t digits = shift / 8 + 1;
+	size_t count[sizeof(T)][key::radix] = {};
+	for (size_t i = 0; i < n; ++i) {
+		for (size_t p = 0; p < digits; ++p) {
+			++count[p][key::digit(data[i], p * 8)];
+		}
+	}
+	T* src = data;
+	T* dest = scratch;
+	for (size_t p = 0; p < digits; ++p) {
+		size_t* next = count[p];
+		size_t placed = 0;
+		bool shared = false;
+		for (size_t d = 0; d < key::radix; ++d) {
+			size_t c = next[d];
+			shared = shared || c == n;
+			next[d] = placed;
+			placed += c;
+		}
+		if (shared) {
+			continue;
+		}
+		for (size_t i = 0; i < n; ++i) {
+			dest[next[key::digit(src[i], p * 8)]++] = src[i];
+		}
+		std::swap(src, dest);
+	}
+	if (src != data) {
+		std::copy(src, src + n, data);
+	}
+}
+
+/**
+ * sorts [data, data + n) by its bytes up to the one at shift, highest
+ * first, through scratch and on the calling thread
+ * The elements are spread into one bucket per value of the byte, and
+ * every bucket is sorted by the lower bytes the same way until it fits
+ * the cache, where sorting from the lowest byte is faster.
+ */
+template<typename T>
+void radix_sort_serial(T* data, T* scratch, size_t n, unsigned shift) {
+	using key = radix_key<T>;
+	size_t count[key::radix];
+	for (;;) {
+		if (n < radix_threshold) {
+			std::sort(data, data + n);
+			return;
+		}
+		if (n * sizeof(T) <= radix_cached || shift == 0) {
+			radix_sort_cached(data, scratch, n, shift);
+			return;
+		}
+		std::fill(count, count + key::radix, size_t(0));
+		for (size_t i = 0; i < n; ++i) {
+			++count[key::digit(data[i], shift)];
+		}
+		if (std::find(count, count + key::radix, n) == count + key::radix) {
+			break;
+		}
+		shift -= 8;
+	}
+	size_t bounds[key::radix + 1];
+	bounds[0] = 0;
+	for (size_t d = 0; d < key::radix; ++d) {
+		bounds[d + 1] = bounds[d] + count[d];
+		count[d] = bounds[d];
+	}
+	for (size_t i = 0; i < n; ++i) {
+		scratch[count[key::digit(data[i], shift)]++] = data[i];
+	}
+	for (size_t d = 0; d < key::radix; ++d) {
+		size_t first = bounds[d];
+		size_t m = bounds[d + 1] - first;
+		if (m > 1) {
+			radix_sort_serial(scratch + first, data + first, m, shift - 8);
+		}
+		std::copy(scratch + first, scratch + first + m, data + first);
+	}
+}
+
+/**
+ * sorts the integers [data, data + n) through scratch
+ * The chunks of data count, then scatter, their elements by the highest
+ * byte in which any two differ, all concurrently; offsets are laid out
+ * digit by digit and chunk by chunk within a digit. The buckets of that
+ * byte are then sorted by radix_sort_serial() as separate jobs.
+ */
+template<typename T>
+void radix_sort(const parallel_policy &policy, T* data, T* scratch, size_t n) {
+	using key = radix_key<T>;
+	using U = typename key::U;
+	constexpr size_t radix = key::radix;
+	thread_pool* pool;
+	chunking chunks = parallel_detail::split(policy, n, sizeof(T), pool);
+	if (chunks.count <= 1) {
+		if (n > 1) {
+			radix_sort_serial(data, scratch, n, key::bits - 8);
+		}
+		return;
+	}
+
+	// The bits in which some element differs from the first
+	std::unique_ptr<U[]> differ(new U[chunks.count]);
+	parallel_detail::run(pool, chunks, [&](size_t begin, size_t end) {
+		U first = static_cast<U>(data[0]);
+		U bits = 0;
+		for (size_t i = begin; i < end; ++i) {
+			bits |= static_cast<U>(data[i]) ^ first;
+		}
+		differ[begin / chunks.size] = bits;
+	});
+	unsigned long long bits = 0;
+	for (size_t k = 0; k < chunks.count; ++k) {
+		bits |= differ[k];
+	}
+	if (bits == 0) {
+		return;
+	}
+	unsigned shift = static_cast<unsigned>(highest_bit(bits) / 8 * 8);
+
+	// offsets[k * radix + d] counts, then places, the elements of chunk k with digit d
+	std::unique_ptr<size_t[]> offsets(new size_t[chunks.count * radix]);
+	parallel_detail::run(pool, chunks, [&](size_t begin, size_t end) {
+		size_t* count = offsets.get() + begin / chunks.size * radix;
+		std::fill(count, count + radix, size_t(0));
+		for (size_t i = begin; i < end; ++i) {
+			++count[key::digit(data[i], shift)];
+		}
+	});
+	size_t bounds[radix + 1];
+	bounds[0] = 0;
+	for (size_t d = 0; d < radix; ++d) {
+		size_t placed = bounds[d];
+		for (size_t k = 0; k < chunks.count; ++k) {
+			size_t count = offsets[k * radix + d];
+			offsets[k * radix + d] = placed;
+			placed += count;
+		}
+		bounds[d + 1] = placed;
+	}
+	parallel_detail::run(pool, chunks, [&](size_t begin, size_t end) {
+		size_t* next = offsets.get() + begin / chunks.size * radix;
+		for (size_t i = begin; i < end; ++i) {
+			scratch[next[key::digit(data[i], shift)]++] = data[i];
+		}
+	});
+	pool->run(radix, [&](size_t d) {
+		size_t first = bounds[d];
+		size_t m = bounds[d + 1] - first;
+		if (m > 1 && shift > 0) {
+			radix_sort_serial(scratch + first, data + first, m, shift - 8);
+		}
+		std::copy(scratch + first, scratch + first + m, data + first);
+	});
+}
+
+/**
+ * copy-constructs the merge of a and b at dest, chunks of the output
+ * built concurrently; either all na + nb elements exist afterwards or,
+ * once an exception is on its way, none do
+ */
+template<typename T, typename Compare>
+void merge_construct(const parallel_policy &policy, const T* a, size_t na, const T* b, size_t nb, T* dest,
+	Compare &comp) {
+	thread_pool* pool;
+	chunking chunks = parallel_detail::split(policy, na + nb, sizeof(T), pool);
+	std::unique_ptr<bool[]> built(new bool[chunks.count]());
+	try {
+		parallel_detail::run(pool, chunks, [&](size_t begin, size_t end) {
+			size_t i = co_rank(a, na, b, nb, begin, comp);
+			size_t ie = co_rank(a, na, b, nb, end, comp);
+			size_t j = begin - i;
+			size_t je = end - ie;
+			T* p = dest + begin;
+			try {
+				for (; i < ie && j < je; ++p) {
+					if (comp(b[j], a[i])) {
+						new (p) T(b[j++]);
+					} else {
+						new (p) T(a[i++]);
+					}
+				}
+				for (; i < ie; ++p) {
+					new (p) T(a[i++]);
+				}
+				for (; j < je; ++p) {
+					new (p) T(b[j++]);
+				}
+			} catch (...) {
+				parallel_detail::destroy(dest + begin, p);
+				throw;
+			}
+			built[begin / chunks.size] = true;
+		});
+	} catch (...) {
+		for (size_t k = 0; k < chunks.count; ++k) {
+			if (built[k]) {
+				parallel_detail::destroy(dest + chunks.begin(k), dest + chunks.end(k));
+			}
+		}
+		throw;
+	}
+}
+
+// Index of the first element of [begin, end) equal to value, or end
+template<typename T>
+size_t find_in(const T* p, size_t begin, size_t end, const T &value) {
+	if constexpr (lane_find<T>::value) {
+		constexpr size_t w = lanes<T>;
+		const T x = value;
+		size_t i = begin;
+		// Compare whole blocks without branching, then look into the hit
+		for (; i + w <= end; i += w) {
+			unsigned hit = 0;
+			for (size_t j = 0; j < w; ++j) {
+				hit |= p[i + j] == x;
+			}
+			if (hit != 0) {
+				break;
+			}
+		}
+		for (; i < end; ++i) {
+			if (p[i] == x) {
+				return i;
+			}
+		}
+		return end;
+	} else {
+		return std::find(p + begin, p + end, value) - p;
+	}
+}
+
+template<typename T>
+size_t count_in(const T* p, size_t begin, size_t end, const T &value) {
+	if constexpr (std::is_arithmetic<T>::value) {
+		const T x = value;
+		size_t n = 0;
+		for (size_t i = begin; i < end; ++i) {
+			n += p[i] == x;
+		}
+		return n;
+	} else {
+		return std::count(p + begin, p + end, value);
+	}
+}
+
+/**
+ * the least and greatest of a non-empty [begin, end)
+ * Arithmetic elements with vector lanes are folded into one minimum and
+ * one maximum per lane, so that the lanes fit vector registers without
+ * reassociating floating point comparisons; NaNs are passed over unless
+ * they come first, as with std::min and std::max.
+ */
+template<typename T>
+pair<T, T> min_max_in(const T* p, size_t begin, size_t end) {
+	if constexpr (lane_min_max<T>::value) {
+		constexpr size_t w = lanes<T>;
+		T lo[w];
+		T hi[w];
+		for (size_t j = 0; j < w; ++j) {
+			lo[j] = p[begin];
+			hi[j] = p[begin];
+		}
+		size_t i = begin;
+		for (; i + w <= end; i += w) {
+			for (size_t j = 0; j < w; ++j) {
+				T x = p[i + j];
+				lo[j] = x < lo[j] ? x : lo[j];
+				hi[j] = hi[j] < x ? x : hi[j];
+			}
+		}
+		for (; i < end; ++i) {
+			lo[0] = p[i] < lo[0] ? p[i] : lo[0];
+			hi[0] = hi[0] < p[i] ? p[i] : hi[0];
+		}
+		for (size_t j = 1; j < w; ++j) {
+			lo[0] = lo[j] < lo[0] ? lo[j] : lo[0];
+			hi[0] = hi[0] < hi[j] ? hi[j] : hi[0];
+		}
+		return pair<T, T>(lo[0], hi[0]);
+	} else {
+		auto range = std::minmax_element(p + begin, p + end);
+		return pair<T, T>(*range.first, *range.second);
+	}
+}
+
+template<typename T>
+size_t find_index(const parallel_policy &policy, const T* p, size_t n, const T &value) {
+	thread_pool* pool;
+	chunking chunks = parallel_detail::split(policy, n, sizeof(T), pool);
+	std::atomic<size_t> found{n};
+	parallel_detail::run(pool, chunks, [&](size_t begin, size_t end) {
+		// Stop as soon as an earlier chunk has a match
+		for (size_t i = begin; i < end && found.load(std::memory_order_relaxed) > begin; i += stop_check) {
+			size_t last = std::min(i + stop_check, end);
+			size_t at = find_in(p, i, last, value);
+			if (at != last) {
+				size_t seen = found.load(std::memory_order_relaxed);
+				while (at < seen && !found.compare_exchange_weak(seen, at, std::memory_order_relaxed)) {
+				}
+				return;
+			}
+		}
+	});
+	return found.load();
+}
+}
+
+/**
+ * sorts v by comp
+ * Integral elements in the default order are radix sorted when there
+ * are many of them. Otherwise the chunks of v are introsorted
+ * concurrently and then merged pairwise, each round of merges cut into
+ * chunks again, through a buffer as large as v, which is built by
+ * moving v into it. comp must be safe to call from several threads.
+ * If it throws while the chunks are merged, v keeps its elements in an
+ * unspecified order; if it throws within a chunk, or a move throws,
+ * some elements may be left moved from, as after std::sort. Under seq,
+ * a short v or a single thread this is just std::sort.
+ */
+template<typename T, typename Alloc, typename Growth, typename Compare = std::less<T>>
+void sort(const parallel_policy &policy, vector<T, Alloc, Growth> &v, Compare comp = Compare()) {
+	size_t n = v.size();
+	if constexpr (algorithm_detail::radix_sortable<T, Compare>::value) {
+		if (n >= algorithm_detail::radix_threshold) {
+			vector<T, Alloc, Growth> scratch(v.get_allocator());
+			algorithm_detail::radix_sort(policy, v.data(), algorithm_detail::prepare_scratch(policy, scratch, n), n);
+			return;
+		}
+	}
+	thread_pool* pool;
+	parallel_detail::chunking chunks = parallel_detail::split(policy, n, sizeof(T), pool);
+	T* data = v.data();
+	if (chunks.count <= 1) {
+		std::sort(data, data + n, comp);
+		return;
+	}
+	parallel_detail::run(pool, chunks, [&comp, data](size_t begin, size_t end) {
+		std::sort(data + begin, data + end, comp);
+	});
+	vector<T, Alloc, Growth> scratch(v.get_allocator());
+	if constexpr (std::is_trivially_copyable<T>::value) {
+		algorithm_detail::merge_chunks(pool, chunks, data, algorithm_detail::prepare_scratch(policy, scratch, n), comp);
+	} else {
+		T* buffer = algorithm_detail::move_to_scratch(policy, scratch, data, n);
+		algorithm_detail::merge_chunks(pool, chunks, data, buffer, comp, true);
+	}
+}
+
+/**
+ * sorts v of integers by value, through scratch
+ * scratch is grown to v.size() elements if it is shorter and otherwise
+ * only written over, so that sorting many arrays with one scratch
+ * allocates nothing after the first.
+ */
+template<typename T, typename A1, typename G1, typename A2, typename G2>
+void radix_sort(const parallel_policy &policy, vector<T, A1, G1> &v, vector<T, A2, G2> &scratch) {
+	static_assert(std::is_integral<T>::value && !std::is_same<T, bool>::value, "radix_sort needs integers");
+	size_t n = v.size();
+	algorithm_detail::radix_sort(policy, v.data(), algorithm_detail::prepare_scratch(policy, scratch, n), n);
+}
+
+template<typename T, typename Alloc, typename Growth>
+void radix_sort(const parallel_policy &policy, vector<T, Alloc, Growth> &v) {
+	vector<T, Alloc, Growth> scratch(v.get_allocator());
+	radix_sort(policy, v, scratch);
+}
+
+/**
+ * sorts v by comp, keeping equal elements in their order
+ * The chunks of v are merge sorted concurrently and then merged
+ * pairwise, all through scratch, which is grown to v.size() elements
+ * if it is shorter and otherwise only assigned over; with a scratch
+ * kept between calls only a few offsets per chunk are allocated.
+ * Elements must be default constructible for scratch to grow. If comp
+ * throws, v keeps its elements in an unspecified order; if a move
+ * throws, some may be left moved from.
+ */
+template<typename T, typename A1, typename G1, typename A2, typename G2, typename Compare = std::less<T>>
+void stable_sort(const parallel_policy &policy, vector<T, A1, G1> &v, vector<T, A2, G2> &scratch,
+	Compare comp = Compare()) {
+	size_t n = v.size();
+	T* data = v.data();
+	T* buffer = algorithm_detail::prepare_scratch(policy, scratch, n);
+	thread_pool* pool;
+	parallel_detail::chunking chunks = parallel_detail::split(policy, n, sizeof(T), pool);
+	parallel_detail::run(pool, chunks, [&comp, data, buffer](size_t begin, size_t end) {
+		algorithm_detail::merge_sort(data + begin, buffer + begin, end - begin, comp);
+	});
+	algorithm_detail::merge_chunks(pool, chunks, data, buffer, comp);
+}
+
+template<typename T, typename Alloc, typename Growth, typename Compare = std::less<T>>
+void stable_sort(const parallel_policy &policy, vector<T, Alloc, Growth> &v, Compare comp = Compare()) {
+	vector<T, Alloc, Growth> scratch(v.get_allocator());
+	stable_sort(policy, v, scratch, comp);
+}
+
+/**
+ * appends the merge of a and b, both sorted by comp, to out
+ * Of equal elements those of a come first. The output is cut into
+ * chunks whose starts in a and b are found by binary search, and the
+ * chunks are copied concurrently. out must be neither a nor b; if a
+ * copy throws, out is left as it was.
+ */
+template<typename T, typename A1, typename G1, typename A2, typename G2, typename A3, typename G3,
+	typename Compare = std::less<T>>
+void merge(const parallel_policy &policy, const vector<T, A1, G1> &a, const vector<T, A2, G2> &b,
+	vector<T, A3, G3> &out, Compare comp = Compare()) {
+	size_t n = a.size() + b.size();
+	out.reserve(out.size() + n);
+	out.append_raw(n, [&](T* dest, size_t count) {
+		algorithm_detail::merge_construct(policy, a.data(), a.size(), b.data(), b.size(), dest, comp);
+		return count;
+	});
+}
+
+/**
+ * returns the first element of v equal to value, or end()
+ * Arithmetic elements are compared a block at a time where the target
+ * has vector compares for them; across chunks the earliest match wins
+ * and later chunks stop early.
+ */
+template<typename T, typename Alloc, typename Growth>
+typename vector<T, Alloc, Growth>::iterator find(const parallel_policy &policy, vector<T, Alloc, Growth> &v,
+	const T &value) {
+	return v.begin() + algorithm_detail::find_index(policy, v.data(), v.size(), value);
+}
+
+template<typename T, typename Alloc, typename Growth>
+typename vector<T, Alloc, Growth>::const_iterator find(const parallel_policy &policy,
+	const vector<T, Alloc, Growth> &v, const T &value) {
+	return v.cbegin() + algorithm_detail::find_index(policy, v.data(), v.size(), value);
+}
+
+/**
+ * returns the number of elements of v equal to value
+ */
+template<typename T, typename Alloc, typename Growth>
+size_t count(const parallel_policy &policy, const vector<T, Alloc, Growth> &v, const T &value) {
+	thread_pool* pool;
+	parallel_detail::chunking chunks = parallel_detail::split(policy, v.size(), sizeof(T), pool);
+	std::atomic<size_t> total{0};
+	const T* data = v.data();
+	parallel_detail::run(pool, chunks, [&](size_t begin, size_t end) {
+		total.fetch_add(algorithm_detail::count_in(data, begin, end, value), std::memory_order_relaxed);
+	});
+	return total.load();
+}
+
+/**
+ * returns the least and the greatest element of v
+ * throw container_is_empty if v is empty
+ */
+template<typename T, typename Alloc, typename Growth>
+pair<T, T> min_max(const parallel_policy &policy, const vector<T, Alloc, Growth> &v) {
+	if (v.empty()) {
+		throw container_is_empty("min_max");
+	}
+	thread_pool* pool;
+	parallel_detail::chunking chunks = parallel_detail::split(policy, v.size(), sizeof(T), pool);
+	const T* data = v.data();
+	if (chunks.count == 1) {
+		return algorithm_detail::min_max_in(data, 0, v.size());
+	}
+	// Chunks fold their own extremes into the first element's
+	pair<T, T> result(data[0], data[0]);
+	std::mutex lock;
+	parallel_detail::run(pool, chunks, [&](size_t begin, size_t end) {
+		pair<T, T> part = algorithm_detail::min_max_in(data, begin, end);
+		std::lock_guard<std::mutex> guard(lock);
+		if (part.first < result.first) {
+			result.first = part.first;
+		}
+		if (result.second < part.second) {
+			result.second = part.second;
+		}
+	});
+	return result;
+}
+
+}
+
+#endif
@@ -0,0 +1,401 @@
+#ifndef SJTU_ALLOCATOR_HPP
+#define SJTU_ALLOCATOR_HPP
+
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+
+namespace sjtu
+{
+/**
+ * a bump-pointer arena
+ * allocate() hands out memory from large blocks by advancing a pointer,
+ * and everything is given back at once by reset() or the destructor.
+ * Individual frees are ignored unless they return the newest allocation.
+ * Not thread-safe: use one arena per request or per thread.
+ */
+class arena
+{
+private:
+	struct alignas(std::max_align_t) block {
+		block* next;
+		size_t size;
+	};
+
+	block* head_;
+	char* cur_;
+	char* end_;
+	char* last_;
+	size_t block_size_;
+
+	static char* begin_of(block* b) {
+		return reinterpret_cast<char*>(b + 1);
+	}
+
+	static char* align_up(char* p, size_t align) {
+		uintptr_t v = reinterpret_cast<uintptr_t>(p);
+		return reinterpret_cast<char*>((v + align - 1) & ~(uintptr_t)(align - 1));
+	}
+
+	// Start a new block that can hold at least bytes aligned to align
+	void grow(size_t bytes, size_t align) {
+		size_t size = bytes + align > block_size_ ? bytes + align : block_size_;
+		block* b = static_cast<block*>(::operator new(sizeof(block) + size));
+		b->next = head_;
+		b->size = size;
+		head_ = b;
+		cur_ = begin_of(b);
+		end_ = cur_ + size;
+	}
+
+public:
+	explicit arena(size_t block_size = 64 * 1024)
+		: head_(nullptr), cur_(nullptr), end_(nullptr), last_(nullptr), block_size_(block_size) {}
+
+	arena(const arena &) = delete;
+	arena &operator=(const arena &) = delete;
+
+	~arena() {
+		while (head_ != nullptr) {
+			block* next = head_->next;
+			::operator delete(head_);
+			head_ = next;
+		}
+	}
+
+	void* allocate(size_t bytes, size_t align = alignof(std::max_align_t)) {
+		char* p = align_up(cur_, align);
+		if (cur_ == nullptr || p > end_ || (size_t)(end_ - p) < bytes) {
+			grow(bytes, align);
+			p = align_up(cur_, align);
+		}
+		cur_ = p + bytes;
+		last_ = p;
+		return p;
+	}
+
+	// Only the newest allocation is reclaimed, so a vector that grows and
+	// then shrinks again right away does not leave a hole behind.
+	void deallocate(void* p, size_t bytes) {
+		if (p != nullptr && static_cast<char*>(p) == last_ && last_ + bytes == cur_) {
+			cur_ = last_;
+			last_ = nullptr;
+		}
+	}
+
+	/**
+	 * frees everything allocated so far
+	 * the newest block is kept for reuse, all others are released.
+	 */
+	void reset() {
+		if (head_ == nullptr) {
+			return;
+		}
+		block* keep = head_;
+		block* b = head_->next;
+		while (b != nullptr) {
+			block* next = b->next;
+			::operator delete(b);
+			b = next;
+		}
+		keep->next = nullptr;
+		cur_ = begin_of(keep);
+		end_ = cur_ + keep->size;
+		last_ = nullptr;
+	}
+
+	// Returns the number of bytes held in blocks, used or not
+	size_t capacity() const {
+		size_t total = 0;
+		for (block* b = head_; b != nullptr; b = b->next) {
+			total += b->size;
+		}
+		return total;
+	}
+};
+
+/**
+ * a size-class pool
+ * requests up to max_class bytes are rounded up to a power of two and
+ * served from per-class free lists carved out of large blocks, so freed
+ * slots are reused without touching the global heap. Larger requests
+ * get their own allocation. reset() or the destructor releases it all.
+ * Not thread-safe.
+ */
+class pool
+{
+public:
+	static const size_t min_class = 16;
+	static const size_t max_class = 4096;
+
+private:
+	static const size_t class_count = 9;  // 16, 32, ..., 4096
+
+	struct node {
+		node* next;
+	};
+
+	struct alignas(std::max_align_t) block {
+		block* next;
+	};
+
+	struct alignas(std::max_align_t) large {
+		large* prev;
+		large* next;
+	};
+
+	node* free_[class_count];
+	block* blocks_;
+	large* large_;
+	size_t block_size_;
+
+	static size_t class_of(size_t bytes) {
+		size_t index = 0;
+		size_t size = min_class;
+		while (size < bytes) {
+			size <<= 1;
+			++index;
+		}
+		return index;
+	}
+
+	// Carve a new block into slots of the given class
+	void refill(size_t index) {
+		size_t slot = min_class << index;
+		size_t count = block_size_ / slot;
+		if (count == 0) {
+			count = 1;
+		}
+		block* b = static_cast<block*>(::operator new(sizeof(block) + slot * count));
+		b->next = blocks_;
+		blocks_ = b;
+		char* p = reinterpret_cast<char*>(b + 1);
+		for (size_t i = 0; i < count; ++i) {
+			node* n = reinterpret_cast<node*>(p + i * slot);
+			n->next = free_[index];
+			free_[index] = n;
+		}
+	}
+
+public:
+	explicit pool(size_t block_size = 64 * 1024) : blocks_(nullptr), large_(nullptr), block_size_(block_size) {
+		for (size_t i = 0; i < class_count; ++i) {
+			free_[i] = nullptr;
+		}
+	}
+
+	pool(const pool &) = delete;
+	pool &operator=(const pool &) = delete;
+
+	~pool() {
+		reset();
+	}
+
+	void* allocate(size_t bytes) {
+		if (bytes > max_class) {
+			large* l = static_cast<large*>(::operator new(sizeof(large) + bytes));
+			l->prev = nullptr;
+			l->next = large_;
+			if (large_ != nullptr) {
+				large_->prev = l;
+			}
+			large_ = l;
+			return l + 1;
+		}
+		size_t index = class_of(bytes);
+		if (free_[index] == nullptr) {
+			refill(index);
+		}
+		node* n = free_[index];
+		free_[index] = n->next;
+		return n;
+	}
+
+	// bytes must be the size passed to allocate()
+	void deallocate(void* p, size_t bytes) {
+		if (p == nullptr) {
+			return;
+		}
+		if (bytes > max_class) {
+			large* l = static_cast<large*>(p) - 1;
+			if (l->prev != nullptr) {
+				l->prev->next = l->next;
+			} else {
+				large_ = l->next;
+			}
+			if (l->next != nullptr) {
+				l->next->prev = l->prev;
+			}
+			::operator delete(l);
+			return;
+		}
+		size_t index = class_of(bytes);
+		node* n = static_cast<node*>(p);
+		n->next = free_[index];
+		free_[index] = n;
+	}
+
+	/**
+	 * frees everything allocated so far and returns all blocks to the heap
+	 */
+	void reset() {
+		while (blocks_ != nullptr) {
+			block* next = blocks_->next;
+			::operator delete(blocks_);
+			blocks_ = next;
+		}
+		while (large_ != nullptr) {
+			large* next = large_->next;
+			::operator delete(large_);
+			large_ = next;
+		}
+		for (size_t i = 0; i < class_count; ++i) {
+			free_[i] = nullptr;
+		}
+	}
+};
+
+/**
+ * std::allocator_traits-compatible allocator drawing from an arena
+ * Copies share the arena; storage lives until the arena is reset.
+ */
+template<typename T>
+class arena_allocator
+{
+public:
+	using value_type = T;
+	using propagate_on_container_move_assignment = std::true_type;
+	using propagate_on_container_swap = std::true_type;
+
+	arena_allocator(arena &a) noexcept : arena_(&a) {}
+
+	template<typename U>
+	arena_allocator(const arena_allocator<U> &other) noexcept : arena_(other.arena_) {}
+
+	T* allocate(size_t n) {
+		if (n > SIZE_MAX / sizeof(T)) {
+			throw std::bad_alloc();
+		}
+		return static_cast<T*>(arena_->allocate(n * sizeof(T), alignof(T)));
+	}
+
+	void deallocate(T* p, size_t n) noexcept {
+		arena_->deallocate(p, n * sizeof(T));
+	}
+
+	template<typename U>
+	bool operator==(const arena_allocator<U> &rhs) const {
+		return arena_ == rhs.arena_;
+	}
+
+	template<typename U>
+	bool operator!=(const arena_allocator<U> &rhs) const {
+		return arena_ != rhs.arena_;
+	}
+
+private:
+	template<typename U>
+	friend class arena_allocator;
+
+	arena* arena_;
+};
+
+/**
+ * std::allocator_traits-compatible allocator drawing from a pool
+ * Copies share the pool.
+ */
+template<typename T>
+class pool_allocator
+{
+	static_assert(alignof(T) <= alignof(std::max_align_t), "pool_allocator does not support over-aligned types");
+
+public:
+	using value_type = T;
+	using propagate_on_container_move_assignment = std::true_type;
+	using propagate_on_container_swap = std::true_type;
+
+	pool_allocator(pool &p) noexcept : pool_(&p) {}
+
+	template<typename U>
+	pool_allocator(const pool_allocator<U> &other) noexcept : pool_(other.pool_) {}
+
+	T* allocate(size_t n) {
+		if (n > SIZE_MAX / sizeof(T)) {
+			throw std::bad_alloc();
+		}
+		return static_cast<T*>(pool_->allocate(n * sizeof(T)));
+	}
+
+	void deallocate(T* p, size_t n) noexcept {
+		pool_->deallocate(p, n * sizeof(T));
+	}
+
+	template<typename U>
+	bool operator==(const pool_allocator<U> &rhs) const {
+		return pool_ == rhs.pool_;
+	}
+
+	template<typename U>
+	bool operator!=(const pool_allocator<U> &rhs) const {
+		return pool_ != rhs.pool_;
+	}
+
+private:
+	template<typename U>
+	friend class pool_allocator;
+
+	pool* pool_;
+};
+
+/**
+ * std::allocator_traits-compatible allocator returning storage aligned to
+ * Align bytes, for buffers that vector kernels walk a cache line or a
+ * SIMD register at a time. Stateless: all instances are equal.
+ */
+template<typename T, size_t Align = 64>
+class aligned_allocator
+{
+	static_assert(Align > 0 && (Align & (Align - 1)) == 0, "alignment must be a power of two");
+	static_assert(Align >= alignof(T), "alignment below that of the element type");
+
+public:
+	using value_type = T;
+	using is_always_equal = std::true_type;
+
+	template<typename U>
+	struct rebind {
+		using other = aligned_allocator<U, Align>;
+	};
+
+	aligned_allocator() noexcept {}
+
+	template<typename U>
+	aligned_allocator(const aligned_allocator<U, Align> &) noexcept {}
+
+	T* allocate(size_t n) {
+		if (n > SIZE_MAX / sizeof(T)) {
+			throw std::bad_alloc();
+		}
+		return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t(Align)));
+	}
+
+	void deallocate(T* p, size_t) noexcept {
+		::operator delete(p, std::align_val_t(Align));
+	}
+
+	template<typename U>
+	bool operator==(const aligned_allocator<U, Align> &) const {
+		return true;
+	}
+
+	template<typename U>
+	bool operator!=(const aligned_allocator<U, Align> &) const {
+		return false;
+	}
+};
+
+}
+
+#endif
@@ -0,0 +1,26 @@
+#ifndef SJTU_BITS_HPP
+#define SJTU_BITS_HPP
+
+#include <climits>
+#include <cstddef>
+
+namespace sjtu
+{
+/**
+ * the position of the highest set bit of x, which must not be zero
+ */
+inline size_t highest_bit(unsigned long long x) {
+#if defined(__GNUG__)
+	return sizeof(unsigned long long) * CHAR_BIT - 1 - __builtin_clzll(x);
+#else
+	size_t bit = 0;
+	while (x >>= 1) {
+		++bit;
+	}
+	return bit;
+#endif
+}
+
+}
+
+#endif
@@ -0,0 +1,430 @@
+#ifndef SJTU_CONCURRENT_VECTOR_HPP
+#define SJTU_CONCURRENT_VECTOR_HPP
+
+#include "bits.hpp"
+#include "exceptions.hpp"
+#include "iterator.hpp"
+
+#include <atomic>
+#include <climits>
+#include <cstddef>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+namespace sjtu
+{
+/**
+ * a vector that many threads may append to at once
+ * Elements live in segments of 8, 16, 32, ... slots that are never
+ * moved, so references and iterators stay valid while the vector grows.
+ * push_back() and grow_by() allocate any missing segment with a single
+ * compare-and-swap, then claim their slots with another on size. This
+ * is lock-free: a thread may retry when another claims first, but never
+ * waits for one, allocation aside. A failed allocation claims nothing.
+ * size() counts claimed slots, which may still be under construction:
+ * at() waits until its element is built, operator[] assumes it is
+ * (for instance because the writer returned, or was joined). If an
+ * element constructor throws, its slot stays empty and at() throws
+ * runtime_error for it.
+ * clear(), copying, moving and destruction must not race with anything.
+ */
+template<typename T>
+class concurrent_vector
+{
+public:
+	using value_type = T;
+	using size_type = size_t;
+	using difference_type = std::ptrdiff_t;
+	using reference = T&;
+	using const_reference = const T&;
+	using pointer = T*;
+	using const_pointer = const T*;
+
+private:
+	enum slot_state : unsigned char { pending, ready, broken };
+
+	struct slot {
+		alignas(T) unsigned char storage[sizeof(T)];
+		std::atomic<unsigned char> state;
+
+		T* get() {
+			return reinterpret_cast<T*>(storage);
+		}
+
+		const T* get() const {
+			return reinterpret_cast<const T*>(storage);
+		}
+	};
+
+	static constexpr size_t base_bits = 3;
+	static constexpr size_t base = size_t(1) << base_bits;
+	static constexpr size_t max_segments = sizeof(size_t) * CHAR_BIT - base_bits;
+
+	std::atomic<slot*> segments_[max_segments];
+	std::atomic<size_t> size_;
+
+	// Segment k holds base << k slots, for indices from base * (2^k - 1)
+	static size_t segment_of(size_t index) {
+		return highest_bit(index + base) - base_bits;
+	}
+
+	static size_t segment_size(size_t k) {
+		return base << k;
+	}
+
+	static size_t segment_start(size_t k) {
+		return (base << k) - base;
+	}
+
+	// Over-aligned elements need the aligned operator new for their slots
+	static slot* allocate_segment(size_t n) {
+		if constexpr (alignof(slot) > __STDCPP_DEFAULT_NEW_ALIGNMENT__) {
+			return static_cast<slot*>(::operator new(n * sizeof(slot), std::align_val_t(alignof(slot))));
+		} else {
+			return static_cast<slot*>(::operator new(n * sizeof(slot)));
+		}
+	}
+
+	static void free_segment(slot* s) {
+		if constexpr (alignof(slot) > __STDCPP_DEFAULT_NEW_ALIGNMENT__) {
+			::operator delete(s, std::align_val_t(alignof(slot)));
+		} else {
+			::operator delete(s);
+		}
+	}
+
+	// Returns segment k, allocating it if no thread has done so yet
+	slot* segment(size_t k) {
+		slot* s = segments_[k].load(std::memory_order_acquire);
+		if (s != nullptr) {
+			return s;
+		}
+		size_t n = segment_size(k);
+		slot* fresh = allocate_segment(n);
+		for (size_t i = 0; i < n; ++i) {
+			new (&fresh[i].state) std::atomic<unsigned char>(pending);
+		}
+		if (segments_[k].compare_exchange_strong(s, fresh, std::memory_order_acq_rel, std::memory_order_acquire)) {
+			return fresh;
+		}
+		// Another thread won, s now holds its segment
+		free_segment(fresh);
+		return s;
+	}
+
+	slot &slot_at(size_t index) {
+		size_t k = segment_of(index);
+		return segments_[k].load(std::memory_order_acquire)[index - segment_start(k)];
+	}
+
+	const slot &slot_at(size_t index) const {
+		size_t k = segment_of(index);
+		return segments_[k].load(std::memory_order_acquire)[index - segment_start(k)];
+	}
+
+	// Make sure every segment covering [first, last) exists
+	void cover(size_t first, size_t last) {
+		if (first == last) {
+			return;
+		}
+		for (size_t k = segment_of(first); k <= segment_of(last - 1); ++k) {
+			segment(k);
+		}
+	}
+
+	template<typename... Args>
+	void construct_at(size_t index, Args&&... args) {
+		slot &s = slot_at(index);
+		try {
+			new (s.get()) T(std::forward<Args>(args)...);
+		} catch (...) {
+			s.state.store(broken, std::memory_order_release);
+			throw;
+		}
+		s.state.store(ready, std::memory_order_release);
+	}
+
+	// Claim n slots, whose segments exist before size() covers them
+	size_t claim(size_t n) {
+		size_t first = size_.load(std::memory_order_acquire);
+		do {
+			cover(first, first + n);
+		} while (!size_.compare_exchange_weak(first, first + n, std::memory_order_acq_rel, std::memory_order_acquire));
+		return first;
+	}
+
+	const slot &wait_ready(size_t index) const {
+		const slot &s = slot_at(index);
+		unsigned char st;
+		while ((st = s.state.load(std::memory_order_acquire)) == pending) {
+			std::this_thread::yield();
+		}
+		if (st == broken) {
+			throw runtime_error();
+		}
+		return s;
+	}
+
+	void destroy_all() {
+		size_t n = size_.load(std::memory_order_relaxed);
+		for (size_t k = 0; k < max_segments; ++k) {
+			slot* s = segments_[k].load(std::memory_order_relaxed);
+			if (s == nullptr) {
+				continue;
+			}
+			size_t start = segment_start(k);
+			for (size_t i = 0; i < segment_size(k) && start + i < n; ++i) {
+				if (s[i].state.load(std::memory_order_relaxed) == ready) {
+					s[i].get()->~T();
+				}
+				s[i].state.store(pending, std::memory_order_relaxed);
+			}
+		}
+		size_.store(0, std::memory_order_relaxed);
+	}
+
+	void free_segments() {
+		for (size_t k = 0; k < max_segments; ++k) {
+			free_segment(segments_[k].load(std::memory_order_relaxed));
+			segments_[k].store(nullptr, std::memory_order_relaxed);
+		}
+	}
+
+public:
+	using iterator = indexed_iterator<concurrent_vector, T>;
+	using const_iterator = indexed_iterator<concurrent_vector, const T>;
+	using reverse_iterator = std::reverse_iterator<iterator>;
+	using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+	concurrent_vector() : size_(0) {
+		for (size_t k = 0; k < max_segments; ++k) {
+			segments_[k].store(nullptr, std::memory_order_relaxed);
+		}
+	}
+
+	// The delegated constructor has run, so a throwing copy is cleaned up
+	// by the destructor
+	concurrent_vector(const concurrent_vector &other) : concurrent_vector() {
+		size_t n = other.size();
+		cover(0, n);
+		for (size_t i = 0; i < n; ++i) {
+			size_.store(i + 1, std::memory_order_relaxed);
+			construct_at(i, *other.wait_ready(i).get());
+		}
+	}
+
+	concurrent_vector(concurrent_vector &&other) noexcept : size_(other.size_.load(std::memory_order_relaxed)) {
+		for (size_t k = 0; k < max_segments; ++k) {
+			segments_[k].store(other.segments_[k].load(std::memory_order_relaxed), std::memory_order_relaxed);
+			other.segments_[k].store(nullptr, std::memory_order_relaxed);
+		}
+		other.size_.store(0, std::memory_order_relaxed);
+	}
+
+	concurrent_vector &operator=(const concurrent_vector &other) {
+		if (this != &other) {
+			concurrent_vector tmp(other);
+			*this = std::move(tmp);
+		}
+		return *this;
+	}
+
+	concurrent_vector &operator=(concurrent_vector &&other) noexcept {
+		if (this != &other) {
+			destroy_all();
+			free_segments();
+			for (size_t k = 0; k < max_segments; ++k) {
+				segments_[k].store(other.segments_[k].load(std::memory_order_relaxed), std::memory_order_relaxed);
+				other.segments_[k].store(nullptr, std::memory_order_relaxed);
+			}
+			size_.store(other.size_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+			other.size_.store(0, std::memory_order_relaxed);
+		}
+		return *this;
+	}
+
+	~concurrent_vector() {
+		destroy_all();
+		free_segments();
+	}
+
+	/**
+	 * returns the element at pos, waiting for a concurrent writer to
+	 * finish constructing it
+	 * throws index_out_of_bound past size(), runtime_error if its
+	 * constructor threw
+	 */
+	T & at(const size_t &pos) {
+		if (pos >= size()) {
+			throw index_out_of_bound();
+		}
+		return *const_cast<slot &>(wait_ready(pos)).get();
+	}
+
+	const T & at(const size_t &pos) const {
+		if (pos >= size()) {
+			throw index_out_of_bound();
+		}
+		return *wait_ready(pos).get();
+	}
+
+	// Checked only under SJTU_VECTOR_CHECKED, as in vector
+	T & operator[](const size_t &pos) {
+#if SJTU_VECTOR_CHECKED
+		if (pos >= size()) {
+			throw index_out_of_bound();
+		}
+#endif
+		return *slot_at(pos).get();
+	}
+
+	const T & operator[](const size_t &pos) const {
+#if SJTU_VECTOR_CHECKED
+		if (pos >= size()) {
+			throw index_out_of_bound();
+		}
+#endif
+		return *slot_at(pos).get();
+	}
+
+	const T & front() const {
+		if (size() == 0) {
+			throw container_is_empty();
+		}
+		return at(0);
+	}
+
+	const T & back() const {
+		if (size() == 0) {
+			throw container_is_empty();
+		}
+		return at(size() - 1);
+	}
+
+	iterator begin() {
+		return iterator(this, 0);
+	}
+
+	const_iterator begin() const {
+		return const_iterator(this, 0);
+	}
+
+	const_iterator cbegin() const {
+		return const_iterator(this, 0);
+	}
+
+	iterator end() {
+		return iterator(this, size());
+	}
+
+	const_iterator end() const {
+		return const_iterator(this, size());
+	}
+
+	const_iterator cend() const {
+		return const_iterator(this, size());
+	}
+
+	reverse_iterator rbegin() {
+		return reverse_iterator(end());
+	}
+
+	const_reverse_iterator rbegin() const {
+		return const_reverse_iterator(end());
+	}
+
+	reverse_iterator rend() {
+		return reverse_iterator(begin());
+	}
+
+	const_reverse_iterator rend() const {
+		return const_reverse_iterator(begin());
+	}
+
+	bool empty() const {
+		return size() == 0;
+	}
+
+	// Returns the number of claimed slots
+	size_t size() const {
+		return size_.load(std::memory_order_acquire);
+	}
+
+	// Returns the number of slots in allocated segments
+	size_t capacity() const {
+		size_t total = 0;
+		for (size_t k = 0; k < max_segments; ++k) {
+			if (segments_[k].load(std::memory_order_acquire) != nullptr) {
+				total += segment_size(k);
+			}
+		}
+		return total;
+	}
+
+	/**
+	 * allocates the segments for new_capacity elements up front
+	 * safe to call while other threads append
+	 */
+	void reserve(const size_t &new_capacity) {
+		cover(0, new_capacity);
+	}
+
+	/**
+	 * destroys every element, keeping the segments
+	 * must not run concurrently with anything else
+	 */
+	void clear() {
+		destroy_all();
+	}
+
+	/**
+	 * appends value and returns an iterator to it
+	 */
+	iterator push_back(const T &value) {
+		return emplace(value);
+	}
+
+	iterator push_back(T &&value) {
+		return emplace(std::move(value));
+	}
+
+	template<typename... Args>
+	T & emplace_back(Args&&... args) {
+		return *emplace(std::forward<Args>(args)...);
+	}
+
+	/**
+	 * appends n copies of value in one reservation
+	 * returns an iterator to the first of them
+	 */
+	iterator grow_by(const size_t &n, const T &value = T()) {
+		size_t first = claim(n);
+		size_t i = 0;
+		try {
+			for (; i < n; ++i) {
+				construct_at(first + i, value);
+			}
+		} catch (...) {
+			// Slot i is marked already, the rest will never be built
+			for (++i; i < n; ++i) {
+				slot_at(first + i).state.store(broken, std::memory_order_release);
+			}
+			throw;
+		}
+		return iterator(this, first);
+	}
+
+private:
+	template<typename... Args>
+	iterator emplace(Args&&... args) {
+		size_t index = claim(1);
+		construct_at(index, std::forward<Args>(args)...);
+		return iterator(this, index);
+	}
+};
+
+}
+
+#endif
@@ -0,0 +1,706 @@
+#ifndef SJTU_DEVECTOR_HPP
+#define SJTU_DEVECTOR_HPP
+
+#include "exceptions.hpp"
+#include "iterator.hpp"
+#include "vector.hpp"
+
+#include <cstddef>
+#include <cstring>
+#include <iterator>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace sjtu
+{
+/**
+ * a contiguous vector with free space at both ends
+ * The elements start at a movable offset into the buffer, so
+ * push_front(), pop_front() and erasing near the front are amortized
+ * O(1), and an insert or erase in the middle shifts whichever side is
+ * shorter. When the side to be shifted has no room left, the elements
+ * are re-centred in a buffer with at least as much free space as there
+ * are elements, in place when the capacity allows.
+ * The interface and exceptions are those of sjtu::vector, plus the
+ * front operations; data() points at the first element.
+ */
+template<typename T>
+class devector
+{
+public:
+	using value_type = T;
+	using size_type = size_t;
+	using difference_type = std::ptrdiff_t;
+	using reference = T&;
+	using const_reference = const T&;
+	using pointer = T*;
+	using const_pointer = const T*;
+
+private:
+	T* buffer_;
+	T* data_;
+	size_t size_;
+	size_t capacity_;
+
+	static constexpr bool trivial_relocate = is_trivially_relocatable<T>::value;
+	// Elements may be shifted into raw slots in place only if that cannot throw
+	static constexpr bool nothrow_relocate = trivial_relocate || std::is_nothrow_move_constructible<T>::value;
+
+	static T* allocate(size_t n) {
+		return n == 0 ? nullptr : static_cast<T*>(::operator new(n * sizeof(T)));
+	}
+
+	static void destroy_n(T* first, size_t n) {
+		if constexpr (!std::is_trivially_destructible<T>::value) {
+			for (size_t i = 0; i < n; ++i) {
+				first[i].~T();
+			}
+		}
+	}
+
+	size_t front_room() const {
+		return data_ - buffer_;
+	}
+
+	size_t back_room() const {
+		return capacity_ - front_room() - size_;
+	}
+
+	// Move n elements from src to dst, which may overlap; the slots of
+	// dst not covered by src must be raw. Only used when nothrow_relocate.
+	static void shift(T* src, size_t n, T* dst) {
+		if (n == 0 || src == dst) {
+			return;
+		}
+		if constexpr (trivial_relocate) {
+			std::memmove(static_cast<void*>(dst), static_cast<const void*>(src), n * sizeof(T));
+		} else if (dst < src) {
+			for (size_t i = 0; i < n; ++i) {
+				new (dst + i) T(std::move(src[i]));
+				src[i].~T();
+			}
+		} else {
+			for (size_t i = n; i > 0; --i) {
+				new (dst + i - 1) T(std::move(src[i - 1]));
+				src[i - 1].~T();
+			}
+		}
+	}
+
+	// Move-construct n elements of src into raw storage at dst, undoing
+	// them if a copy throws; sources stay alive
+	static void relocate_into(T* src, size_t n, T* dst) {
+		if constexpr (trivial_relocate) {
+			if (n > 0) {
+				std::memcpy(static_cast<void*>(dst), static_cast<const void*>(src), n * sizeof(T));
+			}
+		} else {
+			size_t i = 0;
+			try {
+				for (; i < n; ++i) {
+					new (dst + i) T(std::move_if_noexcept(src[i]));
+				}
+			} catch (...) {
+				destroy_n(dst, i);
+				throw;
+			}
+		}
+	}
+
+	// Open n raw slots at ind by shifting the shorter side, false if that
+	// side has no room
+	bool shift_open(size_t ind, size_t n) {
+		if (ind * 2 < size_) {
+			if (front_room() < n) {
+				return false;
+			}
+			shift(data_, ind, data_ - n);
+			data_ -= n;
+		} else {
+			if (back_room() < n) {
+				return false;
+			}
+			shift(data_ + ind, size_ - ind, data_ + ind + n);
+		}
+		size_ += n;
+		return true;
+	}
+
+	// Undo shift_open (or a re-centring) after the gap failed to fill
+	void shift_close(size_t ind, size_t n) {
+		if (ind * 2 < size_ - n) {
+			shift(data_, ind, data_ + n);
+			data_ += n;
+		} else {
+			shift(data_ + ind + n, size_ - ind - n, data_ + ind);
+		}
+		size_ -= n;
+	}
+
+	/**
+	 * moves the elements around a gap of n slots at ind into a buffer of
+	 * new_capacity, starting new_front slots in, then lets fill(T*)
+	 * construct the gap. fill must construct all n elements or none.
+	 * Strong guarantee: on an exception nothing has changed.
+	 */
+	template<typename F>
+	void relocate_to(size_t new_capacity, size_t new_front, size_t ind, size_t n, F fill) {
+		if constexpr (nothrow_relocate) {
+			if (new_capacity == capacity_ && buffer_ != nullptr) {
+				// Re-centre in place: the part moving right goes first
+				T* data = buffer_ + new_front;
+				if (data >= data_) {
+					shift(data_ + ind, size_ - ind, data + ind + n);
+					shift(data_, ind, data);
+				} else {
+					shift(data_, ind, data);
+					shift(data_ + ind, size_ - ind, data + ind + n);
+				}
+				data_ = data;
+				size_ += n;
+				try {
+					fill(data_ + ind);
+				} catch (...) {
+					shift_close(ind, n);
+					throw;
+				}
+				return;
+			}
+		}
+
+		T* buffer = allocate(new_capacity);
+		T* data = buffer + new_front;
+		try {
+			fill(data + ind);
+		} catch (...) {
+			::operator delete(buffer);
+			throw;
+		}
+		try {
+			relocate_into(data_, ind, data);
+		} catch (...) {
+			destroy_n(data + ind, n);
+			::operator delete(buffer);
+			throw;
+		}
+		try {
+			relocate_into(data_ + ind, size_ - ind, data + ind + n);
+		} catch (...) {
+			destroy_n(data, ind + n);
+			::operator delete(buffer);
+			throw;
+		}
+		if constexpr (!trivial_relocate) {
+			destroy_n(data_, size_);
+		}
+		::operator delete(buffer_);
+		buffer_ = buffer;
+		data_ = data;
+		size_ += n;
+		capacity_ = new_capacity;
+	}
+
+	/**
+	 * inserts n elements built by fill(T*) at ind
+	 * Shifts the shorter side when it has room; otherwise re-centres the
+	 * elements with as much free space as they take.
+	 */
+	template<typename F>
+	void insert_gap(size_t ind, size_t n, F fill) {
+		if (n == 0) {
+			return;
+		}
+		if constexpr (nothrow_relocate) {
+			if (shift_open(ind, n)) {
+				try {
+					fill(data_ + ind);
+				} catch (...) {
+					shift_close(ind, n);
+					throw;
+				}
+				return;
+			}
+		}
+		size_t required = size_ + n;
+		size_t new_capacity = capacity_ >= 2 * required ? capacity_ : 2 * required;
+		relocate_to(new_capacity, (new_capacity - required) / 2, ind, n, fill);
+	}
+
+	// fill for one element, built from a temporary so that arguments
+	// referring into the vector are read before anything moves
+	struct move_one {
+		T &value;
+		void operator()(T* dest) const {
+			new (dest) T(std::move_if_noexcept(value));
+		}
+	};
+
+	struct copy_n {
+		const T &value;
+		size_t n;
+		void operator()(T* dest) const {
+			size_t i = 0;
+			try {
+				for (; i < n; ++i) {
+					new (dest + i) T(value);
+				}
+			} catch (...) {
+				destroy_n(dest, i);
+				throw;
+			}
+		}
+	};
+
+	template<typename It>
+	struct copy_range {
+		It first;
+		size_t n;
+		void operator()(T* dest) const {
+			It it = first;
+			size_t i = 0;
+			try {
+				for (; i < n; ++i, ++it) {
+					new (dest + i) T(*it);
+				}
+			} catch (...) {
+				destroy_n(dest, i);
+				throw;
+			}
+		}
+	};
+
+	template<typename... Args>
+	void emplace_at(size_t ind, Args&&... args) {
+		// With room at the end that is written, nothing shifts
+		if (ind == size_ && back_room() > 0) {
+			new (data_ + size_) T(std::forward<Args>(args)...);
+			++size_;
+			return;
+		}
+		if (ind == 0 && front_room() > 0) {
+			new (data_ - 1) T(std::forward<Args>(args)...);
+			--data_;
+			++size_;
+			return;
+		}
+		T tmp(std::forward<Args>(args)...);
+		insert_gap(ind, 1, move_one{tmp});
+	}
+
+	// Destroy n elements at ind and close the hole from the shorter side
+	void erase_n(size_t ind, size_t n) {
+		if (n == 0) {
+			return;
+		}
+		size_t after = size_ - ind - n;
+		if (ind < after) {
+			if constexpr (trivial_relocate) {
+				destroy_n(data_ + ind, n);
+				std::memmove(static_cast<void*>(data_ + n), static_cast<const void*>(data_), ind * sizeof(T));
+			} else {
+				for (size_t i = ind + n; i > n; --i) {
+					data_[i - 1] = std::move(data_[i - 1 - n]);
+				}
+				destroy_n(data_, n);
+			}
+			data_ += n;
+		} else {
+			if constexpr (trivial_relocate) {
+				destroy_n(data_ + ind, n);
+				std::memmove(static_cast<void*>(data_ + ind), static_cast<const void*>(data_ + ind + n), after * sizeof(T));
+			} else {
+				for (size_t i = ind; i < ind + after; ++i) {
+					data_[i] = std::move(data_[i + n]);
+				}
+				destroy_n(data_ + ind + after, n);
+			}
+		}
+		size_ -= n;
+	}
+
+	void release() {
+		destroy_n(data_, size_);
+		::operator delete(buffer_);
+		buffer_ = data_ = nullptr;
+		size_ = capacity_ = 0;
+	}
+
+	void steal(devector &other) {
+		buffer_ = other.buffer_;
+		data_ = other.data_;
+		size_ = other.size_;
+		capacity_ = other.capacity_;
+		other.buffer_ = other.data_ = nullptr;
+		other.size_ = other.capacity_ = 0;
+	}
+
+	static void nothing(T*) {}
+
+public:
+	using iterator = contiguous_iterator<devector, T>;
+	using const_iterator = contiguous_iterator<devector, const T>;
+	using reverse_iterator = std::reverse_iterator<iterator>;
+	using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+	devector() : buffer_(nullptr), data_(nullptr), size_(0), capacity_(0) {}
+
+	devector(const devector &other) : devector() {
+		buffer_ = data_ = allocate(other.size_);
+		capacity_ = other.size_;
+		try {
+			copy_range<const T*>{other.data_, other.size_}(data_);
+		} catch (...) {
+			::operator delete(buffer_);
+			throw;
+		}
+		size_ = other.size_;
+	}
+
+	devector(devector &&other) noexcept : devector() {
+		steal(other);
+	}
+
+	~devector() {
+		release();
+	}
+
+	// Reuses the buffer when it is large enough, centring the copy in it
+	devector &operator=(const devector &other) {
+		if (this == &other) {
+			return *this;
+		}
+		if (other.size_ > capacity_) {
+			devector tmp(other);
+			release();
+			steal(tmp);
+			return *this;
+		}
+		clear();
+		data_ = buffer_ + (capacity_ - other.size_) / 2;
+		copy_range<const T*>{other.data_, other.size_}(data_);
+		size_ = other.size_;
+		return *this;
+	}
+
+	devector &operator=(devector &&other) noexcept {
+		if (this != &other) {
+			release();
+			steal(other);
+		}
+		return *this;
+	}
+
+	T & at(const size_t &pos) {
+		if (pos >= size_) {
+			throw index_out_of_bound();
+		}
+		return data_[pos];
+	}
+
+	const T & at(const size_t &pos) const {
+		if (pos >= size_) {
+			throw index_out_of_bound();
+		}
+		return data_[pos];
+	}
+
+	// Checked only under SJTU_VECTOR_CHECKED, as in vector
+	T & operator[](const size_t &pos) {
+#if SJTU_VECTOR_CHECKED
+		if (pos >= size_) {
+			throw index_out_of_bound();
+		}
+#endif
+		return data_[pos];
+	}
+
+	const T & operator[](const size_t &pos) const {
+#if SJTU_VECTOR_CHECKED
+		if (pos >= size_) {
+			throw index_out_of_bound();
+		}
+#endif
+		return data_[pos];
+	}
+
+	const T & front() const {
+#if SJTU_VECTOR_CHECKED
+		if (size_ == 0) {
+			throw container_is_empty();
+		}
+#endif
+		return data_[0];
+	}
+
+	const T & back() const {
+#if SJTU_VECTOR_CHECKED
+		if (size_ == 0) {
+			throw container_is_empty();
+		}
+#endif
+		return data_[size_ - 1];
+	}
+
+	T * data() {
+		return data_;
+	}
+
+	const T * data() const {
+		return data_;
+	}
+
+	iterator begin() {
+		return iterator(data_, this);
+	}
+
+	const_iterator begin() const {
+		return const_iterator(data_, this);
+	}
+
+	const_iterator cbegin() const {
+		return const_iterator(data_, this);
+	}
+
+	iterator end() {
+		return iterator(data_ + size_, this);
+	}
+
+	const_iterator end() const {
+		return const_iterator(data_ + size_, this);
+	}
+
+	const_iterator cend() const {
+		return const_iterator(data_ + size_, this);
+	}
+
+	reverse_iterator rbegin() {
+		return reverse_iterator(end());
+	}
+
+	const_reverse_iterator rbegin() const {
+		return const_reverse_iterator(end());
+	}
+
+	const_reverse_iterator crbegin() const {
+		return const_reverse_iterator(cend());
+	}
+
+	reverse_iterator rend() {
+		return reverse_iterator(begin());
+	}
+
+	const_reverse_iterator rend() const {
+		return const_reverse_iterator(begin());
+	}
+
+	const_reverse_iterator crend() const {
+		return const_reverse_iterator(cbegin());
+	}
+
+	bool empty() const {
+		return size_ == 0;
+	}
+
+	size_t size() const {
+		return size_;
+	}
+
+	size_t capacity() const {
+		return capacity_;
+	}
+
+	// Returns how many elements push_front() can add without moving anything
+	size_t front_capacity() const {
+		return front_room();
+	}
+
+	/**
+	 * makes room for new_capacity elements from the current first one,
+	 * so that push_back() up to that size does not reallocate
+	 */
+	void reserve(const size_t &new_capacity) {
+		if (new_capacity > capacity_ - front_room()) {
+			relocate_to(front_room() + new_capacity, front_room(), size_, 0, nothing);
+		}
+	}
+
+	/**
+	 * releases all free space at both ends
+	 */
+	void shrink_to_fit() {
+		if (capacity_ > size_) {
+			if (size_ == 0) {
+				release();
+			} else {
+				relocate_to(size_, 0, size_, 0, nothing);
+			}
+		}
+	}
+
+	void resize(const size_t &count) {
+		if (count > size_) {
+			reserve(count);
+		}
+		while (size_ < count) {
+			emplace_back();
+		}
+		if (size_ > count) {
+			erase_n(count, size_ - count);
+		}
+	}
+
+	void resize(const size_t &count, const T &value) {
+		if (count > size_) {
+			insert(cend(), count - size_, value);
+		} else {
+			erase_n(count, size_ - count);
+		}
+	}
+
+	// Destroys every element and moves the start back to the middle
+	void clear() {
+		destroy_n(data_, size_);
+		size_ = 0;
+		data_ = buffer_ + capacity_ / 2;
+	}
+
+	iterator insert(const_iterator pos, const T &value) {
+		return insert((size_t)(pos.ptr_ - data_), value);
+	}
+
+	iterator insert(const_iterator pos, T &&value) {
+		return insert((size_t)(pos.ptr_ - data_), std::move(value));
+	}
+
+	iterator insert(const size_t &ind, const T &value) {
+		if (ind > size_) {
+			throw index_out_of_bound();
+		}
+		emplace_at(ind, value);
+		return iterator(data_ + ind, this);
+	}
+
+	iterator insert(const size_t &ind, T &&value) {
+		if (ind > size_) {
+			throw index_out_of_bound();
+		}
+		emplace_at(ind, std::move(value));
+		return iterator(data_ + ind, this);
+	}
+
+	iterator insert(const_iterator pos, const size_t &count, const T &value) {
+		size_t index = pos.ptr_ - data_;
+		if (index > size_) {
+			throw index_out_of_bound();
+		}
+		if (&value >= data_ && &value < data_ + size_) {
+			T tmp(value);
+			insert_gap(index, count, copy_n{tmp, count});
+		} else {
+			insert_gap(index, count, copy_n{value, count});
+		}
+		return iterator(data_ + index, this);
+	}
+
+	/**
+	 * inserts [first, last) before pos, the range must not point into
+	 * this devector
+	 */
+	template<typename InputIt, typename = require_input_iterator<InputIt>>
+	iterator insert(const_iterator pos, InputIt first, InputIt last) {
+		size_t index = pos.ptr_ - data_;
+		if (index > size_) {
+			throw index_out_of_bound();
+		}
+		if constexpr (is_forward_iterator<InputIt>::value) {
+			insert_gap(index, std::distance(first, last), copy_range<InputIt>{first, (size_t)std::distance(first, last)});
+		} else {
+			for (size_t i = index; first != last; ++first, ++i) {
+				emplace_at(i, *first);
+			}
+		}
+		return iterator(data_ + index, this);
+	}
+
+	template<typename... Args>
+	iterator emplace(const_iterator pos, Args&&... args) {
+		size_t index = pos.ptr_ - data_;
+		if (index > size_) {
+			throw index_out_of_bound();
+		}
+		emplace_at(index, std::forward<Args>(args)...);
+		return iterator(data_ + index, this);
+	}
+
+	iterator erase(const_iterator pos) {
+		return erase((size_t)(pos.ptr_ - data_));
+	}
+
+	iterator erase(const size_t &ind) {
+		if (ind >= size_) {
+			throw index_out_of_bound();
+		}
+		erase_n(ind, 1);
+		return iterator(data_ + ind, this);
+	}
+
+	iterator erase(const_iterator first, const_iterator last) {
+		size_t from = first.ptr_ - data_;
+		size_t to = last.ptr_ - data_;
+		if (from > to || to > size_) {
+			throw index_out_of_bound();
+		}
+		erase_n(from, to - from);
+		return iterator(data_ + from, this);
+	}
+
+	void push_back(const T &value) {
+		emplace_at(size_, value);
+	}
+
+	void push_back(T &&value) {
+		emplace_at(size_, std::move(value));
+	}
+
+	template<typename... Args>
+	T & emplace_back(Args&&... args) {
+		emplace_at(size_, std::forward<Args>(args)...);
+		return data_[size_ - 1];
+	}
+
+	void pop_back() {
+		if (size_ == 0) {
+			throw container_is_empty();
+		}
+		destroy_n(data_ + size_ - 1, 1);
+		--size_;
+	}
+
+	void push_front(const T &value) {
+		emplace_at(0, value);
+	}
+
+	void push_front(T &&value) {
+		emplace_at(0, std::move(value));
+	}
+
+	template<typename... Args>
+	T & emplace_front(Args&&... args) {
+		emplace_at(0, std::forward<Args>(args)...);
+		return data_[0];
+	}
+
+	void pop_front() {
+		if (size_ == 0) {
+			throw container_is_empty();
+		}
+		destroy_n(data_, 1);
+		++data_;
+		--size_;
+	}
+};
+
+}
+
+#endif
@@ -3,39 +3,86 @@
 
 #include <cstddef>
 #include <cstring>
-#include <string>
+#include <exception>
 
 namespace sjtu {
 
-class exception {
+/**
+ * base of the exceptions thrown by the containers
+ * The message is kept in a fixed buffer inside the object: the name of
+ * the exception, a string literal, optionally followed by ": " and a
+ * detail, cut short if it does not fit. Constructing, copying and
+ * throwing one never allocates, and what() cannot fail.
+ */
+class exception : public std::exception {
+   public:
+    static constexpr size_t message_capacity = 96;
+
    protected:
-    const std::string variant = "";
-    std::string detail = "";
+    const char *variant_;
+    char message_[message_capacity];
+
+    exception(const char *variant, const char *detail) noexcept : variant_(variant) {
+        size_t n = 0;
+        for (const char *p = variant; *p != '\0' && n + 1 < message_capacity; ++p) {
+            message_[n++] = *p;
+        }
+        if (detail != nullptr && *detail != '\0') {
+            for (const char *p = ": "; *p != '\0' && n + 1 < message_capacity; ++p) {
+                message_[n++] = *p;
+            }
+            for (const char *p = detail; *p != '\0' && n + 1 < message_capacity; ++p) {
+                message_[n++] = *p;
+            }
+        }
+        message_[n] = '\0';
+    }
 
    public:
-    exception() {
+    exception() noexcept : exception("exception", nullptr) {
     }
-    exception(const exception &ec) : variant(ec.variant), detail(ec.detail) {
+    explicit exception(const char *detail) noexcept : exception("exception", detail) {
     }
-    virtual std::string what() {
-        return variant + " " + detail;
+
+    // The name alone, without the detail
+    const char *variant() const noexcept {
+        return variant_;
+    }
+    const char *what() const noexcept override {
+        return message_;
     }
 };
 
 class index_out_of_bound : public exception {
-    /* __________________________ */
+   public:
+    index_out_of_bound() noexcept : exception("index_out_of_bound", nullptr) {
+    }
+    explicit index_out_of_bound(const char *detail) noexcept : exception("index_out_of_bound", detail) {
+    }
 };
 
 class runtime_error : public exception {
-    /* __________________________ */
+   public:
+    runtime_error() noexcept : exception("runtime_error", nullptr) {
+    }
+    explicit runtime_error(const char *detail) noexcept : exception("runtime_error", detail) {
+    }
 };
 
 class invalid_iterator : public exception {
-    /* __________________________ */
+   public:
+    invalid_iterator() noexcept : exception("invalid_iterator", nullptr) {
+    }
+    explicit invalid_iterator(const char *detail) noexcept : exception("invalid_iterator", detail) {
+    }
 };
 
 class container_is_empty : public exception {
-    /* __________________________ */
+   public:
+    container_is_empty() noexcept : exception("container_is_empty", nullptr) {
+    }
+    explicit container_is_empty(const char *detail) noexcept : exception("container_is_empty", detail) {
+    }
 };
 }  // namespace sjtu
 
@@ -0,0 +1,89 @@
+#ifndef SJTU_FLAT_MAP_HPP
+#define SJTU_FLAT_MAP_HPP
+
+#include "exceptions.hpp"
+#include "flat_tree.hpp"
+#include "utility.hpp"
+
+#include <cstddef>
+#include <functional>
+#include <utility>
+
+namespace sjtu
+{
+namespace flat_detail
+{
+template<typename Key, typename T>
+struct first_of {
+	const Key &operator()(const pair<Key, T> &value) const {
+		return value.first;
+	}
+};
+}
+
+/**
+ * a map kept as a vector of pairs sorted by key
+ * Lookups binary-search one contiguous buffer instead of chasing tree
+ * nodes, and a pair<Key, T> of trivially relocatable types moves with
+ * memcpy when the buffer grows or shifts. Insertion and erasure of a
+ * single key are linear; use insert_range() or the sorted_unique
+ * constructors to add many at once. Iterators and references are
+ * invalidated by any insertion or erasure, as in vector. Elements are
+ * reached as pair<Key, T>; their keys must not be modified in place.
+ */
+template<typename Key, typename T, typename Compare = std::less<Key>>
+class flat_map : public flat_detail::flat_tree<pair<Key, T>, Key, flat_detail::first_of<Key, T>, Compare>
+{
+	using base = flat_detail::flat_tree<pair<Key, T>, Key, flat_detail::first_of<Key, T>, Compare>;
+
+public:
+	using mapped_type = T;
+	using typename base::iterator;
+	using typename base::const_iterator;
+
+	using base::base;
+
+	T & at(const Key &k) {
+		size_t i = this->find_index(k);
+		if (i == this->elements_.size()) {
+			throw index_out_of_bound("flat_map::at");
+		}
+		return this->elements_[i].second;
+	}
+
+	const T & at(const Key &k) const {
+		size_t i = this->find_index(k);
+		if (i == this->elements_.size()) {
+			throw index_out_of_bound("flat_map::at");
+		}
+		return this->elements_[i].second;
+	}
+
+	// Value-initializes the mapped value of a new key
+	T & operator[](const Key &k) {
+		return try_emplace(k).first->second;
+	}
+
+	/**
+	 * inserts (k, T(args...)) unless k is present; args are left
+	 * untouched if it is
+	 */
+	template<typename... Args>
+	std::pair<iterator, bool> try_emplace(const Key &k, Args&&... args) {
+		return this->emplace_key(k, std::piecewise_construct, std::forward_as_tuple(k),
+			std::forward_as_tuple(std::forward<Args>(args)...));
+	}
+
+	template<typename M>
+	std::pair<iterator, bool> insert_or_assign(const Key &k, M &&value) {
+		std::pair<iterator, bool> result = try_emplace(k, std::forward<M>(value));
+		if (!result.second) {
+			result.first->second = std::forward<M>(value);
+		}
+		return result;
+	}
+};
+
+}
+
+#endif
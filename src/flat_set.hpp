@@ -0,0 +1,88 @@
+#ifndef SJTU_FLAT_SET_HPP
+#define SJTU_FLAT_SET_HPP
+
+#include "flat_tree.hpp"
+
+#include <cstddef>
+#include <functional>
+#include <utility>
+
+namespace sjtu
+{
+namespace flat_detail
+{
+template<typename Key>
+struct identity {
+	const Key &operator()(const Key &value) const {
+		return value;
+	}
+};
+}
+
+/**
+ * a set kept as a sorted vector of keys
+ * It shares flat_map's layout and costs; the keys are only reachable
+ * through const_iterator, so the order cannot be broken from outside.
+ */
+template<typename Key, typename Compare = std::less<Key>>
+class flat_set : public flat_detail::flat_tree<Key, Key, flat_detail::identity<Key>, Compare>
+{
+	using base = flat_detail::flat_tree<Key, Key, flat_detail::identity<Key>, Compare>;
+
+public:
+	using iterator = typename base::const_iterator;
+	using const_iterator = typename base::const_iterator;
+
+	using base::base;
+
+	const_iterator begin() const {
+		return this->elements_.cbegin();
+	}
+
+	const_iterator end() const {
+		return this->elements_.cend();
+	}
+
+	const_iterator find(const Key &k) const {
+		return base::find(k);
+	}
+
+	const_iterator lower_bound(const Key &k) const {
+		return base::lower_bound(k);
+	}
+
+	const_iterator upper_bound(const Key &k) const {
+		return base::upper_bound(k);
+	}
+
+	std::pair<const_iterator, bool> insert(const Key &k) {
+		std::pair<typename base::iterator, bool> result = base::insert(k);
+		return std::pair<const_iterator, bool>(result.first, result.second);
+	}
+
+	std::pair<const_iterator, bool> insert(Key &&k) {
+		std::pair<typename base::iterator, bool> result = base::insert(std::move(k));
+		return std::pair<const_iterator, bool>(result.first, result.second);
+	}
+
+	template<typename... Args>
+	std::pair<const_iterator, bool> emplace(Args&&... args) {
+		return insert(Key(std::forward<Args>(args)...));
+	}
+
+	const_iterator erase(const_iterator pos) {
+		return base::erase(pos);
+	}
+
+	const_iterator erase(const_iterator first, const_iterator last) {
+		return base::erase(first, last);
+	}
+
+	size_t erase(const Key &k) {
+		return base::erase(k);
+	}
+};
+
+}
+
+#endif
@@ -0,0 +1,359 @@
+#ifndef SJTU_FLAT_TREE_HPP
+#define SJTU_FLAT_TREE_HPP
+
+#include "exceptions.hpp"
+#include "vector.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <utility>
+
+namespace sjtu
+{
+/**
+ * tag for constructors taking input that is already sorted and free of
+ * duplicate keys; it is taken as is, in linear time
+ */
+struct sorted_unique_t {
+	explicit sorted_unique_t() = default;
+};
+
+constexpr sorted_unique_t sorted_unique{};
+
+namespace flat_detail
+{
+/**
+ * the sorted vector behind flat_map and flat_set
+ * Elements are kept ordered by KeyOf()(element) under Compare, with at
+ * most one element per key. Lookups are binary searches over the
+ * contiguous buffer; single inserts and erases shift the elements after
+ * them, so bulk changes should go through insert_range().
+ */
+template<typename Value, typename Key, typename KeyOf, typename Compare>
+class flat_tree
+{
+public:
+	using key_type = Key;
+	using value_type = Value;
+	using key_compare = Compare;
+	using size_type = size_t;
+	using difference_type = std::ptrdiff_t;
+	using container_type = vector<Value>;
+	using iterator = typename container_type::iterator;
+	using const_iterator = typename container_type::const_iterator;
+
+protected:
+	// Above this many elements lookups prefetch both halves ahead
+	static constexpr size_t prefetch_threshold = 4096;
+
+	container_type elements_;
+	Compare comp_;
+
+	static const Key &key(const Value &value) {
+		return KeyOf()(value);
+	}
+
+	bool less(const Value &value, const Key &k) const {
+		return comp_(key(value), k);
+	}
+
+	/**
+	 * index of the first element not less than k
+	 * The loop has no data-dependent branch: the probe only decides which
+	 * half to keep, which compiles to a conditional move, and every search
+	 * of n elements takes the same ceil(log2 n) steps.
+	 */
+	size_t lower_index(const Key &k) const {
+		size_t n = elements_.size();
+		if (n == 0) {
+			return 0;
+		}
+		const Value* base = elements_.data();
+		while (n > 1) {
+			size_t half = n / 2;
+#if defined(__GNUG__)
+			if (n >= prefetch_threshold) {
+				// Both candidates for the next probe
+				__builtin_prefetch(base + half / 2);
+				__builtin_prefetch(base + half + half / 2);
+			}
+#endif
+			base = less(base[half], k) ? base + half : base;
+			n -= half;
+		}
+		return base - elements_.data() + less(*base, k);
+	}
+
+	// Whether element i exists and has key k, given that it is not less
+	bool holds(size_t i, const Key &k) const {
+		return i < elements_.size() && !comp_(k, key(elements_[i]));
+	}
+
+	size_t find_index(const Key &k) const {
+		size_t i = lower_index(k);
+		return holds(i, k) ? i : elements_.size();
+	}
+
+	size_t upper_index(const Key &k) const {
+		size_t i = lower_index(k);
+		return holds(i, k) ? i + 1 : i;
+	}
+
+	// Sorts the elements from index from on and merges them into the
+	// sorted ones before it; of equal keys the first one is kept, so
+	// elements already present win over new ones
+	void merge_from(size_t from) {
+		Value* first = elements_.data();
+		Value* mid = first + from;
+		Value* last = first + elements_.size();
+		auto order = [this](const Value &a, const Value &b) {
+			return comp_(key(a), key(b));
+		};
+		std::stable_sort(mid, last, order);
+		// Appending past the largest key, the common case, needs no merge
+		// and can only repeat a key at the seam
+		Value* start = from > 0 ? mid - 1 : first;
+		if (from > 0 && mid != last && order(*mid, *(mid - 1))) {
+			std::inplace_merge(first, mid, last, order);
+			start = first;
+		}
+		Value* kept = std::unique(start, last, [this](const Value &a, const Value &b) {
+			return !comp_(key(a), key(b));
+		});
+		elements_.erase(elements_.cbegin() + (kept - first), elements_.cend());
+	}
+
+	// Puts the elements back in order after a merge was interrupted,
+	// dropping them all if even that fails
+	void restore_order() {
+		try {
+			merge_from(0);
+		} catch (...) {
+			elements_.clear();
+		}
+	}
+
+	/**
+	 * inserts an element for k built from args unless k is present
+	 */
+	template<typename... Args>
+	std::pair<iterator, bool> emplace_key(const Key &k, Args&&... args) {
+		size_t i = lower_index(k);
+		if (holds(i, k)) {
+			return std::pair<iterator, bool>(elements_.begin() + i, false);
+		}
+		return std::pair<iterator, bool>(elements_.emplace(elements_.cbegin() + i, std::forward<Args>(args)...), true);
+	}
+
+	void check_sorted_unique() const {
+#if SJTU_VECTOR_CHECKED
+		for (size_t i = 1; i < elements_.size(); ++i) {
+			if (!comp_(key(elements_[i - 1]), key(elements_[i]))) {
+				throw runtime_error("input is not sorted and unique");
+			}
+		}
+#endif
+	}
+
+public:
+	flat_tree() : elements_(), comp_() {}
+
+	explicit flat_tree(const Compare &comp) : elements_(), comp_(comp) {}
+
+	template<typename InputIt, typename = require_input_iterator<InputIt>>
+	flat_tree(InputIt first, InputIt last, const Compare &comp = Compare()) : elements_(), comp_(comp) {
+		insert_range(first, last);
+	}
+
+	/**
+	 * takes [first, last), which must be sorted and unique; checked
+	 * under SJTU_VECTOR_CHECKED, where runtime_error is thrown otherwise
+	 */
+	template<typename InputIt, typename = require_input_iterator<InputIt>>
+	flat_tree(sorted_unique_t, InputIt first, InputIt last, const Compare &comp = Compare())
+		: elements_(first, last), comp_(comp) {
+		check_sorted_unique();
+	}
+
+	/**
+	 * adopts elements, which must be sorted and unique, without copying
+	 */
+	flat_tree(sorted_unique_t, container_type &&elements, const Compare &comp = Compare())
+		: elements_(std::move(elements)), comp_(comp) {
+		check_sorted_unique();
+	}
+
+	iterator begin() {
+		return elements_.begin();
+	}
+
+	const_iterator begin() const {
+		return elements_.begin();
+	}
+
+	const_iterator cbegin() const {
+		return elements_.cbegin();
+	}
+
+	iterator end() {
+		return elements_.end();
+	}
+
+	const_iterator end() const {
+		return elements_.end();
+	}
+
+	const_iterator cend() const {
+		return elements_.cend();
+	}
+
+	bool empty() const {
+		return elements_.empty();
+	}
+
+	size_t size() const {
+		return elements_.size();
+	}
+
+	size_t capacity() const {
+		return elements_.capacity();
+	}
+
+	void reserve(const size_t &new_capacity) {
+		elements_.reserve(new_capacity);
+	}
+
+	void shrink_to_fit() {
+		elements_.shrink_to_fit();
+	}
+
+	void clear() {
+		elements_.clear();
+	}
+
+	key_compare key_comp() const {
+		return comp_;
+	}
+
+	// The sorted elements, for reading them as a plain array
+	const container_type &sequence() const {
+		return elements_;
+	}
+
+	/**
+	 * gives up the sorted elements, leaving the container empty
+	 */
+	container_type extract() {
+		container_type out(std::move(elements_));
+		elements_.clear();
+		return out;
+	}
+
+	iterator find(const Key &k) {
+		return elements_.begin() + find_index(k);
+	}
+
+	const_iterator find(const Key &k) const {
+		return elements_.cbegin() + find_index(k);
+	}
+
+	bool contains(const Key &k) const {
+		return find_index(k) != elements_.size();
+	}
+
+	size_t count(const Key &k) const {
+		return contains(k) ? 1 : 0;
+	}
+
+	iterator lower_bound(const Key &k) {
+		return elements_.begin() + lower_index(k);
+	}
+
+	const_iterator lower_bound(const Key &k) const {
+		return elements_.cbegin() + lower_index(k);
+	}
+
+	iterator upper_bound(const Key &k) {
+		return elements_.begin() + upper_index(k);
+	}
+
+	const_iterator upper_bound(const Key &k) const {
+		return elements_.cbegin() + upper_index(k);
+	}
+
+	std::pair<iterator, bool> insert(const Value &value) {
+		return emplace_key(key(value), value);
+	}
+
+	std::pair<iterator, bool> insert(Value &&value) {
+		return emplace_key(key(value), std::move(value));
+	}
+
+	template<typename... Args>
+	std::pair<iterator, bool> emplace(Args&&... args) {
+		// The key is only known once the element exists
+		Value value(std::forward<Args>(args)...);
+		return insert(std::move(value));
+	}
+
+	/**
+	 * inserts the elements of [first, last) whose keys are not present
+	 * yet, keeping the first of several equal new keys
+	 * They are appended and sorted, then merged with the existing ones in
+	 * a single pass: O(n + m log m) for m new elements, where inserting
+	 * them one by one would shift the table m times. If an exception is
+	 * thrown, the container is still sorted and unique but may hold only
+	 * some of the new elements.
+	 */
+	template<typename InputIt, typename = require_input_iterator<InputIt>>
+	void insert_range(InputIt first, InputIt last) {
+		size_t from = elements_.size();
+		try {
+			elements_.insert(elements_.cend(), first, last);
+			merge_from(from);
+		} catch (...) {
+			// Losing the order would break every later lookup
+			restore_order();
+			throw;
+		}
+	}
+
+	iterator erase(const_iterator pos) {
+		return elements_.erase(pos);
+	}
+
+	iterator erase(const_iterator first, const_iterator last) {
+		return elements_.erase(first, last);
+	}
+
+	size_t erase(const Key &k) {
+		size_t i = find_index(k);
+		if (i == elements_.size()) {
+			return 0;
+		}
+		elements_.erase(i);
+		return 1;
+	}
+
+	void swap(flat_tree &other) {
+		std::swap(elements_, other.elements_);
+		std::swap(comp_, other.comp_);
+	}
+};
+
+template<typename V, typename K, typename KO, typename C>
+bool operator==(const flat_tree<V, K, KO, C> &a, const flat_tree<V, K, KO, C> &b) {
+	return a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin());
+}
+
+template<typename V, typename K, typename KO, typename C>
+bool operator!=(const flat_tree<V, K, KO, C> &a, const flat_tree<V, K, KO, C> &b) {
+	return !(a == b);
+}
+}
+
+}
+
+#endif
@@ -0,0 +1,347 @@
+#ifndef SJTU_ITERATOR_HPP
+#define SJTU_ITERATOR_HPP
+
+#include "exceptions.hpp"
+
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+
+/**
+ * SJTU_VECTOR_CHECKED selects whether operator[], front(), back() and
+ * iterator arithmetic/dereference are bounds-checked. at() always is.
+ * Defaults to checked unless NDEBUG is defined; every translation unit
+ * of a program must agree on its value.
+ */
+#ifndef SJTU_VECTOR_CHECKED
+#ifdef NDEBUG
+#define SJTU_VECTOR_CHECKED 0
+#else
+#define SJTU_VECTOR_CHECKED 1
+#endif
+#endif
+
+namespace sjtu
+{
+/**
+ * enables a range overload only for iterator types, so that calls such
+ * as insert(pos, 3, 5) keep resolving to the count/value overload
+ */
+template<typename It>
+using require_input_iterator = typename std::enable_if<std::is_convertible<
+	typename std::iterator_traits<It>::iterator_category, std::input_iterator_tag>::value>::type;
+
+template<typename It>
+using is_forward_iterator = std::is_convertible<
+	typename std::iterator_traits<It>::iterator_category, std::forward_iterator_tag>;
+
+/**
+ * random-access iterator over the contiguous storage of Container
+ * T is the element type, const-qualified for const_iterator. The
+ * iterator remembers its container so that differences between
+ * iterators of different containers throw invalid_iterator and, under
+ * SJTU_VECTOR_CHECKED, so that leaving [begin, end] is caught.
+ * Container must provide data() and size().
+ */
+template<typename Container, typename T>
+class contiguous_iterator
+{
+public:
+	using difference_type = std::ptrdiff_t;
+	using value_type = typename std::remove_const<T>::type;
+	using pointer = T*;
+	using reference = T&;
+	using iterator_category = std::random_access_iterator_tag;
+#if __cplusplus >= 202002L
+	using iterator_concept = std::contiguous_iterator_tag;
+	using element_type = T;
+#endif
+
+private:
+	T* ptr_;
+	const Container* vec_;
+
+	friend Container;
+	template<typename, typename>
+	friend class contiguous_iterator;
+
+	// In checked mode, throws invalid_iterator unless p lies within
+	// [begin, end], or [begin, end) when it is about to be dereferenced
+	void check(const T* p, bool dereference) const {
+#if SJTU_VECTOR_CHECKED
+		if (vec_ == nullptr || p < vec_->data() || p > vec_->data() + vec_->size()
+			|| (dereference && p == vec_->data() + vec_->size())) {
+			throw invalid_iterator();
+		}
+#else
+		(void)p;
+		(void)dereference;
+#endif
+	}
+
+public:
+	contiguous_iterator(T* ptr = nullptr, const Container* vec = nullptr) : ptr_(ptr), vec_(vec) {}
+
+	// iterator converts to const_iterator, not the other way round
+	template<typename U, typename = typename std::enable_if<
+		std::is_const<T>::value && std::is_same<U, value_type>::value>::type>
+	contiguous_iterator(const contiguous_iterator<Container, U> &other) : ptr_(other.ptr_), vec_(other.vec_) {}
+
+	contiguous_iterator operator+(const difference_type &n) const {
+		check(ptr_ + n, false);
+		return contiguous_iterator(ptr_ + n, vec_);
+	}
+
+	friend contiguous_iterator operator+(const difference_type &n, const contiguous_iterator &it) {
+		return it + n;
+	}
+
+	contiguous_iterator operator-(const difference_type &n) const {
+		check(ptr_ - n, false);
+		return contiguous_iterator(ptr_ - n, vec_);
+	}
+
+	template<typename U>
+	difference_type operator-(const contiguous_iterator<Container, U> &rhs) const {
+		if (vec_ != rhs.vec_) {
+			throw invalid_iterator();
+		}
+		return ptr_ - rhs.ptr_;
+	}
+
+	contiguous_iterator& operator+=(const difference_type &n) {
+		check(ptr_ + n, false);
+		ptr_ += n;
+		return *this;
+	}
+
+	contiguous_iterator& operator-=(const difference_type &n) {
+		check(ptr_ - n, false);
+		ptr_ -= n;
+		return *this;
+	}
+
+	contiguous_iterator operator++(int) {
+		contiguous_iterator tmp = *this;
+		++*this;
+		return tmp;
+	}
+
+	contiguous_iterator& operator++() {
+		check(ptr_ + 1, false);
+		++ptr_;
+		return *this;
+	}
+
+	contiguous_iterator operator--(int) {
+		contiguous_iterator tmp = *this;
+		--*this;
+		return tmp;
+	}
+
+	contiguous_iterator& operator--() {
+		check(ptr_ - 1, false);
+		--ptr_;
+		return *this;
+	}
+
+	T& operator*() const {
+		check(ptr_, true);
+		return *ptr_;
+	}
+
+	T* operator->() const {
+		check(ptr_, true);
+		return ptr_;
+	}
+
+	T& operator[](const difference_type &n) const {
+		check(ptr_ + n, true);
+		return ptr_[n];
+	}
+
+	template<typename U>
+	bool operator==(const contiguous_iterator<Container, U> &rhs) const {
+		return ptr_ == rhs.ptr_;
+	}
+
+	template<typename U>
+	bool operator!=(const contiguous_iterator<Container, U> &rhs) const {
+		return ptr_ != rhs.ptr_;
+	}
+
+	template<typename U>
+	bool operator<(const contiguous_iterator<Container, U> &rhs) const {
+		return ptr_ < rhs.ptr_;
+	}
+
+	template<typename U>
+	bool operator>(const contiguous_iterator<Container, U> &rhs) const {
+		return ptr_ > rhs.ptr_;
+	}
+
+	template<typename U>
+	bool operator<=(const contiguous_iterator<Container, U> &rhs) const {
+		return ptr_ <= rhs.ptr_;
+	}
+
+	template<typename U>
+	bool operator>=(const contiguous_iterator<Container, U> &rhs) const {
+		return ptr_ >= rhs.ptr_;
+	}
+};
+
+/**
+ * random-access iterator over any container indexed by operator[]
+ * Used where storage is not contiguous. It keeps the container and an
+ * index, so it behaves like contiguous_iterator: differences across
+ * containers throw invalid_iterator and, under SJTU_VECTOR_CHECKED,
+ * leaving [begin, end] is caught. Container must provide operator[]
+ * and size().
+ */
+template<typename Container, typename T>
+class indexed_iterator
+{
+public:
+	using difference_type = std::ptrdiff_t;
+	using value_type = typename std::remove_const<T>::type;
+	using pointer = T*;
+	using reference = T&;
+	using iterator_category = std::random_access_iterator_tag;
+
+private:
+	using container_pointer = typename std::conditional<std::is_const<T>::value, const Container*, Container*>::type;
+
+	container_pointer vec_;
+	size_t index_;
+
+	friend Container;
+	template<typename, typename>
+	friend class indexed_iterator;
+
+	void check(size_t index, bool dereference) const {
+#if SJTU_VECTOR_CHECKED
+		if (vec_ == nullptr || index > vec_->size() || (dereference && index == vec_->size())) {
+			throw invalid_iterator();
+		}
+#else
+		(void)index;
+		(void)dereference;
+#endif
+	}
+
+public:
+	indexed_iterator(container_pointer vec = nullptr, size_t index = 0) : vec_(vec), index_(index) {}
+
+	// iterator converts to const_iterator, not the other way round
+	template<typename U, typename = typename std::enable_if<
+		std::is_const<T>::value && std::is_same<U, value_type>::value>::type>
+	indexed_iterator(const indexed_iterator<Container, U> &other) : vec_(other.vec_), index_(other.index_) {}
+
+	indexed_iterator operator+(const difference_type &n) const {
+		check(index_ + n, false);
+		return indexed_iterator(vec_, index_ + n);
+	}
+
+	friend indexed_iterator operator+(const difference_type &n, const indexed_iterator &it) {
+		return it + n;
+	}
+
+	indexed_iterator operator-(const difference_type &n) const {
+		check(index_ - n, false);
+		return indexed_iterator(vec_, index_ - n);
+	}
+
+	template<typename U>
+	difference_type operator-(const indexed_iterator<Container, U> &rhs) const {
+		if (vec_ != rhs.vec_) {
+			throw invalid_iterator();
+		}
+		return (difference_type)index_ - (difference_type)rhs.index_;
+	}
+
+	indexed_iterator& operator+=(const difference_type &n) {
+		check(index_ + n, false);
+		index_ += n;
+		return *this;
+	}
+
+	indexed_iterator& operator-=(const difference_type &n) {
+		check(index_ - n, false);
+		index_ -= n;
+		return *this;
+	}
+
+	indexed_iterator operator++(int) {
+		indexed_iterator tmp = *this;
+		++*this;
+		return tmp;
+	}
+
+	indexed_iterator& operator++() {
+		check(index_ + 1, false);
+		++index_;
+		return *this;
+	}
+
+	indexed_iterator operator--(int) {
+		indexed_iterator tmp = *this;
+		--*this;
+		return tmp;
+	}
+
+	indexed_iterator& operator--() {
+		check(index_ - 1, false);
+		--index_;
+		return *this;
+	}
+
+	T& operator*() const {
+		check(index_, true);
+		return (*vec_)[index_];
+	}
+
+	T* operator->() const {
+		check(index_, true);
+		return &(*vec_)[index_];
+	}
+
+	T& operator[](const difference_type &n) const {
+		check(index_ + n, true);
+		return (*vec_)[index_ + n];
+	}
+
+	template<typename U>
+	bool operator==(const indexed_iterator<Container, U> &rhs) const {
+		return vec_ == rhs.vec_ && index_ == rhs.index_;
+	}
+
+	template<typename U>
+	bool operator!=(const indexed_iterator<Container, U> &rhs) const {
+		return !(*this == rhs);
+	}
+
+	template<typename U>
+	bool operator<(const indexed_iterator<Container, U> &rhs) const {
+		return index_ < rhs.index_;
+	}
+
+	template<typename U>
+	bool operator>(const indexed_iterator<Container, U> &rhs) const {
+		return index_ > rhs.index_;
+	}
+
+	template<typename U>
+	bool operator<=(const indexed_iterator<Container, U> &rhs) const {
+		return index_ <= rhs.index_;
+	}
+
+	template<typename U>
+	bool operator>=(const indexed_iterator<Container, U> &rhs) const {
+		return index_ >= rhs.index_;
+	}
+};
+
+}
+
+#endif
@@ -0,0 +1,536 @@
+#ifndef SJTU_MAPPED_VECTOR_HPP
+#define SJTU_MAPPED_VECTOR_HPP
+
+#include "exceptions.hpp"
+#include "iterator.hpp"
+#include "vector.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <new>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace sjtu
+{
+/**
+ * a vector whose elements live in a memory-mapped file
+ * The file holds a small header followed by the raw elements, so a
+ * vector built by one process is reopened by the next one without any
+ * deserialization: the constructor only maps the file. Growing extends
+ * the file with ftruncate and remaps it instead of copying.
+ * The size is written through to the header on every change; sync()
+ * additionally flushes the pages to disk.
+ * T must be trivially copyable, and the file is only portable between
+ * builds that agree on sizeof(T) and the byte order. POSIX only.
+ * The interface and exceptions are those of sjtu::vector; failing
+ * system calls and files of the wrong format throw runtime_error.
+ */
+template<typename T>
+class mapped_vector
+{
+	static_assert(std::is_trivially_copyable<T>::value, "mapped_vector needs a trivially copyable element type");
+
+public:
+	using value_type = T;
+	using size_type = size_t;
+	using difference_type = std::ptrdiff_t;
+	using reference = T&;
+	using const_reference = const T&;
+	using pointer = T*;
+	using const_pointer = const T*;
+
+private:
+	// On-disk header, the elements start right after it
+	struct alignas(64) header {
+		char magic[8];
+		uint32_t version;
+		uint32_t element_size;
+		uint64_t size;
+		uint64_t capacity;
+	};
+
+	static constexpr size_t data_offset = sizeof(header);
+	static_assert(alignof(T) <= data_offset, "mapped_vector does not support over-aligned types");
+
+	static constexpr char magic[8] = {'S', 'J', 'T', 'U', 'M', 'V', 'E', 'C'};
+	static constexpr uint32_t version = 1;
+
+	int fd_;
+	char* map_;
+	T* data_;
+	size_t size_;
+	size_t capacity_;
+
+	header* head() {
+		return reinterpret_cast<header*>(map_);
+	}
+
+	static size_t file_bytes(size_t capacity) {
+		return data_offset + capacity * sizeof(T);
+	}
+
+	void set_size(size_t n) {
+		size_ = n;
+		head()->size = n;
+	}
+
+	void close() {
+		if (map_ != nullptr) {
+			::munmap(map_, file_bytes(capacity_));
+		}
+		if (fd_ >= 0) {
+			::close(fd_);
+		}
+		fd_ = -1;
+		map_ = nullptr;
+		data_ = nullptr;
+		size_ = 0;
+		capacity_ = 0;
+	}
+
+	// Map capacity elements, replacing any old mapping once the new one exists
+	void map(size_t capacity) {
+		void* p = ::mmap(nullptr, file_bytes(capacity), PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+		if (p == MAP_FAILED) {
+			throw runtime_error();
+		}
+		if (map_ != nullptr) {
+			::munmap(map_, file_bytes(capacity_));
+		}
+		map_ = static_cast<char*>(p);
+		data_ = reinterpret_cast<T*>(map_ + data_offset);
+		capacity_ = capacity;
+	}
+
+	// Map the vector file open at fd_, initialising it if it is empty
+	void attach() {
+		struct stat st;
+		if (::fstat(fd_, &st) != 0) {
+			throw runtime_error();
+		}
+
+		if (st.st_size == 0) {
+			if (::ftruncate(fd_, file_bytes(0)) != 0) {
+				throw runtime_error();
+			}
+			map(0);
+			header* h = head();
+			std::memcpy(h->magic, magic, sizeof(magic));
+			h->version = version;
+			h->element_size = sizeof(T);
+			h->size = 0;
+			h->capacity = 0;
+			return;
+		}
+
+		if ((size_t)st.st_size < data_offset) {
+			throw runtime_error();
+		}
+		header h;
+		if (::pread(fd_, &h, sizeof(h), 0) != (ssize_t)sizeof(h) || std::memcmp(h.magic, magic, sizeof(magic)) != 0
+			|| h.version != version || h.element_size != sizeof(T) || h.size > h.capacity
+			|| (size_t)st.st_size < file_bytes(h.capacity)) {
+			throw runtime_error();
+		}
+		map(h.capacity);
+		size_ = h.size;
+	}
+
+	// Open path, creating an empty vector file if it is missing or empty
+	void open(const char* path) {
+		fd_ = ::open(path, O_RDWR | O_CREAT, 0644);
+		if (fd_ < 0) {
+			throw runtime_error();
+		}
+		try {
+			attach();
+		} catch (...) {
+			// The destructor does not run when the constructor throws
+			close();
+			throw;
+		}
+	}
+
+	// Resize the file to new_capacity elements and map it again
+	void remap(size_t new_capacity) {
+		size_t old_bytes = file_bytes(capacity_);
+		size_t new_bytes = file_bytes(new_capacity);
+		if (new_bytes > old_bytes && ::ftruncate(fd_, new_bytes) != 0) {
+			throw runtime_error();
+		}
+#ifdef MREMAP_MAYMOVE
+		void* p = ::mremap(map_, old_bytes, new_bytes, MREMAP_MAYMOVE);
+		if (p == MAP_FAILED) {
+			throw runtime_error();
+		}
+		map_ = static_cast<char*>(p);
+		data_ = reinterpret_cast<T*>(map_ + data_offset);
+		capacity_ = new_capacity;
+#else
+		map(new_capacity);
+#endif
+		if (new_bytes < old_bytes) {
+			// Only shrink the file once nothing maps the cut-off pages
+			if (::ftruncate(fd_, new_bytes) != 0) {
+				throw runtime_error();
+			}
+		}
+		head()->capacity = new_capacity;
+	}
+
+	void grow_to(size_t required) {
+		if (required > capacity_) {
+			remap(double_growth::next(capacity_, required));
+		}
+	}
+
+	// Open a gap of n slots at ind, growing the file if needed
+	void make_room(size_t ind, size_t n) {
+		grow_to(size_ + n);
+		std::memmove(static_cast<void*>(data_ + ind + n), static_cast<const void*>(data_ + ind), (size_ - ind) * sizeof(T));
+	}
+
+	void fill(size_t ind, size_t n, const T &value) {
+		for (size_t i = 0; i < n; ++i) {
+			new (data_ + ind + i) T(value);
+		}
+	}
+
+public:
+	using iterator = contiguous_iterator<mapped_vector, T>;
+	using const_iterator = contiguous_iterator<mapped_vector, const T>;
+	using reverse_iterator = std::reverse_iterator<iterator>;
+	using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+	/**
+	 * opens the vector stored in the file at path, or creates an empty one
+	 */
+	explicit mapped_vector(const std::string &path) : fd_(-1), map_(nullptr), data_(nullptr), size_(0), capacity_(0) {
+		open(path.c_str());
+	}
+
+	// A file has a single owner
+	mapped_vector(const mapped_vector &) = delete;
+	mapped_vector &operator=(const mapped_vector &) = delete;
+
+	mapped_vector(mapped_vector &&other) noexcept
+		: fd_(other.fd_), map_(other.map_), data_(other.data_), size_(other.size_), capacity_(other.capacity_) {
+		other.fd_ = -1;
+		other.map_ = nullptr;
+		other.data_ = nullptr;
+		other.size_ = 0;
+		other.capacity_ = 0;
+	}
+
+	mapped_vector &operator=(mapped_vector &&other) noexcept {
+		if (this == &other) {
+			return *this;
+		}
+		close();
+		std::swap(fd_, other.fd_);
+		std::swap(map_, other.map_);
+		std::swap(data_, other.data_);
+		std::swap(size_, other.size_);
+		std::swap(capacity_, other.capacity_);
+		return *this;
+	}
+
+	// Unmaps the file; its contents stay on disk
+	~mapped_vector() {
+		close();
+	}
+
+	/**
+	 * writes the mapped pages back to the file and waits for the write
+	 */
+	void sync() {
+		if (map_ != nullptr && ::msync(map_, file_bytes(capacity_), MS_SYNC) != 0) {
+			throw runtime_error();
+		}
+	}
+
+	T & at(const size_t &pos) {
+		if (pos >= size_) {
+			throw index_out_of_bound();
+		}
+		return data_[pos];
+	}
+
+	const T & at(const size_t &pos) const {
+		if (pos >= size_) {
+			throw index_out_of_bound();
+		}
+		return data_[pos];
+	}
+
+	// Checked only under SJTU_VECTOR_CHECKED, as in vector
+	T & operator[](const size_t &pos) {
+#if SJTU_VECTOR_CHECKED
+		if (pos >= size_) {
+			throw index_out_of_bound();
+		}
+#endif
+		return data_[pos];
+	}
+
+	const T & operator[](const size_t &pos) const {
+#if SJTU_VECTOR_CHECKED
+		if (pos >= size_) {
+			throw index_out_of_bound();
+		}
+#endif
+		return data_[pos];
+	}
+
+	const T & front() const {
+#if SJTU_VECTOR_CHECKED
+		if (size_ == 0) {
+			throw container_is_empty();
+		}
+#endif
+		return data_[0];
+	}
+
+	const T & back() const {
+#if SJTU_VECTOR_CHECKED
+		if (size_ == 0) {
+			throw container_is_empty();
+		}
+#endif
+		return data_[size_ - 1];
+	}
+
+	T * data() {
+		return data_;
+	}
+
+	const T * data() const {
+		return data_;
+	}
+
+	iterator begin() {
+		return iterator(data_, this);
+	}
+
+	const_iterator begin() const {
+		return const_iterator(data_, this);
+	}
+
+	const_iterator cbegin() const {
+		return const_iterator(data_, this);
+	}
+
+	iterator end() {
+		return iterator(data_ + size_, this);
+	}
+
+	const_iterator end() const {
+		return const_iterator(data_ + size_, this);
+	}
+
+	const_iterator cend() const {
+		return const_iterator(data_ + size_, this);
+	}
+
+	reverse_iterator rbegin() {
+		return reverse_iterator(end());
+	}
+
+	const_reverse_iterator rbegin() const {
+		return const_reverse_iterator(end());
+	}
+
+	const_reverse_iterator crbegin() const {
+		return const_reverse_iterator(cend());
+	}
+
+	reverse_iterator rend() {
+		return reverse_iterator(begin());
+	}
+
+	const_reverse_iterator rend() const {
+		return const_reverse_iterator(begin());
+	}
+
+	const_reverse_iterator crend() const {
+		return const_reverse_iterator(cbegin());
+	}
+
+	bool empty() const {
+		return size_ == 0;
+	}
+
+	size_t size() const {
+		return size_;
+	}
+
+	size_t capacity() const {
+		return capacity_;
+	}
+
+	/**
+	 * extends the file so that it holds at least new_capacity elements
+	 */
+	void reserve(const size_t &new_capacity) {
+		if (new_capacity > capacity_) {
+			remap(new_capacity);
+		}
+	}
+
+	/**
+	 * truncates the file to the current size
+	 */
+	void shrink_to_fit() {
+		if (capacity_ > size_) {
+			remap(size_);
+		}
+	}
+
+	void resize(const size_t &count) {
+		resize(count, T());
+	}
+
+	void resize(const size_t &count, const T &value) {
+		if (count > size_) {
+			T v = value;
+			grow_to(count);
+			fill(size_, count - size_, v);
+		}
+		set_size(count);
+	}
+
+	void clear() {
+		set_size(0);
+	}
+
+	template<typename InputIt, typename = require_input_iterator<InputIt>>
+	void assign(InputIt first, InputIt last) {
+		clear();
+		insert(cend(), first, last);
+	}
+
+	void assign(const size_t &count, const T &value) {
+		T v = value;
+		clear();
+		resize(count, v);
+	}
+
+	iterator insert(const_iterator pos, const T &value) {
+		return insert((size_t)(pos.ptr_ - data_), value);
+	}
+
+	iterator insert(const size_t &ind, const T &value) {
+		if (ind > size_) {
+			throw index_out_of_bound();
+		}
+		// value may live in the mapping, which can move while growing
+		T v = value;
+		make_room(ind, 1);
+		new (data_ + ind) T(v);
+		set_size(size_ + 1);
+		return iterator(data_ + ind, this);
+	}
+
+	iterator insert(const_iterator pos, const size_t &count, const T &value) {
+		size_t index = pos.ptr_ - data_;
+		if (index > size_) {
+			throw index_out_of_bound();
+		}
+		T v = value;
+		make_room(index, count);
+		fill(index, count, v);
+		set_size(size_ + count);
+		return iterator(data_ + index, this);
+	}
+
+	/**
+	 * inserts [first, last) before pos, the range must not point into
+	 * this vector
+	 */
+	template<typename InputIt, typename = require_input_iterator<InputIt>>
+	iterator insert(const_iterator pos, InputIt first, InputIt last) {
+		size_t index = pos.ptr_ - data_;
+		if (index > size_) {
+			throw index_out_of_bound();
+		}
+		if constexpr (is_forward_iterator<InputIt>::value) {
+			size_t n = std::distance(first, last);
+			make_room(index, n);
+			for (size_t i = 0; i < n; ++i, ++first) {
+				new (data_ + index + i) T(*first);
+			}
+			set_size(size_ + n);
+		} else {
+			for (size_t i = index; first != last; ++first, ++i) {
+				insert(i, *first);
+			}
+		}
+		return iterator(data_ + index, this);
+	}
+
+	template<typename... Args>
+	iterator emplace(const_iterator pos, Args&&... args) {
+		return insert(pos, T(std::forward<Args>(args)...));
+	}
+
+	iterator erase(const_iterator pos) {
+		return erase((size_t)(pos.ptr_ - data_));
+	}
+
+	iterator erase(const size_t &ind) {
+		if (ind >= size_) {
+			throw index_out_of_bound();
+		}
+		std::memmove(static_cast<void*>(data_ + ind), static_cast<const void*>(data_ + ind + 1), (size_ - ind - 1) * sizeof(T));
+		set_size(size_ - 1);
+		return iterator(data_ + ind, this);
+	}
+
+	iterator erase(const_iterator first, const_iterator last) {
+		size_t from = first.ptr_ - data_;
+		size_t to = last.ptr_ - data_;
+		if (from > to || to > size_) {
+			throw index_out_of_bound();
+		}
+		std::memmove(static_cast<void*>(data_ + from), static_cast<const void*>(data_ + to), (size_ - to) * sizeof(T));
+		set_size(size_ - (to - from));
+		return iterator(data_ + from, this);
+	}
+
+	void push_back(const T &value) {
+		if (size_ >= capacity_) {
+			T v = value;
+			grow_to(size_ + 1);
+			new (data_ + size_) T(v);
+		} else {
+			new (data_ + size_) T(value);
+		}
+		set_size(size_ + 1);
+	}
+
+	template<typename... Args>
+	T & emplace_back(Args&&... args) {
+		push_back(T(std::forward<Args>(args)...));
+		return data_[size_ - 1];
+	}
+
+	void pop_back() {
+		if (size_ == 0) {
+			throw container_is_empty();
+		}
+		set_size(size_ - 1);
+	}
+};
+
+}
+
+#endif
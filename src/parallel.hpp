@@ -0,0 +1,410 @@
+#ifndef SJTU_PARALLEL_HPP
+#define SJTU_PARALLEL_HPP
+
+#include "vector.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+namespace sjtu
+{
+/**
+ * a fixed set of worker threads running one indexed job at a time
+ * run(count, f) calls f(0) ... f(count - 1) on the workers and the
+ * calling thread and returns once all calls are done. If calls throw,
+ * the remaining ones still run and the first exception is rethrown.
+ * A run() from inside a job executes inline instead of deadlocking.
+ */
+class thread_pool
+{
+private:
+	vector<std::thread> workers_;
+	std::mutex run_lock_;      // one job at a time
+	std::mutex lock_;
+	std::condition_variable wake_;
+	std::condition_variable finished_;
+	const std::function<void(size_t)>* task_ = nullptr;
+	size_t count_ = 0;
+	std::atomic<size_t> next_{0};
+	size_t busy_ = 0;
+	uint64_t generation_ = 0;
+	bool stop_ = false;
+	std::exception_ptr error_;
+
+	static bool &in_worker() {
+		static thread_local bool flag = false;
+		return flag;
+	}
+
+	// Take indices of the current job until none are left
+	void work() {
+		for (size_t i = next_.fetch_add(1); i < count_; i = next_.fetch_add(1)) {
+			try {
+				(*task_)(i);
+			} catch (...) {
+				std::lock_guard<std::mutex> guard(lock_);
+				if (!error_) {
+					error_ = std::current_exception();
+				}
+			}
+		}
+	}
+
+	void worker_loop() {
+		in_worker() = true;
+		uint64_t seen = 0;
+		std::unique_lock<std::mutex> guard(lock_);
+		for (;;) {
+			wake_.wait(guard, [&] {
+				return stop_ || generation_ != seen;
+			});
+			if (stop_) {
+				return;
+			}
+			seen = generation_;
+			guard.unlock();
+			work();
+			guard.lock();
+			if (--busy_ == 0) {
+				finished_.notify_one();
+			}
+		}
+	}
+
+public:
+	/**
+	 * starts threads workers; the calling thread of run() joins in, so
+	 * the default uses every hardware thread
+	 */
+	explicit thread_pool(size_t threads = std::thread::hardware_concurrency() > 1 ? std::thread::hardware_concurrency() - 1 : 0) {
+		workers_.reserve(threads);
+		for (size_t i = 0; i < threads; ++i) {
+			workers_.push_back(std::thread([this] {
+				worker_loop();
+			}));
+		}
+	}
+
+	thread_pool(const thread_pool &) = delete;
+	thread_pool &operator=(const thread_pool &) = delete;
+
+	~thread_pool() {
+		{
+			std::lock_guard<std::mutex> guard(lock_);
+			stop_ = true;
+		}
+		wake_.notify_all();
+		for (size_t i = 0; i < workers_.size(); ++i) {
+			workers_[i].join();
+		}
+	}
+
+	// Returns the number of threads a job runs on, the caller included
+	size_t concurrency() const {
+		return workers_.size() + 1;
+	}
+
+	template<typename F>
+	void run(size_t count, F f) {
+		if (count == 0) {
+			return;
+		}
+		if (workers_.empty() || count == 1 || in_worker()) {
+			for (size_t i = 0; i < count; ++i) {
+				f(i);
+			}
+			return;
+		}
+
+		std::function<void(size_t)> task(std::ref(f));
+		std::lock_guard<std::mutex> serial(run_lock_);
+		{
+			std::lock_guard<std::mutex> guard(lock_);
+			task_ = &task;
+			count_ = count;
+			next_ = 0;
+			busy_ = workers_.size();
+			error_ = nullptr;
+			++generation_;
+		}
+		wake_.notify_all();
+
+		in_worker() = true;
+		work();
+		in_worker() = false;
+
+		std::exception_ptr error;
+		{
+			std::unique_lock<std::mutex> guard(lock_);
+			finished_.wait(guard, [this] {
+				return busy_ == 0;
+			});
+			task_ = nullptr;
+			error = error_;
+			error_ = nullptr;
+		}
+		if (error) {
+			std::rethrow_exception(error);
+		}
+	}
+};
+
+/**
+ * returns the process-wide pool used when a policy names none
+ */
+inline thread_pool &default_thread_pool() {
+	static thread_pool pool;
+	return pool;
+}
+
+/**
+ * how a bulk operation may be split
+ * Ranges shorter than threshold elements stay on the calling thread;
+ * longer ones are cut into contiguous chunks run on pool, or on
+ * default_thread_pool() when pool is null.
+ */
+struct parallel_policy {
+	size_t threshold;
+	thread_pool* pool;
+};
+
+constexpr parallel_policy seq{SIZE_MAX, nullptr};
+constexpr parallel_policy par{1 << 14, nullptr};
+
+namespace parallel_detail
+{
+constexpr size_t cache_line = 64;
+
+// [0, n) cut into count chunks of size elements, the last one shorter.
+// Chunk sizes are whole cache lines, so that two threads never write
+// the same line of a suitably aligned buffer.
+struct chunking {
+	size_t n;
+	size_t size;
+	size_t count;
+
+	size_t begin(size_t k) const {
+		return k * size;
+	}
+
+	size_t end(size_t k) const {
+		return k + 1 == count ? n : (k + 1) * size;
+	}
+};
+
+inline chunking split(const parallel_policy &policy, size_t n, size_t element_size, thread_pool* &pool) {
+	pool = policy.pool;
+	if (n < policy.threshold || n < 2) {
+		return chunking{n, n, n == 0 ? size_t(0) : size_t(1)};
+	}
+	if (pool == nullptr) {
+		pool = &default_thread_pool();
+	}
+	size_t threads = pool->concurrency();
+	if (threads == 1) {
+		return chunking{n, n, 1};
+	}
+	// A few chunks per thread even out uneven elements
+	size_t wanted = threads * 4;
+	size_t line = element_size < cache_line ? cache_line / element_size : 1;
+	size_t size = (n + wanted - 1) / wanted;
+	size = (size + line - 1) / line * line;
+	return chunking{n, size, (n + size - 1) / size};
+}
+
+template<typename F>
+void run(thread_pool* pool, const chunking &chunks, F f) {
+	if (pool == nullptr || chunks.count <= 1) {
+		for (size_t k = 0; k < chunks.count; ++k) {
+			f(chunks.begin(k), chunks.end(k));
+		}
+	} else {
+		pool->run(chunks.count, [&](size_t k) {
+			f(chunks.begin(k), chunks.end(k));
+		});
+	}
+}
+
+template<typename T>
+void destroy(T* first, T* last) {
+	if constexpr (!std::is_trivially_destructible<T>::value) {
+		for (; first != last; ++first) {
+			first->~T();
+		}
+	}
+}
+
+/**
+ * constructs dest[i] for i in [0, n) by make(dest + i, i), chunk by chunk
+ * A throwing chunk destroys what it built; once every chunk is done the
+ * chunks that succeeded are destroyed as well and the exception goes on,
+ * so either all n elements exist afterwards or none do.
+ */
+template<typename T, typename Make>
+void construct(const parallel_policy &policy, T* dest, size_t n, Make make) {
+	thread_pool* pool;
+	chunking chunks = split(policy, n, sizeof(T), pool);
+	std::unique_ptr<bool[]> built(new bool[chunks.count]());
+	try {
+		run(pool, chunks, [&](size_t begin, size_t end) {
+			size_t i = begin;
+			try {
+				for (; i < end; ++i) {
+					make(dest + i, i);
+				}
+			} catch (...) {
+				destroy(dest + begin, dest + i);
+				throw;
+			}
+			built[begin / chunks.size] = true;
+		});
+	} catch (...) {
+		for (size_t k = 0; k < chunks.count; ++k) {
+			if (built[k]) {
+				destroy(dest + chunks.begin(k), dest + chunks.end(k));
+			}
+		}
+		throw;
+	}
+}
+
+template<typename T>
+void copy(const parallel_policy &policy, const T* src, T* dest, size_t n) {
+	if constexpr (std::is_trivially_copyable<T>::value) {
+		thread_pool* pool;
+		chunking chunks = split(policy, n, sizeof(T), pool);
+		run(pool, chunks, [&](size_t begin, size_t end) {
+			std::memcpy(static_cast<void*>(dest + begin), static_cast<const void*>(src + begin), (end - begin) * sizeof(T));
+		});
+	} else {
+		construct(policy, dest, n, [src](T* p, size_t i) {
+			new (p) T(src[i]);
+		});
+	}
+}
+}
+
+/**
+ * returns a copy of src whose elements are copy-constructed in parallel
+ * Elements are built with placement new rather than through the
+ * allocator's construct(), as for trivially relocatable types elsewhere.
+ */
+template<typename T, typename Alloc, typename Growth>
+vector<T, Alloc, Growth> parallel_copy(const parallel_policy &policy, const vector<T, Alloc, Growth> &src) {
+	vector<T, Alloc, Growth> result(std::allocator_traits<Alloc>::select_on_container_copy_construction(src.get_allocator()));
+	result.reserve(src.size());
+	result.append_raw(src.size(), [&](T* dest, size_t n) {
+		parallel_detail::copy(policy, src.data(), dest, n);
+		return n;
+	});
+	return result;
+}
+
+/**
+ * destroys the elements of v in parallel, keeping its capacity
+ * Calling it before a large vector goes out of scope makes the
+ * destructor itself only free the buffer.
+ */
+template<typename T, typename Alloc, typename Growth>
+void parallel_clear(const parallel_policy &policy, vector<T, Alloc, Growth> &v) {
+	v.truncate_raw(0, [&policy](T* first, size_t n) {
+		if constexpr (!std::is_trivially_destructible<T>::value) {
+			thread_pool* pool;
+			parallel_detail::chunking chunks = parallel_detail::split(policy, n, sizeof(T), pool);
+			parallel_detail::run(pool, chunks, [first](size_t begin, size_t end) {
+				parallel_detail::destroy(first + begin, first + end);
+			});
+		}
+	});
+}
+
+/**
+ * replaces the contents of dst with a copy of src, both the
+ * destruction and the copy running in parallel
+ */
+template<typename T, typename Alloc, typename Growth>
+void parallel_assign(const parallel_policy &policy, vector<T, Alloc, Growth> &dst, const vector<T, Alloc, Growth> &src) {
+	if (&dst == &src) {
+		return;
+	}
+	parallel_clear(policy, dst);
+	dst.reserve(src.size());
+	dst.append_raw(src.size(), [&](T* dest, size_t n) {
+		parallel_detail::copy(policy, src.data(), dest, n);
+		return n;
+	});
+}
+
+/**
+ * appends count copies of value to v, constructed in parallel
+ */
+template<typename T, typename Alloc, typename Growth>
+void parallel_fill(const parallel_policy &policy, vector<T, Alloc, Growth> &v, size_t count, const T &value) {
+	// value may live in v and move when it grows
+	T tmp(value);
+	v.append_raw(count, [&](T* dest, size_t n) {
+		parallel_detail::construct(policy, dest, n, [&tmp](T* p, size_t) {
+			new (p) T(tmp);
+		});
+		return n;
+	});
+}
+
+/**
+ * calls f on every element of v, chunks running concurrently
+ * f must be safe to call on different elements at the same time.
+ */
+template<typename T, typename Alloc, typename Growth, typename F>
+void parallel_for_each(const parallel_policy &policy, vector<T, Alloc, Growth> &v, F f) {
+	thread_pool* pool;
+	parallel_detail::chunking chunks = parallel_detail::split(policy, v.size(), sizeof(T), pool);
+	T* data = v.data();
+	parallel_detail::run(pool, chunks, [&f, data](size_t begin, size_t end) {
+		for (size_t i = begin; i < end; ++i) {
+			f(data[i]);
+		}
+	});
+}
+
+template<typename T, typename Alloc, typename Growth, typename F>
+void parallel_for_each(const parallel_policy &policy, const vector<T, Alloc, Growth> &v, F f) {
+	thread_pool* pool;
+	parallel_detail::chunking chunks = parallel_detail::split(policy, v.size(), sizeof(T), pool);
+	const T* data = v.data();
+	parallel_detail::run(pool, chunks, [&f, data](size_t begin, size_t end) {
+		for (size_t i = begin; i < end; ++i) {
+			f(data[i]);
+		}
+	});
+}
+
+/**
+ * appends f(x) for every x in in to out, constructing the results in
+ * parallel; if any f throws, out is left as it was
+ */
+template<typename T, typename A1, typename G1, typename U, typename A2, typename G2, typename F>
+void parallel_transform(const parallel_policy &policy, const vector<T, A1, G1> &in, vector<U, A2, G2> &out, F f) {
+	out.reserve(out.size() + in.size());
+	const T* src = in.data();
+	out.append_raw(in.size(), [&](U* dest, size_t n) {
+		parallel_detail::construct(policy, dest, n, [&f, src](U* p, size_t i) {
+			new (p) U(f(src[i]));
+		});
+		return n;
+	});
+}
+
+}
+
+#endif
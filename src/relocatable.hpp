@@ -0,0 +1,19 @@
+#ifndef SJTU_RELOCATABLE_HPP
+#define SJTU_RELOCATABLE_HPP
+
+#include <type_traits>
+
+namespace sjtu
+{
+/**
+ * Whether T can be relocated by copying its bytes and then forgetting
+ * the source without running its destructor. True for trivially copyable
+ * types; specialize it for types such as Util::Bint or Diamond::Matrix
+ * whose members hold no pointers into the object itself.
+ */
+template<typename T>
+struct is_trivially_relocatable : std::is_trivially_copyable<T> {};
+
+}
+
+#endif
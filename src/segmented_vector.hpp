@@ -0,0 +1,454 @@
+#ifndef SJTU_SEGMENTED_VECTOR_HPP
+#define SJTU_SEGMENTED_VECTOR_HPP
+
+#include "exceptions.hpp"
+#include "iterator.hpp"
+
+#include <cstddef>
+#include <iterator>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace sjtu
+{
+/**
+ * default chunk length of segmented_vector: a power of two giving about
+ * 4KB per chunk, and at least 16 elements
+ */
+template<typename T>
+struct segmented_chunk_size {
+	static constexpr size_t value = [] {
+		size_t n = 16;
+		while (n * sizeof(T) < 4096) {
+			n <<= 1;
+		}
+		return n;
+	}();
+};
+
+/**
+ * a vector that grows by adding fixed-size chunks
+ * Elements are never relocated: push_back() at most allocates one new
+ * chunk, and the table that maps chunk numbers to chunks is doubled in
+ * the background, a few entries per new chunk, so no push_back() pays
+ * for copying what came before. Indexing stays O(1), at the price of
+ * one extra indirection against sjtu::vector.
+ * The interface and exceptions are those of sjtu::vector, except that
+ * the storage is not contiguous, so there is no data(). References stay
+ * valid until their element is erased.
+ */
+template<typename T, size_t ChunkSize = segmented_chunk_size<T>::value>
+class segmented_vector
+{
+	static_assert(ChunkSize > 0 && (ChunkSize & (ChunkSize - 1)) == 0, "chunk size must be a power of two");
+	static_assert(alignof(T) <= alignof(std::max_align_t), "segmented_vector does not support over-aligned types");
+
+public:
+	using value_type = T;
+	using size_type = size_t;
+	using difference_type = std::ptrdiff_t;
+	using reference = T&;
+	using const_reference = const T&;
+	using pointer = T*;
+	using const_pointer = const T*;
+
+private:
+	static constexpr size_t mask = ChunkSize - 1;
+	static constexpr size_t shift = [] {
+		size_t s = 0;
+		while ((size_t(1) << s) < ChunkSize) {
+			++s;
+		}
+		return s;
+	}();
+
+	// Entries copied into next_map_ per new chunk, enough to finish the
+	// copy long before the current map fills up
+	static constexpr size_t migrate_step = 3;
+	static constexpr size_t min_map = 8;
+
+	T** map_;
+	size_t map_capacity_;
+	size_t chunks_;
+	T** next_map_;
+	size_t migrated_;
+	size_t size_;
+
+	T* element(size_t index) {
+		return map_[index >> shift] + (index & mask);
+	}
+
+	const T* element(size_t index) const {
+		return map_[index >> shift] + (index & mask);
+	}
+
+	void start_migration() {
+		size_t capacity = map_capacity_ < min_map ? min_map : map_capacity_ * 2;
+		next_map_ = new T*[capacity];
+		migrated_ = 0;
+	}
+
+	// Copy up to steps map entries into next_map_, switching over once
+	// all of them are there
+	void advance_migration(size_t steps) {
+		if (next_map_ == nullptr) {
+			if (chunks_ * 2 < map_capacity_) {
+				return;
+			}
+			start_migration();
+		}
+		for (; steps > 0 && migrated_ < chunks_; --steps, ++migrated_) {
+			next_map_[migrated_] = map_[migrated_];
+		}
+		if (migrated_ == chunks_) {
+			delete[] map_;
+			map_ = next_map_;
+			map_capacity_ = map_capacity_ < min_map ? min_map : map_capacity_ * 2;
+			next_map_ = nullptr;
+		}
+	}
+
+	void add_chunk() {
+		if (chunks_ == map_capacity_) {
+			// Only reached by reserve() outrunning the background copy
+			advance_migration(chunks_ + 1);
+		}
+		T* chunk = static_cast<T*>(::operator new(ChunkSize * sizeof(T)));
+		map_[chunks_] = chunk;
+		if (next_map_ != nullptr) {
+			next_map_[chunks_] = chunk;
+		}
+		++chunks_;
+		advance_migration(migrate_step);
+	}
+
+	void free_chunks_from(size_t first) {
+		for (size_t k = first; k < chunks_; ++k) {
+			::operator delete(map_[k]);
+		}
+		chunks_ = first;
+		if (next_map_ != nullptr && migrated_ > chunks_) {
+			migrated_ = chunks_;
+		}
+	}
+
+	void release() {
+		clear();
+		free_chunks_from(0);
+		delete[] map_;
+		delete[] next_map_;
+		map_ = nullptr;
+		next_map_ = nullptr;
+		map_capacity_ = 0;
+		migrated_ = 0;
+	}
+
+	void steal(segmented_vector &other) {
+		map_ = other.map_;
+		map_capacity_ = other.map_capacity_;
+		chunks_ = other.chunks_;
+		next_map_ = other.next_map_;
+		migrated_ = other.migrated_;
+		size_ = other.size_;
+		other.map_ = nullptr;
+		other.map_capacity_ = 0;
+		other.chunks_ = 0;
+		other.next_map_ = nullptr;
+		other.migrated_ = 0;
+		other.size_ = 0;
+	}
+
+	template<typename... Args>
+	void emplace_at(size_t ind, Args&&... args) {
+		if (ind == size_) {
+			emplace_back(std::forward<Args>(args)...);
+			return;
+		}
+		// Build the element first, args may refer to an element that shifts
+		T tmp(std::forward<Args>(args)...);
+		emplace_back(std::move(*element(size_ - 1)));
+		for (size_t i = size_ - 2; i > ind; --i) {
+			*element(i) = std::move(*element(i - 1));
+		}
+		*element(ind) = std::move(tmp);
+	}
+
+public:
+	using iterator = indexed_iterator<segmented_vector, T>;
+	using const_iterator = indexed_iterator<segmented_vector, const T>;
+	using reverse_iterator = std::reverse_iterator<iterator>;
+	using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+	segmented_vector() : map_(nullptr), map_capacity_(0), chunks_(0), next_map_(nullptr), migrated_(0), size_(0) {}
+
+	segmented_vector(const segmented_vector &other) : segmented_vector() {
+		reserve(other.size_);
+		for (size_t i = 0; i < other.size_; ++i) {
+			push_back(*other.element(i));
+		}
+	}
+
+	segmented_vector(segmented_vector &&other) noexcept : segmented_vector() {
+		steal(other);
+	}
+
+	~segmented_vector() {
+		release();
+	}
+
+	// Elements are assigned over and chunks are kept where possible
+	segmented_vector &operator=(const segmented_vector &other) {
+		if (this == &other) {
+			return *this;
+		}
+		while (size_ > other.size_) {
+			pop_back();
+		}
+		for (size_t i = 0; i < size_; ++i) {
+			*element(i) = *other.element(i);
+		}
+		reserve(other.size_);
+		for (size_t i = size_; i < other.size_; ++i) {
+			push_back(*other.element(i));
+		}
+		return *this;
+	}
+
+	segmented_vector &operator=(segmented_vector &&other) noexcept {
+		if (this != &other) {
+			release();
+			steal(other);
+		}
+		return *this;
+	}
+
+	T & at(const size_t &pos) {
+		if (pos >= size_) {
+			throw index_out_of_bound();
+		}
+		return *element(pos);
+	}
+
+	const T & at(const size_t &pos) const {
+		if (pos >= size_) {
+			throw index_out_of_bound();
+		}
+		return *element(pos);
+	}
+
+	// Checked only under SJTU_VECTOR_CHECKED, as in vector
+	T & operator[](const size_t &pos) {
+#if SJTU_VECTOR_CHECKED
+		if (pos >= size_) {
+			throw index_out_of_bound();
+		}
+#endif
+		return *element(pos);
+	}
+
+	const T & operator[](const size_t &pos) const {
+#if SJTU_VECTOR_CHECKED
+		if (pos >= size_) {
+			throw index_out_of_bound();
+		}
+#endif
+		return *element(pos);
+	}
+
+	const T & front() const {
+#if SJTU_VECTOR_CHECKED
+		if (size_ == 0) {
+			throw container_is_empty();
+		}
+#endif
+		return *element(0);
+	}
+
+	const T & back() const {
+#if SJTU_VECTOR_CHECKED
+		if (size_ == 0) {
+			throw container_is_empty();
+		}
+#endif
+		return *element(size_ - 1);
+	}
+
+	iterator begin() {
+		return iterator(this, 0);
+	}
+
+	const_iterator begin() const {
+		return const_iterator(this, 0);
+	}
+
+	const_iterator cbegin() const {
+		return const_iterator(this, 0);
+	}
+
+	iterator end() {
+		return iterator(this, size_);
+	}
+
+	const_iterator end() const {
+		return const_iterator(this, size_);
+	}
+
+	const_iterator cend() const {
+		return const_iterator(this, size_);
+	}
+
+	reverse_iterator rbegin() {
+		return reverse_iterator(end());
+	}
+
+	const_reverse_iterator rbegin() const {
+		return const_reverse_iterator(end());
+	}
+
+	const_reverse_iterator crbegin() const {
+		return const_reverse_iterator(cend());
+	}
+
+	reverse_iterator rend() {
+		return reverse_iterator(begin());
+	}
+
+	const_reverse_iterator rend() const {
+		return const_reverse_iterator(begin());
+	}
+
+	const_reverse_iterator crend() const {
+		return const_reverse_iterator(cbegin());
+	}
+
+	bool empty() const {
+		return size_ == 0;
+	}
+
+	size_t size() const {
+		return size_;
+	}
+
+	size_t capacity() const {
+		return chunks_ * ChunkSize;
+	}
+
+	void reserve(const size_t &new_capacity) {
+		while (capacity() < new_capacity) {
+			add_chunk();
+		}
+	}
+
+	/**
+	 * frees the chunks past the one holding the last element
+	 */
+	void shrink_to_fit() {
+		free_chunks_from((size_ + ChunkSize - 1) >> shift);
+	}
+
+	void resize(const size_t &count) {
+		while (size_ < count) {
+			emplace_back();
+		}
+		while (size_ > count) {
+			pop_back();
+		}
+	}
+
+	void resize(const size_t &count, const T &value) {
+		// value cannot move: chunks stay where they are
+		while (size_ < count) {
+			push_back(value);
+		}
+		while (size_ > count) {
+			pop_back();
+		}
+	}
+
+	// Destroys every element, keeping the chunks
+	void clear() {
+		while (size_ > 0) {
+			pop_back();
+		}
+	}
+
+	iterator insert(const_iterator pos, const T &value) {
+		return insert(pos.index_, value);
+	}
+
+	iterator insert(const_iterator pos, T &&value) {
+		return insert(pos.index_, std::move(value));
+	}
+
+	iterator insert(const size_t &ind, const T &value) {
+		if (ind > size_) {
+			throw index_out_of_bound();
+		}
+		emplace_at(ind, value);
+		return iterator(this, ind);
+	}
+
+	iterator insert(const size_t &ind, T &&value) {
+		if (ind > size_) {
+			throw index_out_of_bound();
+		}
+		emplace_at(ind, std::move(value));
+		return iterator(this, ind);
+	}
+
+	template<typename... Args>
+	iterator emplace(const_iterator pos, Args&&... args) {
+		if (pos.index_ > size_) {
+			throw index_out_of_bound();
+		}
+		emplace_at(pos.index_, std::forward<Args>(args)...);
+		return iterator(this, pos.index_);
+	}
+
+	iterator erase(const_iterator pos) {
+		return erase(pos.index_);
+	}
+
+	iterator erase(const size_t &ind) {
+		if (ind >= size_) {
+			throw index_out_of_bound();
+		}
+		for (size_t i = ind; i + 1 < size_; ++i) {
+			*element(i) = std::move(*element(i + 1));
+		}
+		pop_back();
+		return iterator(this, ind);
+	}
+
+	void push_back(const T &value) {
+		emplace_back(value);
+	}
+
+	void push_back(T &&value) {
+		emplace_back(std::move(value));
+	}
+
+	template<typename... Args>
+	T & emplace_back(Args&&... args) {
+		if (size_ == capacity()) {
+			add_chunk();
+		}
+		T* p = element(size_);
+		new (p) T(std::forward<Args>(args)...);
+		++size_;
+		return *p;
+	}
+
+	void pop_back() {
+		if (size_ == 0) {
+			throw container_is_empty();
+		}
+		--size_;
+		element(size_)->~T();
+	}
+};
+
+}
+
+#endif
@@ -0,0 +1,373 @@
+#ifndef SJTU_SERIALIZE_HPP
+#define SJTU_SERIALIZE_HPP
+
+#include "exceptions.hpp"
+#include "vector.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <istream>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <type_traits>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+namespace sjtu
+{
+/**
+ * element codec for types that are not trivially copyable
+ * Specialize it with
+ *     static void write(std::ostream &os, const T &value);
+ *     static T read(std::istream &is);
+ * Trivially copyable types never use a codec: their buffer is written
+ * and read as raw bytes.
+ */
+template<typename T>
+struct codec;
+
+/**
+ * writes a trivially copyable value as raw bytes, for use in codecs
+ */
+template<typename U>
+void write_binary(std::ostream &os, const U &value) {
+	static_assert(std::is_trivially_copyable<U>::value, "write_binary needs a trivially copyable type");
+	os.write(reinterpret_cast<const char*>(&value), sizeof(U));
+}
+
+template<typename U>
+U read_binary(std::istream &is) {
+	static_assert(std::is_trivially_copyable<U>::value, "read_binary needs a trivially copyable type");
+	U value;
+	if (!is.read(reinterpret_cast<char*>(&value), sizeof(U))) {
+		throw runtime_error();
+	}
+	return value;
+}
+
+/**
+ * codec going through operator<< and operator>>, each element stored as
+ * a length-prefixed string; suits types such as Util::Bint that already
+ * print losslessly:
+ *     template<> struct sjtu::codec<Util::Bint> : sjtu::text_codec<Util::Bint> {};
+ */
+template<typename T>
+struct text_codec {
+	static void write(std::ostream &os, const T &value) {
+		std::ostringstream text;
+		text << value;
+		const std::string &s = text.str();
+		write_binary<uint64_t>(os, s.size());
+		os.write(s.data(), s.size());
+	}
+
+	static T read(std::istream &is) {
+		uint64_t n = read_binary<uint64_t>(is);
+		std::string s(n, '\0');
+		if (!is.read(&s[0], n)) {
+			throw runtime_error();
+		}
+		std::istringstream text(s);
+		T value;
+		if (!(text >> value)) {
+			throw runtime_error();
+		}
+		return value;
+	}
+};
+
+namespace serialize_detail
+{
+// Leads every saved vector. element_size is sizeof(T) for raw buffers
+// and 0 for codec-encoded ones, so the two cannot be confused.
+struct header {
+	char magic[8];
+	uint32_t version;
+	uint32_t element_size;
+	uint64_t count;
+};
+
+constexpr char magic[8] = {'S', 'J', 'T', 'U', 'V', 'E', 'C', 'B'};
+constexpr uint32_t version = 1;
+
+// load() reads streams it cannot measure this many elements at a time
+constexpr size_t load_batch = 1 << 16;
+
+template<typename T>
+constexpr uint32_t element_size() {
+	return std::is_trivially_copyable<T>::value ? sizeof(T) : 0;
+}
+
+template<typename T>
+header make_header(size_t count) {
+	header h;
+	std::memcpy(h.magic, magic, sizeof(magic));
+	h.version = version;
+	h.element_size = element_size<T>();
+	h.count = count;
+	return h;
+}
+
+template<typename T>
+void check_header(const header &h) {
+	if (std::memcmp(h.magic, magic, sizeof(magic)) != 0 || h.version != version
+		|| h.element_size != element_size<T>()) {
+		throw runtime_error();
+	}
+}
+
+// The bytes left in is, or -1 when it cannot seek to tell
+inline int64_t bytes_left(std::istream &is) {
+	std::streampos here = is.tellg();
+	if (here == std::streampos(-1)) {
+		is.clear();
+		return -1;
+	}
+	is.seekg(0, std::ios::end);
+	std::streampos end = is.tellg();
+	is.clear();
+	is.seekg(here);
+	if (end == std::streampos(-1) || !is) {
+		is.clear();
+		return -1;
+	}
+	return static_cast<int64_t>(end - here);
+}
+
+// Read exactly bytes from fd, false on a short file
+inline bool read_fully(int fd, char* p, size_t bytes) {
+	while (bytes > 0) {
+		ssize_t got = ::read(fd, p, bytes);
+		if (got <= 0) {
+			return false;
+		}
+		p += got;
+		bytes -= got;
+	}
+	return true;
+}
+}
+
+/**
+ * writes v to os
+ * A trivially copyable buffer goes out in one write() after the header;
+ * other element types are encoded one by one with codec<T>.
+ */
+template<typename T, typename Alloc, typename Growth>
+void save(std::ostream &os, const vector<T, Alloc, Growth> &v) {
+	serialize_detail::header h = serialize_detail::make_header<T>(v.size());
+	os.write(reinterpret_cast<const char*>(&h), sizeof(h));
+	if constexpr (std::is_trivially_copyable<T>::value) {
+		os.write(reinterpret_cast<const char*>(v.data()), v.size() * sizeof(T));
+	} else {
+		for (size_t i = 0; i < v.size(); ++i) {
+			codec<T>::write(os, v[i]);
+		}
+	}
+	if (!os) {
+		throw runtime_error();
+	}
+}
+
+/**
+ * reads a saved vector incrementally
+ * The header is read by the constructor; each read() then appends the
+ * next batch to a vector, so a large file can be processed without
+ * holding all of it at once.
+ */
+template<typename T>
+class vector_reader
+{
+private:
+	std::istream &is_;
+	size_t count_;
+	size_t done_;
+
+public:
+	explicit vector_reader(std::istream &is) : is_(is), count_(0), done_(0) {
+		serialize_detail::header h;
+		if (!is_.read(reinterpret_cast<char*>(&h), sizeof(h))) {
+			throw runtime_error();
+		}
+		serialize_detail::check_header<T>(h);
+		count_ = h.count;
+	}
+
+	// Returns the number of elements in the stream
+	size_t size() const {
+		return count_;
+	}
+
+	size_t remaining() const {
+		return count_ - done_;
+	}
+
+	bool done() const {
+		return done_ == count_;
+	}
+
+	/**
+	 * appends up to max_count further elements to out
+	 * returns how many were appended, 0 once the stream is exhausted
+	 */
+	template<typename Alloc, typename Growth>
+	size_t read(vector<T, Alloc, Growth> &out, size_t max_count) {
+		size_t n = remaining() < max_count ? remaining() : max_count;
+		if constexpr (std::is_trivially_copyable<T>::value) {
+			std::istream &is = is_;
+			out.append_raw(n, [&is, n](T* dest, size_t) {
+				if (!is.read(reinterpret_cast<char*>(dest), n * sizeof(T))) {
+					throw runtime_error();
+				}
+				return n;
+			});
+		} else {
+			// Growth decides the capacity, or batch after batch would
+			// reallocate the whole vector
+			for (size_t i = 0; i < n; ++i) {
+				out.push_back(codec<T>::read(is_));
+			}
+		}
+		done_ += n;
+		return n;
+	}
+};
+
+/**
+ * replaces the contents of v with a vector saved by save()
+ * Trivially copyable elements are read straight into the buffer. The
+ * count in the header is only trusted as far as the stream backs it:
+ * storage is reserved once when a seekable stream holds that many
+ * elements, a count it cannot hold throws before anything is
+ * allocated, and streams of unknown length are read in batches, so
+ * that a corrupt header cannot demand more memory than the data read.
+ * If the stream is short or malformed, runtime_error is thrown and v
+ * is left empty.
+ */
+template<typename T, typename Alloc, typename Growth>
+void load(std::istream &is, vector<T, Alloc, Growth> &v) {
+	vector_reader<T> reader(is);
+	v.clear();
+	if constexpr (std::is_trivially_copyable<T>::value) {
+		int64_t left = serialize_detail::bytes_left(is);
+		if (left >= 0) {
+			if (reader.size() > static_cast<uint64_t>(left) / sizeof(T)) {
+				throw runtime_error();
+			}
+			v.reserve(reader.size());
+		}
+	}
+	try {
+		while (!reader.done()) {
+			reader.read(v, serialize_detail::load_batch);
+		}
+	} catch (...) {
+		v.clear();
+		throw;
+	}
+}
+
+/**
+ * save() to the file at path
+ * For trivially copyable T the header and the buffer go out with
+ * writev, without any stream buffering.
+ */
+template<typename T, typename Alloc, typename Growth>
+void save_file(const std::string &path, const vector<T, Alloc, Growth> &v) {
+	if constexpr (std::is_trivially_copyable<T>::value) {
+		int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+		if (fd < 0) {
+			throw runtime_error();
+		}
+		serialize_detail::header h = serialize_detail::make_header<T>(v.size());
+		iovec parts[2];
+		parts[0].iov_base = &h;
+		parts[0].iov_len = sizeof(h);
+		parts[1].iov_base = const_cast<T*>(v.data());
+		parts[1].iov_len = v.size() * sizeof(T);
+		iovec* next = parts;
+		int left = 2;
+		while (left > 0) {
+			ssize_t put = ::writev(fd, next, left);
+			if (put < 0) {
+				::close(fd);
+				throw runtime_error();
+			}
+			// Skip what went out, a large buffer may take several calls
+			while (left > 0 && (size_t)put >= next->iov_len) {
+				put -= next->iov_len;
+				++next;
+				--left;
+			}
+			if (left > 0) {
+				next->iov_base = static_cast<char*>(next->iov_base) + put;
+				next->iov_len -= put;
+			}
+		}
+		if (::close(fd) != 0) {
+			throw runtime_error();
+		}
+	} else {
+		std::ofstream os(path, std::ios::binary | std::ios::trunc);
+		if (!os) {
+			throw runtime_error();
+		}
+		save(os, v);
+	}
+}
+
+/**
+ * load() from the file at path
+ */
+template<typename T, typename Alloc, typename Growth>
+void load_file(const std::string &path, vector<T, Alloc, Growth> &v) {
+	if constexpr (std::is_trivially_copyable<T>::value) {
+		int fd = ::open(path.c_str(), O_RDONLY);
+		if (fd < 0) {
+			throw runtime_error();
+		}
+		serialize_detail::header h;
+		if (!serialize_detail::read_fully(fd, reinterpret_cast<char*>(&h), sizeof(h))) {
+			::close(fd);
+			throw runtime_error();
+		}
+		try {
+			serialize_detail::check_header<T>(h);
+			// Refuse a count the file cannot back before allocating for it,
+			// dividing so that a forged count cannot wrap the product
+			struct stat st;
+			if (::fstat(fd, &st) != 0 || (uint64_t)st.st_size < sizeof(h)
+				|| h.count > ((uint64_t)st.st_size - sizeof(h)) / sizeof(T)) {
+				throw runtime_error();
+			}
+			v.clear();
+			size_t n = h.count;
+			v.append_raw(n, [fd, n](T* dest, size_t) {
+				if (!serialize_detail::read_fully(fd, reinterpret_cast<char*>(dest), n * sizeof(T))) {
+					throw runtime_error();
+				}
+				return n;
+			});
+		} catch (...) {
+			::close(fd);
+			throw;
+		}
+		::close(fd);
+	} else {
+		std::ifstream is(path, std::ios::binary);
+		if (!is) {
+			throw runtime_error();
+		}
+		load(is, v);
+	}
+}
+
+}
+
+#endif
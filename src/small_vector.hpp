@@ -0,0 +1,514 @@
+#ifndef SJTU_SMALL_VECTOR_HPP
+#define SJTU_SMALL_VECTOR_HPP
+
+#include "exceptions.hpp"
+#include "iterator.hpp"
+#include "vector.hpp"
+
+#include <cstddef>
+#include <cstring>
+#include <type_traits>
+#include <utility>
+
+namespace sjtu
+{
+/**
+ * a vector that keeps up to N elements inline
+ * the heap is only touched once the size grows past N, so short
+ * vectors cost no allocation at all. The interface and exceptions
+ * are those of sjtu::vector.
+ */
+template<typename T, size_t N>
+class small_vector
+{
+	static_assert(N > 0, "small_vector needs room for at least one inline element");
+
+public:
+	using value_type = T;
+	using size_type = size_t;
+	using difference_type = std::ptrdiff_t;
+	using reference = T&;
+	using const_reference = const T&;
+	using pointer = T*;
+	using const_pointer = const T*;
+
+private:
+	T* data_;
+	size_t size_;
+	size_t capacity_;
+	alignas(T) unsigned char inline_[N * sizeof(T)];
+
+	static constexpr bool trivial_relocate = is_trivially_relocatable<T>::value;
+
+	T* inline_data() {
+		return reinterpret_cast<T*>(inline_);
+	}
+
+	bool is_inline() const {
+		return data_ == reinterpret_cast<const T*>(inline_);
+	}
+
+	// Destroys [first, last) unless dismissed: the elements an operation
+	// has built so far, should a later step throw
+	struct construct_guard {
+		T* first;
+		T* last;
+
+		~construct_guard() {
+			for (; first != last; ++first) {
+				first->~T();
+			}
+		}
+
+		void dismiss() {
+			first = last;
+		}
+	};
+
+	// Frees a heap buffer that has not been handed to the vector yet
+	struct buffer_guard {
+		T* data;
+
+		~buffer_guard() {
+			::operator delete(data);
+		}
+
+		T* dismiss() {
+			T* p = data;
+			data = nullptr;
+			return p;
+		}
+	};
+
+	// Same contract as vector::relocate: a throwing copy destroys the
+	// copies made so far and leaves the source as it was
+	static void relocate(T* first, T* last, T* dest) {
+		if constexpr (trivial_relocate) {
+			if (first != last) {
+				std::memcpy(static_cast<void*>(dest), static_cast<const void*>(first), (last - first) * sizeof(T));
+			}
+		} else {
+			construct_guard built{dest, dest};
+			for (; first != last; ++first, ++built.last) {
+				new (built.last) T(std::move_if_noexcept(*first));
+			}
+			built.dismiss();
+		}
+	}
+
+	static void destroy_relocated(T* first, T* last) {
+		if constexpr (!trivial_relocate) {
+			for (; first != last; ++first) {
+				first->~T();
+			}
+		}
+	}
+
+	void free_heap() {
+		if (!is_inline()) {
+			::operator delete(data_);
+		}
+	}
+
+	// Move the elements into new_data (inline or freshly allocated) of
+	// new_capacity; if that throws, the vector is unchanged and new_data
+	// holds nothing
+	void reallocate(T* new_data, size_t new_capacity) {
+		relocate(data_, data_ + size_, new_data);
+		destroy_relocated(data_, data_ + size_);
+		free_heap();
+		data_ = new_data;
+		capacity_ = new_capacity;
+	}
+
+	void reallocate(size_t new_capacity) {
+		if (new_capacity <= N) {
+			if (!is_inline()) {
+				reallocate(inline_data(), N);
+			}
+			return;
+		}
+		buffer_guard buffer{reinterpret_cast<T*>(::operator new(new_capacity * sizeof(T)))};
+		reallocate(buffer.data, new_capacity);
+		buffer.dismiss();
+	}
+
+	// Grow with a new element constructed at ind; the vector is unchanged
+	// if this throws
+	template<typename... Args>
+	void grow_emplace(size_t ind, Args&&... args) {
+		size_t new_capacity = double_growth::next(capacity_, size_ + 1);
+		buffer_guard buffer{reinterpret_cast<T*>(::operator new(new_capacity * sizeof(T)))};
+		T* new_data = buffer.data;
+
+		// Construct new element first, args may refer into the old buffer
+		new (new_data + ind) T(std::forward<Args>(args)...);
+		construct_guard element{new_data + ind, new_data + ind + 1};
+
+		relocate(data_, data_ + ind, new_data);
+		construct_guard front{new_data, new_data + ind};
+		relocate(data_ + ind, data_ + size_, new_data + ind + 1);
+		front.dismiss();
+		element.dismiss();
+		destroy_relocated(data_, data_ + size_);
+		free_heap();
+
+		data_ = buffer.dismiss();
+		capacity_ = new_capacity;
+		++size_;
+	}
+
+	template<typename... Args>
+	void emplace_at(size_t ind, Args&&... args) {
+		if (size_ >= capacity_) {
+			grow_emplace(ind, std::forward<Args>(args)...);
+		} else if (ind == size_) {
+			new (data_ + size_) T(std::forward<Args>(args)...);
+			++size_;
+		} else if constexpr (trivial_relocate) {
+			alignas(T) unsigned char slot[sizeof(T)];
+			new (slot) T(std::forward<Args>(args)...);
+			std::memmove(static_cast<void*>(data_ + ind + 1), static_cast<const void*>(data_ + ind), (size_ - ind) * sizeof(T));
+			std::memcpy(static_cast<void*>(data_ + ind), static_cast<const void*>(slot), sizeof(T));
+			++size_;
+		} else {
+			// Build the element first, args may refer into the shifted tail
+			T tmp(std::forward<Args>(args)...);
+			new (data_ + size_) T(std::move(data_[size_ - 1]));
+			for (size_t i = size_ - 1; i > ind; --i) {
+				data_[i] = std::move(data_[i - 1]);
+			}
+			data_[ind] = std::move(tmp);
+			++size_;
+		}
+	}
+
+	void copy_from(const small_vector &other) {
+		reserve(other.size_);
+		for (; size_ < other.size_; ++size_) {
+			new (data_ + size_) T(other.data_[size_]);
+		}
+	}
+
+	// Take other's elements, stealing its heap buffer if it has one
+	void move_from(small_vector &other) {
+		if (other.is_inline()) {
+			relocate(other.data_, other.data_ + other.size_, data_);
+			destroy_relocated(other.data_, other.data_ + other.size_);
+			size_ = other.size_;
+		} else {
+			data_ = other.data_;
+			size_ = other.size_;
+			capacity_ = other.capacity_;
+			other.data_ = other.inline_data();
+			other.capacity_ = N;
+		}
+		other.size_ = 0;
+	}
+
+public:
+	using iterator = contiguous_iterator<small_vector, T>;
+	using const_iterator = contiguous_iterator<small_vector, const T>;
+	using reverse_iterator = std::reverse_iterator<iterator>;
+	using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+	// Constructors
+	small_vector() : data_(inline_data()), size_(0), capacity_(N) {}
+
+	small_vector(const small_vector &other) : data_(inline_data()), size_(0), capacity_(N) {
+		// No destructor runs for a constructor that throws
+		try {
+			copy_from(other);
+		} catch (...) {
+			clear();
+			free_heap();
+			throw;
+		}
+	}
+
+	small_vector(small_vector &&other) noexcept(std::is_nothrow_move_constructible<T>::value)
+		: data_(inline_data()), size_(0), capacity_(N) {
+		move_from(other);
+	}
+
+	// Destructor
+	~small_vector() {
+		clear();
+		free_heap();
+	}
+
+	// Assignment operator
+	small_vector &operator=(const small_vector &other) {
+		if (this == &other) {
+			return *this;
+		}
+		clear();
+		copy_from(other);
+		return *this;
+	}
+
+	small_vector &operator=(small_vector &&other) noexcept(std::is_nothrow_move_constructible<T>::value) {
+		if (this == &other) {
+			return *this;
+		}
+		clear();
+		if (!other.is_inline()) {
+			free_heap();
+			data_ = inline_data();
+			capacity_ = N;
+		}
+		move_from(other);
+		return *this;
+	}
+
+	T & at(const size_t &pos) {
+		if (pos >= size_) {
+			throw index_out_of_bound();
+		}
+		return data_[pos];
+	}
+
+	const T & at(const size_t &pos) const {
+		if (pos >= size_) {
+			throw index_out_of_bound();
+		}
+		return data_[pos];
+	}
+
+	// Checked only under SJTU_VECTOR_CHECKED, as in vector
+	T & operator[](const size_t &pos) {
+#if SJTU_VECTOR_CHECKED
+		if (pos >= size_) {
+			throw index_out_of_bound();
+		}
+#endif
+		return data_[pos];
+	}
+
+	const T & operator[](const size_t &pos) const {
+#if SJTU_VECTOR_CHECKED
+		if (pos >= size_) {
+			throw index_out_of_bound();
+		}
+#endif
+		return data_[pos];
+	}
+
+	const T & front() const {
+#if SJTU_VECTOR_CHECKED
+		if (size_ == 0) {
+			throw container_is_empty();
+		}
+#endif
+		return data_[0];
+	}
+
+	const T & back() const {
+#if SJTU_VECTOR_CHECKED
+		if (size_ == 0) {
+			throw container_is_empty();
+		}
+#endif
+		return data_[size_ - 1];
+	}
+
+	T * data() {
+		return data_;
+	}
+
+	const T * data() const {
+		return data_;
+	}
+
+	iterator begin() {
+		return iterator(data_, this);
+	}
+
+	const_iterator begin() const {
+		return const_iterator(data_, this);
+	}
+
+	const_iterator cbegin() const {
+		return const_iterator(data_, this);
+	}
+
+	iterator end() {
+		return iterator(data_ + size_, this);
+	}
+
+	const_iterator end() const {
+		return const_iterator(data_ + size_, this);
+	}
+
+	const_iterator cend() const {
+		return const_iterator(data_ + size_, this);
+	}
+
+	reverse_iterator rbegin() {
+		return reverse_iterator(end());
+	}
+
+	const_reverse_iterator rbegin() const {
+		return const_reverse_iterator(end());
+	}
+
+	const_reverse_iterator crbegin() const {
+		return const_reverse_iterator(cend());
+	}
+
+	reverse_iterator rend() {
+		return reverse_iterator(begin());
+	}
+
+	const_reverse_iterator rend() const {
+		return const_reverse_iterator(begin());
+	}
+
+	const_reverse_iterator crend() const {
+		return const_reverse_iterator(cbegin());
+	}
+
+	bool empty() const {
+		return size_ == 0;
+	}
+
+	size_t size() const {
+		return size_;
+	}
+
+	size_t capacity() const {
+		return capacity_;
+	}
+
+	/**
+	 * returns whether the elements currently live in the inline buffer
+	 */
+	bool is_small() const {
+		return is_inline();
+	}
+
+	void reserve(const size_t &new_capacity) {
+		if (new_capacity > capacity_) {
+			reallocate(new_capacity);
+		}
+	}
+
+	/**
+	 * releases unused heap capacity, moving back inline when size() <= N
+	 */
+	void shrink_to_fit() {
+		if (!is_inline() && capacity_ > size_) {
+			reallocate(size_);
+		}
+	}
+
+	void resize(const size_t &count) {
+		reserve(count);
+		while (size_ < count) {
+			new (data_ + size_) T();
+			++size_;
+		}
+		while (size_ > count) {
+			pop_back();
+		}
+	}
+
+	void clear() {
+		for (size_t i = 0; i < size_; ++i) {
+			data_[i].~T();
+		}
+		size_ = 0;
+	}
+
+	iterator insert(const_iterator pos, const T &value) {
+		size_t index = pos.ptr_ - data_;
+		return insert(index, value);
+	}
+
+	iterator insert(const_iterator pos, T &&value) {
+		size_t index = pos.ptr_ - data_;
+		return insert(index, std::move(value));
+	}
+
+	iterator insert(const size_t &ind, const T &value) {
+		if (ind > size_) {
+			throw index_out_of_bound();
+		}
+		emplace_at(ind, value);
+		return iterator(data_ + ind, this);
+	}
+
+	iterator insert(const size_t &ind, T &&value) {
+		if (ind > size_) {
+			throw index_out_of_bound();
+		}
+		emplace_at(ind, std::move(value));
+		return iterator(data_ + ind, this);
+	}
+
+	template<typename... Args>
+	iterator emplace(const_iterator pos, Args&&... args) {
+		size_t index = pos.ptr_ - data_;
+		if (index > size_) {
+			throw index_out_of_bound();
+		}
+		emplace_at(index, std::forward<Args>(args)...);
+		return iterator(data_ + index, this);
+	}
+
+	iterator erase(const_iterator pos) {
+		size_t index = pos.ptr_ - data_;
+		return erase(index);
+	}
+
+	iterator erase(const size_t &ind) {
+		if (ind >= size_) {
+			throw index_out_of_bound();
+		}
+
+		if constexpr (trivial_relocate) {
+			data_[ind].~T();
+			std::memmove(static_cast<void*>(data_ + ind), static_cast<const void*>(data_ + ind + 1), (size_ - ind - 1) * sizeof(T));
+		} else {
+			for (size_t i = ind; i < size_ - 1; ++i) {
+				data_[i] = std::move(data_[i + 1]);
+			}
+			data_[size_ - 1].~T();
+		}
+		--size_;
+
+		return iterator(data_ + ind, this);
+	}
+
+	void push_back(const T &value) {
+		emplace_back(value);
+	}
+
+	void push_back(T &&value) {
+		emplace_back(std::move(value));
+	}
+
+	template<typename... Args>
+	T & emplace_back(Args&&... args) {
+		if (size_ >= capacity_) {
+			grow_emplace(size_, std::forward<Args>(args)...);
+		} else {
+			new (data_ + size_) T(std::forward<Args>(args)...);
+			++size_;
+		}
+		return data_[size_ - 1];
+	}
+
+	void pop_back() {
+		if (size_ == 0) {
+			throw container_is_empty();
+		}
+
+		data_[size_ - 1].~T();
+		--size_;
+	}
+};
+
+}
+
+#endif
@@ -1,33 +1,92 @@
 #ifndef SJTU_UTILITY_HPP
 #define SJTU_UTILITY_HPP
 
+#include "relocatable.hpp"
+
+#include <cstddef>
+#include <tuple>
+#include <type_traits>
 #include <utility>
 
 namespace sjtu {
 
+/**
+ * a pair whose copy and move operations are the defaulted ones, so that
+ * it is trivially copyable whenever T1 and T2 are, and trivially
+ * relocatable whenever both of them are
+ * The converting constructors only take part in overload resolution
+ * when both members can be built from the arguments.
+ */
 template <class T1, class T2>
 class pair {
    public:
+    using first_type = T1;
+    using second_type = T2;
+
     T1 first;
     T2 second;
+
     constexpr pair() : first(), second() {
     }
     pair(const pair &other) = default;
     pair(pair &&other) = default;
-    pair(const T1 &x, const T2 &y) : first(x), second(y) {
+    pair &operator=(const pair &other) = default;
+    pair &operator=(pair &&other) = default;
+
+    constexpr pair(const T1 &x, const T2 &y) : first(x), second(y) {
     }
-    template <class U1, class U2>
-    pair(U1 &&x, U2 &&y) : first(std::forward(x)), second(std::forward(y)) {
+    template <class U1, class U2,
+              typename std::enable_if<std::is_constructible<T1, U1 &&>::value &&
+                                          std::is_constructible<T2, U2 &&>::value,
+                                      int>::type = 0>
+    constexpr pair(U1 &&x, U2 &&y) : first(std::forward<U1>(x)), second(std::forward<U2>(y)) {
     }
-    template <class U1, class U2>
-    pair(const pair<U1, U2> &other) : first(other.first), second(other.second) {
+    template <class U1, class U2,
+              typename std::enable_if<std::is_constructible<T1, const U1 &>::value &&
+                                          std::is_constructible<T2, const U2 &>::value,
+                                      int>::type = 0>
+    constexpr pair(const pair<U1, U2> &other) : first(other.first), second(other.second) {
+    }
+    template <class U1, class U2,
+              typename std::enable_if<std::is_constructible<T1, U1 &&>::value &&
+                                          std::is_constructible<T2, U2 &&>::value,
+                                      int>::type = 0>
+    constexpr pair(pair<U1, U2> &&other)
+        : first(std::forward<U1>(other.first)), second(std::forward<U2>(other.second)) {
+    }
+
+    /**
+     * builds first from the elements of a and second from those of b,
+     * for emplacing members that cannot be copied or moved:
+     *     v.emplace_back(std::piecewise_construct, std::forward_as_tuple(1),
+     *                    std::forward_as_tuple(n, 'x'));
+     */
+    template <class... Args1, class... Args2>
+    pair(std::piecewise_construct_t, std::tuple<Args1...> a, std::tuple<Args2...> b)
+        : pair(a, b, std::index_sequence_for<Args1...>(), std::index_sequence_for<Args2...>()) {
     }
-    template <class U1, class U2>
-    pair(pair<U1, U2> &&other)
-        : first(std::move(other.first)), second(std::move(other.second)) {
+
+   private:
+    template <class Tuple1, class Tuple2, size_t... I1, size_t... I2>
+    pair(Tuple1 &a, Tuple2 &b, std::index_sequence<I1...>, std::index_sequence<I2...>)
+        : first(std::get<I1>(std::move(a))...), second(std::get<I2>(std::move(b))...) {
     }
 };
 
+template <class T1, class T2>
+bool operator==(const pair<T1, T2> &a, const pair<T1, T2> &b) {
+    return a.first == b.first && a.second == b.second;
+}
+
+template <class T1, class T2>
+bool operator!=(const pair<T1, T2> &a, const pair<T1, T2> &b) {
+    return !(a == b);
+}
+
+template <class T1, class T2>
+struct is_trivially_relocatable<pair<T1, T2>>
+    : std::integral_constant<bool, is_trivially_relocatable<T1>::value && is_trivially_relocatable<T2>::value> {};
+
 }  // namespace sjtu
 
 #endif
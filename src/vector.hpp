@@ -2,246 +2,615 @@
 #define SJTU_VECTOR_HPP
 
 #include "exceptions.hpp"
+#include "iterator.hpp"
+#include "relocatable.hpp"
 
 #include <climits>
 #include <cstddef>
 #include <cstring>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+/**
+ * SJTU_VECTOR_STATS=1 makes every vector instantiation count its
+ * allocations, relocations and shifts in a vector_stats record (see
+ * vector_stats.hpp). With the default of 0 the hooks compile to nothing.
+ */
+#ifndef SJTU_VECTOR_STATS
+#define SJTU_VECTOR_STATS 0
+#endif
+
+#if SJTU_VECTOR_STATS
+#include "vector_stats.hpp"
+#endif
 
 namespace sjtu
 {
+/**
+ * growth policies of vector
+ * next(capacity, required) returns the capacity to grow to when at
+ * least required elements must fit but only capacity of them do.
+ */
+struct double_growth {
+	static size_t next(size_t capacity, size_t required) {
+		size_t grown = capacity == 0 ? 1 : capacity * 2;
+		return grown < required ? required : grown;
+	}
+};
+
+// Grows by half of the current capacity, trading more reallocations for less slack
+struct half_growth {
+	static size_t next(size_t capacity, size_t required) {
+		size_t grown = capacity + (capacity >> 1) + 1;
+		return grown < required ? required : grown;
+	}
+};
+
+// Grows by a fixed number of elements, bounding slack to Chunk - 1
+template<size_t Chunk>
+struct chunk_growth {
+	static_assert(Chunk > 0, "chunk_growth needs a positive chunk size");
+	static size_t next(size_t capacity, size_t required) {
+		size_t grown = capacity + Chunk;
+		return grown < required ? (required + Chunk - 1) / Chunk * Chunk : grown;
+	}
+};
+
 /**
  * a data container like std::vector
  * store data in a successive memory and support random access.
+ * Alloc provides the storage through std::allocator_traits and Growth
+ * decides how much the buffer grows when it runs full.
  */
-template<typename T>
+template<typename T, typename Alloc = std::allocator<T>, typename Growth = double_growth>
 class vector
 {
+public:
+	using value_type = T;
+	using allocator_type = Alloc;
+	using size_type = size_t;
+	using difference_type = std::ptrdiff_t;
+	using reference = T&;
+	using const_reference = const T&;
+	using pointer = T*;
+	using const_pointer = const T*;
+
 private:
+	using alloc_traits = std::allocator_traits<Alloc>;
+	
 	T* data_;
 	size_t size_;
 	size_t capacity_;
+	Alloc alloc_;
 	
-	void reallocate(size_t new_capacity) {
-		// Allocate raw memory
-		T* new_data = reinterpret_cast<T*>(::operator new(new_capacity * sizeof(T)));
-		
-		// Copy construct elements to new memory
-		for (size_t i = 0; i < size_; ++i) {
-			new (new_data + i) T(data_[i]);
+	static constexpr bool trivial_relocate = is_trivially_relocatable<T>::value;
+	static constexpr bool trivial_copy = std::is_trivially_copyable<T>::value;
+	// Whether elements can be shifted within the buffer without throwing
+	static constexpr bool nothrow_shift = trivial_relocate
+		|| (std::is_nothrow_move_constructible<T>::value && std::is_nothrow_move_assignable<T>::value);
+	
+	// Instrumentation hooks, empty unless SJTU_VECTOR_STATS
+	static void stat_allocate(size_t capacity) {
+#if SJTU_VECTOR_STATS
+		vector_stats &s = stats();
+		s.allocations.fetch_add(1, std::memory_order_relaxed);
+		s.note_capacity(capacity);
+#else
+		(void)capacity;
+#endif
+	}
+	
+	static void stat_reallocate(size_t n) {
+#if SJTU_VECTOR_STATS
+		if (n > 0) {
+			stats().reallocations.fetch_add(1, std::memory_order_relaxed);
 		}
-		
-		// Destroy old elements
-		for (size_t i = 0; i < size_; ++i) {
-			data_[i].~T();
+#else
+		(void)n;
+#endif
+	}
+	
+	static void stat_relocate(size_t n) {
+#if SJTU_VECTOR_STATS
+		vector_stats &s = stats();
+		if (trivial_relocate) {
+			s.bitwise.fetch_add(n, std::memory_order_relaxed);
+		} else if (std::is_nothrow_move_constructible<T>::value || !std::is_copy_constructible<T>::value) {
+			s.moved.fetch_add(n, std::memory_order_relaxed);
+		} else {
+			s.copied.fetch_add(n, std::memory_order_relaxed);
 		}
-		
-		// Free old memory
-		::operator delete(data_);
-		
-		data_ = new_data;
-		capacity_ = new_capacity;
+		s.bytes_relocated.fetch_add(n * sizeof(T), std::memory_order_relaxed);
+#else
+		(void)n;
+#endif
 	}
-
-public:
-	class const_iterator;
-	class iterator
-	{
-	public:
-		using difference_type = std::ptrdiff_t;
-		using value_type = T;
-		using pointer = T*;
-		using reference = T&;
-		using iterator_category = std::output_iterator_tag;
-
-	private:
-		T* ptr_;
-		const vector* vec_;
-		
-		friend class vector;
-
-	public:
-		iterator(T* ptr = nullptr, const vector* vec = nullptr) : ptr_(ptr), vec_(vec) {}
-		
-		iterator operator+(const int &n) const {
-			return iterator(ptr_ + n, vec_);
+	
+	static void stat_shift(size_t n) {
+#if SJTU_VECTOR_STATS
+		stats().shifted.fetch_add(n, std::memory_order_relaxed);
+#else
+		(void)n;
+#endif
+	}
+	
+	static void stat_release(size_t slack) {
+#if SJTU_VECTOR_STATS
+		vector_stats &s = stats();
+		s.released.fetch_add(1, std::memory_order_relaxed);
+		s.released_slack.fetch_add(slack, std::memory_order_relaxed);
+#else
+		(void)slack;
+#endif
+	}
+	
+	T* allocate(size_t n) {
+		if (n == 0) {
+			return nullptr;
 		}
-		
-		iterator operator-(const int &n) const {
-			return iterator(ptr_ - n, vec_);
+		stat_allocate(n);
+		return alloc_traits::allocate(alloc_, n);
+	}
+	
+	void deallocate(T* p, size_t n) {
+		if (p != nullptr) {
+			alloc_traits::deallocate(alloc_, p, n);
 		}
+	}
+	
+	template<typename... Args>
+	void construct(T* p, Args&&... args) {
+		alloc_traits::construct(alloc_, p, std::forward<Args>(args)...);
+	}
+	
+	void destroy(T* p) {
+		alloc_traits::destroy(alloc_, p);
+	}
+	
+	// Destroys [first, last) unless dismissed: the elements an operation
+	// has built so far, should a later step throw
+	struct construct_guard {
+		vector &owner;
+		T* first;
+		T* last;
 		
-		int operator-(const iterator &rhs) const {
-			if (vec_ != rhs.vec_) {
-				throw invalid_iterator();
+		~construct_guard() {
+			for (; first != last; ++first) {
+				owner.destroy(first);
 			}
-			return ptr_ - rhs.ptr_;
 		}
 		
-		iterator& operator+=(const int &n) {
-			ptr_ += n;
-			return *this;
+		void dismiss() {
+			first = last;
 		}
+	};
+	
+	// Frees a buffer that has not been handed to the vector yet
+	struct buffer_guard {
+		vector &owner;
+		T* data;
+		size_t capacity;
 		
-		iterator& operator-=(const int &n) {
-			ptr_ -= n;
-			return *this;
+		~buffer_guard() {
+			owner.deallocate(data, capacity);
 		}
 		
-		iterator operator++(int) {
-			iterator tmp = *this;
-			++ptr_;
-			return tmp;
+		T* dismiss() {
+			T* p = data;
+			data = nullptr;
+			return p;
 		}
-		
-		iterator& operator++() {
-			++ptr_;
-			return *this;
+	};
+	
+	// Destroy all elements and release the buffer
+	void release() {
+		if (data_ != nullptr) {
+			stat_release(capacity_ - size_);
 		}
-		
-		iterator operator--(int) {
-			iterator tmp = *this;
-			--ptr_;
-			return tmp;
+		for (size_t i = 0; i < size_; ++i) {
+			destroy(data_ + i);
 		}
-		
-		iterator& operator--() {
-			--ptr_;
-			return *this;
+		deallocate(data_, capacity_);
+		data_ = nullptr;
+		size_ = 0;
+		capacity_ = 0;
+	}
+	
+	// Copy-construct n elements from src into raw storage at dest,
+	// destroying the ones already built if a copy throws
+	void uninitialized_copy(const T* src, size_t n, T* dest) {
+		if constexpr (trivial_copy) {
+			if (n > 0) {
+				std::memcpy(static_cast<void*>(dest), static_cast<const void*>(src), n * sizeof(T));
+			}
+		} else {
+			construct_guard built{*this, dest, dest};
+			for (; built.last != dest + n; ++built.last, ++src) {
+				construct(built.last, *src);
+			}
+			built.dismiss();
 		}
-		
-		T& operator*() const {
-			return *ptr_;
+	}
+	
+	// Make *this a copy of [src, src + n), which must not lie in this vector.
+	// The buffer is kept when it is large enough: live elements are assigned
+	// over and only the difference is constructed or destroyed.
+	void copy_assign(const T* src, size_t n) {
+		if (n > capacity_) {
+			T* new_data = allocate(n);
+			buffer_guard buffer{*this, new_data, n};
+			uninitialized_copy(src, n, new_data);
+			release();
+			data_ = buffer.dismiss();
+			size_ = n;
+			capacity_ = n;
+			return;
 		}
 		
-		bool operator==(const iterator &rhs) const {
-			return ptr_ == rhs.ptr_;
+		if constexpr (trivial_copy) {
+			if (n > 0) {
+				std::memcpy(static_cast<void*>(data_), static_cast<const void*>(src), n * sizeof(T));
+			}
+		} else {
+			size_t common = n < size_ ? n : size_;
+			for (size_t i = 0; i < common; ++i) {
+				data_[i] = src[i];
+			}
+			if (n > size_) {
+				uninitialized_copy(src + size_, n - size_, data_ + size_);
+			} else {
+				for (size_t i = n; i < size_; ++i) {
+					destroy(data_ + i);
+				}
+			}
 		}
-		
-		bool operator==(const const_iterator &rhs) const {
-			return ptr_ == rhs.ptr_;
+		size_ = n;
+	}
+	
+	// Relocate [first, last) into raw storage at dest. Trivially relocatable
+	// types are copied as bytes and the source must not be destroyed; others
+	// are move-constructed when that cannot throw and copied otherwise, and
+	// the caller still destroys the source. A throwing copy destroys the
+	// copies made so far, leaving the source as it was.
+	void relocate(T* first, T* last, T* dest) {
+		stat_relocate(last - first);
+		if constexpr (trivial_relocate) {
+			if (first != last) {
+				std::memcpy(static_cast<void*>(dest), static_cast<const void*>(first), (last - first) * sizeof(T));
+			}
+		} else if constexpr (std::is_nothrow_move_constructible<T>::value) {
+			for (; first != last; ++first, ++dest) {
+				construct(dest, std::move(*first));
+			}
+		} else {
+			construct_guard built{*this, dest, dest};
+			for (; first != last; ++first, ++built.last) {
+				construct(built.last, std::move_if_noexcept(*first));
+			}
+			built.dismiss();
 		}
-		
-		bool operator!=(const iterator &rhs) const {
-			return ptr_ != rhs.ptr_;
+	}
+	
+	// Relocate every element into new_data, leaving n slots free at ind.
+	// If that throws, the old buffer is untouched and new_data holds
+	// nothing that the caller did not build itself.
+	void relocate_around(T* new_data, size_t ind, size_t n) {
+		relocate(data_, data_ + ind, new_data);
+		construct_guard front{*this, new_data, new_data + ind};
+		relocate(data_ + ind, data_ + size_, new_data + ind + n);
+		front.dismiss();
+	}
+	
+	// Destroy the source of a relocate
+	void destroy_relocated(T* first, T* last) {
+		if constexpr (!trivial_relocate) {
+			for (; first != last; ++first) {
+				destroy(first);
+			}
 		}
+	}
+	
+	// Move to a buffer of new_capacity; the vector is unchanged if this throws
+	void reallocate(size_t new_capacity) {
+		// Allocate raw memory
+		T* new_data = allocate(new_capacity);
+		buffer_guard buffer{*this, new_data, new_capacity};
+		stat_reallocate(size_);
 		
-		bool operator!=(const const_iterator &rhs) const {
-			return ptr_ != rhs.ptr_;
-		}
+		// Move (or copy) construct elements to new memory
+		relocate(data_, data_ + size_, new_data);
 		
-		friend class const_iterator;
-	};
-
-	class const_iterator
-	{
-	public:
-		using difference_type = std::ptrdiff_t;
-		using value_type = T;
-		using pointer = T*;
-		using reference = T&;
-		using iterator_category = std::output_iterator_tag;
-
-	private:
-		const T* ptr_;
-		const vector* vec_;
+		// Destroy old elements
+		destroy_relocated(data_, data_ + size_);
 		
-		friend class vector;
+		// Free old memory
+		deallocate(data_, capacity_);
+		
+		data_ = buffer.dismiss();
+		capacity_ = new_capacity;
+	}
 
-	public:
-		const_iterator(const T* ptr = nullptr, const vector* vec = nullptr) : ptr_(ptr), vec_(vec) {}
+	// Grow by the policy with a new element constructed at ind
+	template<typename... Args>
+	void grow_emplace(size_t ind, Args&&... args) {
+		size_t new_capacity = Growth::next(capacity_, size_ + 1);
 		
-		const_iterator(const iterator& other) : ptr_(other.ptr_), vec_(other.vec_) {}
+		// Allocate new memory
+		T* new_data = allocate(new_capacity);
+		buffer_guard buffer{*this, new_data, new_capacity};
+		stat_reallocate(size_);
 		
-		const_iterator operator+(const int &n) const {
-			return const_iterator(ptr_ + n, vec_);
-		}
+		// Construct new element first, args may refer into the old buffer
+		construct(new_data + ind, std::forward<Args>(args)...);
+		construct_guard element{*this, new_data + ind, new_data + ind + 1};
 		
-		const_iterator operator-(const int &n) const {
-			return const_iterator(ptr_ - n, vec_);
-		}
+		// Relocate elements before and after insertion point
+		relocate_around(new_data, ind, 1);
+		element.dismiss();
 		
-		int operator-(const const_iterator &rhs) const {
-			if (vec_ != rhs.vec_) {
-				throw invalid_iterator();
-			}
-			return ptr_ - rhs.ptr_;
-		}
+		// Destroy old elements
+		destroy_relocated(data_, data_ + size_);
 		
-		const_iterator& operator+=(const int &n) {
-			ptr_ += n;
-			return *this;
-		}
+		// Free old memory
+		deallocate(data_, capacity_);
 		
-		const_iterator& operator-=(const int &n) {
-			ptr_ -= n;
-			return *this;
-		}
+		data_ = buffer.dismiss();
+		capacity_ = new_capacity;
+		++size_;
+	}
+	
+	// Open a slot at ind < size_ with spare capacity and move value, which
+	// must not be an element, into it. Nothing here throws if nothrow_shift.
+	void shift_insert(size_t ind, T &&value) {
+		stat_shift(size_ - ind);
 		
-		const_iterator operator++(int) {
-			const_iterator tmp = *this;
-			++ptr_;
-			return tmp;
-		}
+		// Move-construct the last element into the new slot
+		construct(data_ + size_, std::move(data_[size_ - 1]));
+		++size_;
 		
-		const_iterator& operator++() {
-			++ptr_;
-			return *this;
+		// Shift elements
+		for (size_t i = size_ - 2; i > ind; --i) {
+			data_[i] = std::move(data_[i - 1]);
 		}
 		
-		const_iterator operator--(int) {
-			const_iterator tmp = *this;
-			--ptr_;
-			return tmp;
+		data_[ind] = std::move(value);
+	}
+	
+	// Append elements constructed from args until there are count > size_,
+	// all of them or none. When the buffer must grow they are built in the
+	// new one before anything moves, so args may refer to elements.
+	template<typename... Args>
+	void append_to(size_t count, const Args&... args) {
+		if (count <= capacity_) {
+			construct_guard built{*this, data_ + size_, data_ + size_};
+			for (; built.last != data_ + count; ++built.last) {
+				construct(built.last, args...);
+			}
+			built.dismiss();
+			size_ = count;
+			return;
 		}
 		
-		const_iterator& operator--() {
-			--ptr_;
-			return *this;
+		size_t new_capacity = Growth::next(capacity_, count);
+		T* new_data = allocate(new_capacity);
+		buffer_guard buffer{*this, new_data, new_capacity};
+		construct_guard built{*this, new_data + size_, new_data + size_};
+		for (; built.last != new_data + count; ++built.last) {
+			construct(built.last, args...);
 		}
 		
-		const T& operator*() const {
-			return *ptr_;
-		}
+		stat_reallocate(size_);
+		relocate(data_, data_ + size_, new_data);
+		built.dismiss();
+		destroy_relocated(data_, data_ + size_);
+		deallocate(data_, capacity_);
 		
-		bool operator==(const iterator &rhs) const {
-			return ptr_ == rhs.ptr_;
+		data_ = buffer.dismiss();
+		capacity_ = new_capacity;
+		size_ = count;
+	}
+	
+	template<typename... Args>
+	void emplace_at(size_t ind, Args&&... args) {
+		if (size_ >= capacity_) {
+			grow_emplace(ind, std::forward<Args>(args)...);
+		} else if (ind == size_) {
+			construct(data_ + size_, std::forward<Args>(args)...);
+			++size_;
+		} else if constexpr (trivial_relocate) {
+			stat_shift(size_ - ind);
+			
+			// Build the element aside first, args may live in the shifted tail
+			alignas(T) unsigned char slot[sizeof(T)];
+			construct(reinterpret_cast<T*>(slot), std::forward<Args>(args)...);
+			
+			// Shift elements with a single memmove
+			std::memmove(static_cast<void*>(data_ + ind + 1), static_cast<const void*>(data_ + ind), (size_ - ind) * sizeof(T));
+			std::memcpy(static_cast<void*>(data_ + ind), static_cast<const void*>(slot), sizeof(T));
+			
+			++size_;
+		} else {
+			// Build the element aside first: args may live in the shifted tail,
+			// and a throwing constructor then leaves the vector as it was
+			T tmp(std::forward<Args>(args)...);
+			shift_insert(ind, std::move(tmp));
 		}
-		
-		bool operator==(const const_iterator &rhs) const {
-			return ptr_ == rhs.ptr_;
+	}
+
+	// Yields the same value over and over, to feed insert_n from a count
+	struct repeat_source {
+		const T* value;
+		const T &operator*() const {
+			return *value;
 		}
-		
-		bool operator!=(const iterator &rhs) const {
-			return ptr_ != rhs.ptr_;
+		repeat_source &operator++() {
+			return *this;
 		}
-		
-		bool operator!=(const const_iterator &rhs) const {
-			return ptr_ != rhs.ptr_;
+	};
+	
+	// Insert n elements read from first (only * and ++ are used) at ind,
+	// reallocating at most once and moving the tail only once. The vector
+	// is left as it was if this throws, unless T is shifted by moves that
+	// may throw; then only the elements' destruction is guaranteed.
+	template<typename It>
+	void insert_n(size_t ind, It first, size_t n) {
+		if (n == 0) {
+			return;
 		}
 		
-		friend class iterator;
-	};
-
-	// Constructors
-	vector() : data_(nullptr), size_(0), capacity_(0) {}
+		if (size_ + n > capacity_) {
+			size_t new_capacity = Growth::next(capacity_, size_ + n);
+			T* new_data = allocate(new_capacity);
+			buffer_guard buffer{*this, new_data, new_capacity};
+			
+			// Construct new elements first, the source may refer into the old buffer
+			construct_guard built{*this, new_data + ind, new_data + ind};
+			for (; built.last != new_data + ind + n; ++built.last, ++first) {
+				construct(built.last, *first);
+			}
+			
+			stat_reallocate(size_);
+			relocate_around(new_data, ind, n);
+			built.dismiss();
+			destroy_relocated(data_, data_ + size_);
+			deallocate(data_, capacity_);
+			
+			data_ = buffer.dismiss();
+			capacity_ = new_capacity;
+			size_ += n;
+		} else if (ind == size_) {
+			construct_guard built{*this, data_ + size_, data_ + size_};
+			for (; built.last != data_ + size_ + n; ++built.last, ++first) {
+				construct(built.last, *first);
+			}
+			built.dismiss();
+			size_ += n;
+		} else if constexpr (trivial_relocate) {
+			stat_shift(size_ - ind);
+			
+			// Open the gap with a single memmove and fill it
+			std::memmove(static_cast<void*>(data_ + ind + n), static_cast<const void*>(data_ + ind), (size_ - ind) * sizeof(T));
+			size_t built = 0;
+			try {
+				for (; built < n; ++built, ++first) {
+					construct(data_ + ind + built, *first);
+				}
+			} catch (...) {
+				while (built > 0) {
+					destroy(data_ + ind + --built);
+				}
+				std::memmove(static_cast<void*>(data_ + ind), static_cast<const void*>(data_ + ind + n), (size_ - ind) * sizeof(T));
+				throw;
+			}
+			size_ += n;
+		} else if constexpr (nothrow_shift) {
+			// Build the new elements aside, so that only moves that cannot
+			// throw touch the vector
+			vector tmp(alloc_);
+			tmp.reserve(n);
+			tmp.insert_n(0, first, n);
+			shift_in(ind, std::make_move_iterator(tmp.data_), n);
+		} else {
+			shift_in(ind, first, n);
+		}
+	}
 	
-	vector(const vector &other) : data_(nullptr), size_(0), capacity_(0) {
-		if (other.size_ > 0) {
-			data_ = reinterpret_cast<T*>(::operator new(other.size_ * sizeof(T)));
-			capacity_ = other.size_;
-			for (size_t i = 0; i < other.size_; ++i) {
-				new (data_ + i) T(other.data_[i]);
+	// Open a gap of n <= capacity_ - size_ slots at ind < size_ and fill it
+	// from first, assigning where elements were and constructing past the
+	// old end
+	template<typename It>
+	void shift_in(size_t ind, It first, size_t n) {
+		stat_shift(size_ - ind);
+		size_t old_size = size_;
+		size_t after = size_ - ind;
+		if (after > n) {
+			// The last n elements move into raw storage, the rest shift by n
+			for (size_t i = old_size - n; i < old_size; ++i) {
+				construct(data_ + size_, std::move(data_[i]));
+				++size_;
+			}
+			for (size_t i = old_size - 1; i >= ind + n; --i) {
+				data_[i] = std::move(data_[i - n]);
+			}
+			for (size_t i = ind; i < ind + n; ++i, ++first) {
+				data_[i] = *first;
+			}
+		} else {
+			// Part of the new elements lands past the old end
+			It mid = first;
+			for (size_t i = 0; i < after; ++i) {
+				++mid;
+			}
+			for (size_t i = after; i < n; ++i, ++mid) {
+				construct(data_ + size_, *mid);
+				++size_;
+			}
+			for (size_t i = ind; i < old_size; ++i) {
+				construct(data_ + size_, std::move(data_[i]));
+				++size_;
+			}
+			for (size_t i = ind; i < old_size; ++i, ++first) {
+				data_[i] = *first;
 			}
-			size_ = other.size_;
 		}
 	}
 	
+	// Collect a single-pass range so its length is known before inserting
+	template<typename InputIt>
+	vector collect(InputIt first, InputIt last) {
+		vector tmp(alloc_);
+		for (; first != last; ++first) {
+			tmp.emplace_back(*first);
+		}
+		return tmp;
+	}
+
+public:
+#if SJTU_VECTOR_STATS
+	/**
+	 * returns the counters shared by all vectors of this exact type
+	 */
+	static vector_stats &stats() {
+		return stats_detail::record<vector>();
+	}
+#endif
+	
+	using iterator = contiguous_iterator<vector, T>;
+	using const_iterator = contiguous_iterator<vector, const T>;
+	using reverse_iterator = std::reverse_iterator<iterator>;
+	using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+	// Constructors
+	vector() : data_(nullptr), size_(0), capacity_(0), alloc_() {}
+	
+	explicit vector(const Alloc &alloc) : data_(nullptr), size_(0), capacity_(0), alloc_(alloc) {}
+	
+	/**
+	 * constructs the vector with the contents of [first, last)
+	 */
+	template<typename InputIt, typename = require_input_iterator<InputIt>>
+	vector(InputIt first, InputIt last, const Alloc &alloc = Alloc())
+		: data_(nullptr), size_(0), capacity_(0), alloc_(alloc) {
+		insert(cend(), first, last);
+	}
+	
+	vector(const vector &other)
+		: data_(nullptr), size_(0), capacity_(0),
+		  alloc_(alloc_traits::select_on_container_copy_construction(other.alloc_)) {
+		copy_assign(other.data_, other.size_);
+	}
+	
+	vector(vector &&other) noexcept
+		: data_(other.data_), size_(other.size_), capacity_(other.capacity_), alloc_(std::move(other.alloc_)) {
+		other.data_ = nullptr;
+		other.size_ = 0;
+		other.capacity_ = 0;
+	}
+	
 	// Destructor
 	~vector() {
-		for (size_t i = 0; i < size_; ++i) {
-			data_[i].~T();
-		}
-		::operator delete(data_);
+		release();
 	}
 	
 	// Assignment operator
@@ -250,29 +619,136 @@ public:
 			return *this;
 		}
 		
-		// Destroy current elements
-		for (size_t i = 0; i < size_; ++i) {
-			data_[i].~T();
+		if constexpr (alloc_traits::propagate_on_container_copy_assignment::value) {
+			// Storage from the old allocator cannot be reused with the new one
+			if (alloc_ != other.alloc_) {
+				release();
+			}
+			alloc_ = other.alloc_;
 		}
-		::operator delete(data_);
 		
-		// Copy from other
-		data_ = nullptr;
-		size_ = 0;
-		capacity_ = 0;
+		copy_assign(other.data_, other.size_);
+		
+		return *this;
+	}
+	
+	vector &operator=(vector &&other) noexcept(
+		alloc_traits::propagate_on_container_move_assignment::value || alloc_traits::is_always_equal::value) {
+		if (this == &other) {
+			return *this;
+		}
+		
+		// Destroy current elements
+		release();
 		
-		if (other.size_ > 0) {
-			data_ = reinterpret_cast<T*>(::operator new(other.size_ * sizeof(T)));
-			capacity_ = other.size_;
-			for (size_t i = 0; i < other.size_; ++i) {
-				new (data_ + i) T(other.data_[i]);
+		if constexpr (!alloc_traits::propagate_on_container_move_assignment::value) {
+			if (!(alloc_ == other.alloc_)) {
+				// Storage cannot change hands, move elements one by one
+				data_ = allocate(other.size_);
+				capacity_ = other.size_;
+				for (; size_ < other.size_; ++size_) {
+					construct(data_ + size_, std::move(other.data_[size_]));
+				}
+				other.release();
+				return *this;
 			}
-			size_ = other.size_;
+		} else {
+			alloc_ = std::move(other.alloc_);
 		}
 		
+		// Take over other's buffer
+		data_ = other.data_;
+		size_ = other.size_;
+		capacity_ = other.capacity_;
+		other.data_ = nullptr;
+		other.size_ = 0;
+		other.capacity_ = 0;
+		
 		return *this;
 	}
 	
+	/**
+	 * replaces the contents with a copy of other's
+	 * Unlike operator= the allocator is never propagated, so the current
+	 * buffer is kept whenever it can hold other.size() elements; this
+	 * suits double-buffering, where two vectors are refilled every step.
+	 */
+	void assign(const vector &other) {
+		if (this != &other) {
+			copy_assign(other.data_, other.size_);
+		}
+	}
+	
+	/**
+	 * replaces the contents with count copies of value, reusing the buffer
+	 * when it is large enough
+	 */
+	void assign(const size_t &count, const T &value) {
+		if (&value >= data_ && &value < data_ + size_) {
+			// value would be overwritten or destroyed below
+			T tmp(value);
+			assign(count, tmp);
+			return;
+		}
+		if (count > capacity_) {
+			vector tmp(alloc_);
+			tmp.data_ = tmp.allocate(count);
+			tmp.capacity_ = count;
+			tmp.insert_n(0, repeat_source{&value}, count);
+			*this = std::move(tmp);
+			return;
+		}
+		size_t common = count < size_ ? count : size_;
+		for (size_t i = 0; i < common; ++i) {
+			data_[i] = value;
+		}
+		while (size_ > count) {
+			pop_back();
+		}
+		if (count > size_) {
+			append_to(count, value);
+		}
+	}
+	
+	/**
+	 * replaces the contents with [first, last)
+	 * existing elements are assigned over when the range fits
+	 */
+	template<typename InputIt, typename = require_input_iterator<InputIt>>
+	void assign(InputIt first, InputIt last) {
+		if constexpr (is_forward_iterator<InputIt>::value) {
+			size_t n = std::distance(first, last);
+			if (n > capacity_) {
+				vector tmp(alloc_);
+				tmp.data_ = tmp.allocate(n);
+				tmp.capacity_ = n;
+				tmp.insert_n(0, first, n);
+				*this = std::move(tmp);
+				return;
+			}
+			size_t i = 0;
+			for (; i < size_ && i < n; ++i, ++first) {
+				data_[i] = *first;
+			}
+			while (size_ > n) {
+				pop_back();
+			}
+			for (; i < n; ++i, ++first) {
+				construct(data_ + size_, *first);
+				++size_;
+			}
+		} else {
+			clear();
+			for (; first != last; ++first) {
+				emplace_back(*first);
+			}
+		}
+	}
+	
+	allocator_type get_allocator() const {
+		return alloc_;
+	}
+	
 	T & at(const size_t &pos) {
 		if (pos >= size_) {
 			throw index_out_of_bound();
@@ -287,34 +763,60 @@ public:
 		return data_[pos];
 	}
 	
+	/**
+	 * unchecked unless SJTU_VECTOR_CHECKED, use at() for a checked access
+	 */
 	T & operator[](const size_t &pos) {
+#if SJTU_VECTOR_CHECKED
 		if (pos >= size_) {
 			throw index_out_of_bound();
 		}
+#endif
 		return data_[pos];
 	}
 	
 	const T & operator[](const size_t &pos) const {
+#if SJTU_VECTOR_CHECKED
 		if (pos >= size_) {
 			throw index_out_of_bound();
 		}
+#endif
 		return data_[pos];
 	}
 	
+	/**
+	 * throws container_is_empty on an empty vector if SJTU_VECTOR_CHECKED
+	 */
 	const T & front() const {
+#if SJTU_VECTOR_CHECKED
 		if (size_ == 0) {
 			throw container_is_empty();
 		}
+#endif
 		return data_[0];
 	}
 	
 	const T & back() const {
+#if SJTU_VECTOR_CHECKED
 		if (size_ == 0) {
 			throw container_is_empty();
 		}
+#endif
 		return data_[size_ - 1];
 	}
 	
+	/**
+	 * returns the underlying contiguous storage
+	 * valid until the next reallocation, nullptr when nothing was allocated
+	 */
+	T * data() {
+		return data_;
+	}
+	
+	const T * data() const {
+		return data_;
+	}
+	
 	iterator begin() {
 		return iterator(data_, this);
 	}
@@ -339,6 +841,30 @@ public:
 		return const_iterator(data_ + size_, this);
 	}
 	
+	reverse_iterator rbegin() {
+		return reverse_iterator(end());
+	}
+	
+	const_reverse_iterator rbegin() const {
+		return const_reverse_iterator(end());
+	}
+	
+	const_reverse_iterator crbegin() const {
+		return const_reverse_iterator(cend());
+	}
+	
+	reverse_iterator rend() {
+		return reverse_iterator(begin());
+	}
+	
+	const_reverse_iterator rend() const {
+		return const_reverse_iterator(begin());
+	}
+	
+	const_reverse_iterator crend() const {
+		return const_reverse_iterator(cbegin());
+	}
+	
 	bool empty() const {
 		return size_ == 0;
 	}
@@ -347,72 +873,172 @@ public:
 		return size_;
 	}
 	
+	/**
+	 * returns the number of elements that fit without reallocation
+	 */
+	size_t capacity() const {
+		return capacity_;
+	}
+	
+	/**
+	 * grows the storage to hold at least new_capacity elements
+	 * does nothing if the capacity is already large enough
+	 */
+	void reserve(const size_t &new_capacity) {
+		if (new_capacity > capacity_) {
+			reallocate(new_capacity);
+		}
+	}
+	
+	/**
+	 * releases unused capacity so that capacity() == size()
+	 */
+	void shrink_to_fit() {
+		if (capacity_ > size_) {
+			reallocate(size_);
+		}
+	}
+	
+	/**
+	 * resizes to count elements
+	 * new elements are value-initialized, or copies of value; if one of
+	 * them throws, the vector is left as it was
+	 */
+	void resize(const size_t &count) {
+		if (count > size_) {
+			append_to(count);
+		}
+		while (size_ > count) {
+			pop_back();
+		}
+	}
+	
+	void resize(const size_t &count, const T &value) {
+		if (count > size_) {
+			append_to(count, value);
+		}
+		while (size_ > count) {
+			pop_back();
+		}
+	}
+	
+	/**
+	 * appends elements built straight into raw storage
+	 * fill(T* dest, size_t n) constructs up to n elements at dest, in
+	 * place, and returns how many it built; those are then appended.
+	 * If fill throws it must first destroy whatever it constructed.
+	 * Trivially copyable elements may simply be written as bytes.
+	 * returns the number of elements appended
+	 */
+	template<typename F>
+	size_t append_raw(const size_t &n, F fill) {
+		if (size_ + n > capacity_) {
+			reallocate(Growth::next(capacity_, size_ + n));
+		}
+		size_t written = fill(data_ + size_, n);
+		size_ += written;
+		return written;
+	}
+	
+	/**
+	 * shrinks to count elements, leaving their destruction to the caller
+	 * drop(T* first, size_t n) must destroy the n elements at first.
+	 */
+	template<typename F>
+	void truncate_raw(const size_t &count, F drop) {
+		if (count < size_) {
+			drop(data_ + count, size_ - count);
+			size_ = count;
+		}
+	}
+	
 	void clear() {
 		for (size_t i = 0; i < size_; ++i) {
-			data_[i].~T();
+			destroy(data_ + i);
 		}
 		size_ = 0;
 	}
 	
-	iterator insert(iterator pos, const T &value) {
+	iterator insert(const_iterator pos, const T &value) {
 		size_t index = pos.ptr_ - data_;
 		return insert(index, value);
 	}
 	
+	iterator insert(const_iterator pos, T &&value) {
+		size_t index = pos.ptr_ - data_;
+		return insert(index, std::move(value));
+	}
+	
 	iterator insert(const size_t &ind, const T &value) {
 		if (ind > size_) {
 			throw index_out_of_bound();
 		}
-		
-		if (size_ >= capacity_) {
-			size_t new_capacity = capacity_ == 0 ? 1 : capacity_ * 2;
-			
-			// Allocate new memory
-			T* new_data = reinterpret_cast<T*>(::operator new(new_capacity * sizeof(T)));
-			
-			// Copy elements before insertion point
-			for (size_t i = 0; i < ind; ++i) {
-				new (new_data + i) T(data_[i]);
-			}
-			
-			// Insert new element
-			new (new_data + ind) T(value);
-			
-			// Copy elements after insertion point
-			for (size_t i = ind; i < size_; ++i) {
-				new (new_data + i + 1) T(data_[i]);
-			}
-			
-			// Destroy old elements
-			for (size_t i = 0; i < size_; ++i) {
-				data_[i].~T();
-			}
-			
-			// Free old memory
-			::operator delete(data_);
-			
-			data_ = new_data;
-			capacity_ = new_capacity;
-			++size_;
-		} else {
-			// Construct new element at the end
-			new (data_ + size_) T(value);
-			
-			// Shift elements
-			for (size_t i = size_; i > ind; --i) {
-				data_[i] = data_[i - 1];
-			}
-			
-			// Assign value at position
-			data_[ind] = value;
-			
-			++size_;
+		emplace_at(ind, value);
+		return iterator(data_ + ind, this);
+	}
+	
+	iterator insert(const size_t &ind, T &&value) {
+		if (ind > size_) {
+			throw index_out_of_bound();
 		}
-		
+		emplace_at(ind, std::move(value));
 		return iterator(data_ + ind, this);
 	}
 	
-	iterator erase(iterator pos) {
+	/**
+	 * inserts count copies of value before pos
+	 * returns an iterator pointing to the first inserted element
+	 */
+	iterator insert(const_iterator pos, const size_t &count, const T &value) {
+		size_t index = pos.ptr_ - data_;
+		if (index > size_) {
+			throw index_out_of_bound();
+		}
+		if (&value >= data_ && &value < data_ + size_ && count <= capacity_ - size_) {
+			// value would move while the tail shifts
+			T tmp(value);
+			insert_n(index, repeat_source{&tmp}, count);
+		} else {
+			insert_n(index, repeat_source{&value}, count);
+		}
+		return iterator(data_ + index, this);
+	}
+	
+	/**
+	 * inserts [first, last) before pos with at most one reallocation
+	 * the range must not point into this vector
+	 * returns an iterator pointing to the first inserted element
+	 */
+	template<typename InputIt, typename = require_input_iterator<InputIt>>
+	iterator insert(const_iterator pos, InputIt first, InputIt last) {
+		size_t index = pos.ptr_ - data_;
+		if (index > size_) {
+			throw index_out_of_bound();
+		}
+		if constexpr (is_forward_iterator<InputIt>::value) {
+			insert_n(index, first, std::distance(first, last));
+		} else {
+			vector tmp = collect(first, last);
+			insert_n(index, std::make_move_iterator(tmp.data_), tmp.size_);
+		}
+		return iterator(data_ + index, this);
+	}
+	
+	/**
+	 * constructs an element from args in place before pos
+	 * returns an iterator pointing to the new element
+	 */
+	template<typename... Args>
+	iterator emplace(const_iterator pos, Args&&... args) {
+		size_t index = pos.ptr_ - data_;
+		if (index > size_) {
+			throw index_out_of_bound();
+		}
+		emplace_at(index, std::forward<Args>(args)...);
+		return iterator(data_ + index, this);
+	}
+	
+	iterator erase(const_iterator pos) {
 		size_t index = pos.ptr_ - data_;
 		return erase(index);
 	}
@@ -421,27 +1047,81 @@ public:
 		if (ind >= size_) {
 			throw index_out_of_bound();
 		}
+		stat_shift(size_ - ind - 1);
 		
-		// Shift elements
-		for (size_t i = ind; i < size_ - 1; ++i) {
-			data_[i] = data_[i + 1];
+		if constexpr (trivial_relocate) {
+			// Destroy the element and close the gap with a single memmove
+			destroy(data_ + ind);
+			std::memmove(static_cast<void*>(data_ + ind), static_cast<const void*>(data_ + ind + 1), (size_ - ind - 1) * sizeof(T));
+		} else {
+			// Shift elements
+			for (size_t i = ind; i < size_ - 1; ++i) {
+				data_[i] = std::move(data_[i + 1]);
+			}
+			
+			// Destroy last element
+			destroy(data_ + size_ - 1);
 		}
-		
-		// Destroy last element
-		data_[size_ - 1].~T();
 		--size_;
 		
 		return iterator(data_ + ind, this);
 	}
 	
+	/**
+	 * removes [first, last), moving the tail only once
+	 * returns an iterator following the last removed element
+	 */
+	iterator erase(const_iterator first, const_iterator last) {
+		size_t from = first.ptr_ - data_;
+		size_t to = last.ptr_ - data_;
+		if (from > to || to > size_) {
+			throw index_out_of_bound();
+		}
+		size_t n = to - from;
+		if (n == 0) {
+			return iterator(data_ + from, this);
+		}
+		stat_shift(size_ - to);
+		
+		if constexpr (trivial_relocate) {
+			for (size_t i = from; i < to; ++i) {
+				destroy(data_ + i);
+			}
+			std::memmove(static_cast<void*>(data_ + from), static_cast<const void*>(data_ + to), (size_ - to) * sizeof(T));
+		} else {
+			for (size_t i = to; i < size_; ++i) {
+				data_[i - n] = std::move(data_[i]);
+			}
+			for (size_t i = size_ - n; i < size_; ++i) {
+				destroy(data_ + i);
+			}
+		}
+		size_ -= n;
+		
+		return iterator(data_ + from, this);
+	}
+	
 	void push_back(const T &value) {
+		emplace_back(value);
+	}
+	
+	void push_back(T &&value) {
+		emplace_back(std::move(value));
+	}
+	
+	/**
+	 * constructs an element from args in place at the end
+	 * returns a reference to the new element
+	 */
+	template<typename... Args>
+	T & emplace_back(Args&&... args) {
 		if (size_ >= capacity_) {
-			size_t new_capacity = capacity_ == 0 ? 1 : capacity_ * 2;
-			reallocate(new_capacity);
+			grow_emplace(size_, std::forward<Args>(args)...);
+		} else {
+			construct(data_ + size_, std::forward<Args>(args)...);
+			++size_;
 		}
-		
-		new (data_ + size_) T(value);
-		++size_;
+		return data_[size_ - 1];
 	}
 	
 	void pop_back() {
@@ -449,7 +1129,7 @@ public:
 			throw container_is_empty();
 		}
 		
-		data_[size_ - 1].~T();
+		destroy(data_ + size_ - 1);
 		--size_;
 	}
 };
@@ -0,0 +1,144 @@
+#ifndef SJTU_VECTOR_STATS_HPP
+#define SJTU_VECTOR_STATS_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <iomanip>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <typeinfo>
+
+#if defined(__GNUG__)
+#include <cxxabi.h>
+#endif
+
+namespace sjtu
+{
+/**
+ * growth counters of one vector instantiation
+ * Only filled in when SJTU_VECTOR_STATS is 1; see vector::stats().
+ * Counters are relaxed atomics, so vectors of the same type may be
+ * used from several threads.
+ */
+struct vector_stats {
+	std::string name;
+	std::atomic<size_t> allocations{0};      // buffers obtained from the allocator
+	std::atomic<size_t> reallocations{0};    // times live elements moved to a new buffer
+	std::atomic<size_t> copied{0};           // elements relocated by copy construction
+	std::atomic<size_t> moved{0};            // elements relocated by move construction
+	std::atomic<size_t> bitwise{0};          // elements relocated with memcpy
+	std::atomic<size_t> bytes_relocated{0};  // sizeof(T) * all relocated elements
+	std::atomic<size_t> shifted{0};          // elements moved inside the buffer by insert/erase
+	std::atomic<size_t> peak_capacity{0};    // largest capacity any instance reached
+	std::atomic<size_t> released{0};         // buffers released by destruction or assignment
+	std::atomic<size_t> released_slack{0};   // unused slots in those buffers when released
+	vector_stats* next = nullptr;
+
+	explicit vector_stats(std::string n) : name(std::move(n)) {}
+
+	void reset() {
+		allocations = 0;
+		reallocations = 0;
+		copied = 0;
+		moved = 0;
+		bitwise = 0;
+		bytes_relocated = 0;
+		shifted = 0;
+		peak_capacity = 0;
+		released = 0;
+		released_slack = 0;
+	}
+
+	void note_capacity(size_t capacity) {
+		size_t peak = peak_capacity.load(std::memory_order_relaxed);
+		while (capacity > peak && !peak_capacity.compare_exchange_weak(peak, capacity, std::memory_order_relaxed)) {
+		}
+	}
+};
+
+namespace stats_detail
+{
+inline vector_stats*& head() {
+	static vector_stats* head = nullptr;
+	return head;
+}
+
+inline std::mutex &lock() {
+	static std::mutex m;
+	return m;
+}
+
+inline std::string demangle(const char* name) {
+#if defined(__GNUG__)
+	int status = 0;
+	char* readable = abi::__cxa_demangle(name, nullptr, nullptr, &status);
+	if (status == 0 && readable != nullptr) {
+		std::string result(readable);
+		std::free(readable);
+		return result;
+	}
+#endif
+	return name;
+}
+
+// One record per Owner, linked into the registry the first time it is used
+template<typename Owner>
+vector_stats &record() {
+	struct registered {
+		vector_stats stats;
+		registered() : stats(demangle(typeid(Owner).name())) {
+			std::lock_guard<std::mutex> guard(lock());
+			stats.next = head();
+			head() = &stats;
+		}
+	};
+	static registered r;
+	return r.stats;
+}
+}
+
+/**
+ * calls f on every vector_stats recorded so far
+ */
+template<typename F>
+void for_each_vector_stats(F f) {
+	std::lock_guard<std::mutex> guard(stats_detail::lock());
+	for (vector_stats* s = stats_detail::head(); s != nullptr; s = s->next) {
+		f(*s);
+	}
+}
+
+/**
+ * writes one line per vector type that has been used, most relevant
+ * columns first: reallocations and relocated bytes point at vectors that
+ * would profit from reserve() or another growth policy, released slack
+ * at ones that over-allocate
+ */
+inline void dump_vector_stats(std::ostream &os) {
+	for_each_vector_stats([&os](const vector_stats &s) {
+		size_t released = s.released;
+		os << s.name << "\n"
+		   << "  allocations " << s.allocations
+		   << "  reallocations " << s.reallocations
+		   << "  peak capacity " << s.peak_capacity << "\n"
+		   << "  relocated: copied " << s.copied
+		   << "  moved " << s.moved
+		   << "  bitwise " << s.bitwise
+		   << "  bytes " << s.bytes_relocated << "\n"
+		   << "  shifted " << s.shifted
+		   << "  avg released slack "
+		   << (released == 0 ? 0.0 : static_cast<double>(s.released_slack) / released) << "\n";
+	});
+}
+
+inline void reset_vector_stats() {
+	for_each_vector_stats([](vector_stats &s) {
+		s.reset();
+	});
+}
+
+}
+
+#endif